@@ -0,0 +1,674 @@
+/***********************************************************************
+* @file      AggregationPolicies.h
+*
+* Aggregation policies which compute the displayed temperature from the
+* latest fresh reading of each sensor node, incrementally, as readings
+* are ingested rather than by sweeping every sensor upon each display.
+*
+* @brief    A policy satisfies the IncrementalAggregation concept:
+*
+*           @code
+*           explicit Policy(const size_t& numberOfSensors);
+*           void Add(const size_t& sensorNodeNumber, const double& temperature);
+*           void Remove(const size_t& sensorNodeNumber, const double& temperature);
+*           Aggregate_t Result() const;
+*           @endcode
+*
+*           IncrementalAggregator<Policy> keeps the latest reading of each
+*           sensor and calls the policy, by static dispatch, as a sensor's
+*           reading is superseded (Remove, then Add) or becomes stale
+*           (Remove). The ingest pipeline feeds it once per reading;
+*           the display merely asks for its Result(). A policy may also
+*           provide a cheaper
+*
+*           @code
+*           void Replace(const size_t& sensorNodeNumber, const double& previous,
+*                        const double& temperature);
+*           @endcode
+*
+*           for the superseding of a reading.
+*
+*           For a fixed SENSOR_COUNT (embedded deployments), a policy may
+*           instead sweep the latest readings upon display, unrolled at
+*           compile time, by providing
+*
+*           @code
+*           template <std::size_t SENSOR_COUNT>
+*           static Aggregate_t Aggregate(const std::array<LatestReading_t, SENSOR_COUNT>& readings,
+*                                        const SteadyClock_t::time_point& timeNow);
+*           @endcode
+*
+*           whereupon IncrementalAggregator<Policy, SENSOR_COUNT> merely
+*           stores each reading. For a handful of sensors, that beats the
+*           bookkeeping of the incremental path.
+*
+*           Provided are:
+*
+*           MeanAggregation_t                 - the customer's plain average;
+*                                               swept when SENSOR_COUNT is
+*                                               fixed.
+*           WeightedMeanAggregation_t<W>      - weighted by sensor location;
+*                                               by default per zone, per
+*                                               SENSOR_ZONE_WEIGHTS.
+*           TrimmedMeanAggregation_t<PERCENT> - the average once the PERCENT
+*                                               lowest and highest readings
+*                                               are discarded.
+*           EnvelopeAggregation_t             - the minimum and maximum.
+*
+* @note     Policies allocate, if at all, upon construction only; neither
+*           a reading nor a display allocates. Each reading costs O(1);
+*           the trimmed mean, and the envelope once an extreme has gone,
+*           visit every sensor upon Result() instead. See the "aggregation"
+*           section of PerformanceBenchmarks.cpp for their cost against
+*           the built-in mean.
+*
+* @warning  Not thread-safe; one thread at a time per aggregator.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <concepts>
+#include <algorithm>
+#include <type_traits>
+#include "CommonDefinitions.h"
+#include "SensorSnapshot.h"
+
+// Sensor count of a runtime-sized aggregator, cf. std::dynamic_extent.
+static constexpr std::size_t DYNAMIC_SENSOR_COUNT = 0;
+
+struct Aggregate_t
+{
+    double   m_Value{0.0};
+    size_t   m_Count{0}; // Readings aggregated; 0 if none were fresh.
+
+    // Envelope policies only.
+    bool     m_IsEnvelope{false};
+    double   m_Minimum{0.0};
+    double   m_Maximum{0.0};
+};
+
+template <typename Policy>
+concept IncrementalAggregation = std::constructible_from<Policy, const size_t&>
+    && requires(Policy& policy, const Policy& constPolicy, const size_t& sensorNodeNumber,
+                const double& temperature)
+{
+    { policy.Add(sensorNodeNumber, temperature) } -> std::same_as<void>;
+    { policy.Remove(sensorNodeNumber, temperature) } -> std::same_as<void>;
+    { constPolicy.Result() } -> std::same_as<Aggregate_t>;
+};
+
+// The latest reading of a sensor, as swept by fixed-size policies.
+struct LatestReading_t
+{
+    double                     m_Temperature{0.0};
+    SteadyClock_t::time_point  m_ReadingTime{};
+    bool                       m_HasReading{false};
+};
+
+template <typename Policy, std::size_t SENSOR_COUNT>
+concept SweepingAggregation = (SENSOR_COUNT != DYNAMIC_SENSOR_COUNT)
+    && requires(const std::array<LatestReading_t, SENSOR_COUNT>& readings,
+                const SteadyClock_t::time_point& timeNow)
+{
+    { Policy::template Aggregate<SENSOR_COUNT>(readings, timeNow) } -> std::same_as<Aggregate_t>;
+};
+
+template <typename Policy>
+concept ReplacingAggregation = IncrementalAggregation<Policy>
+    && requires(Policy& policy, const size_t& sensorNodeNumber, const double& temperature)
+{
+    { policy.Replace(sensorNodeNumber, temperature, temperature) } -> std::same_as<void>;
+};
+
+namespace Utility
+{
+    // Neumaier-compensated running sum, so that months of adding and
+    // removing readings do not drift from a freshly computed sum.
+    class CompensatedSum
+    {
+    public:
+        void Add(const double& value)
+        {
+            auto sum = m_Sum + value;
+            m_Compensation += (std::fabs(m_Sum) >= std::fabs(value))
+                            ? ((m_Sum - sum) + value)
+                            : ((value - sum) + m_Sum);
+            m_Sum = sum;
+        }
+
+        void Reset()
+        {
+            m_Sum = 0.0;
+            m_Compensation = 0.0;
+        }
+
+        double Value() const
+        {
+            return m_Sum + m_Compensation;
+        }
+
+    private:
+        double   m_Sum{0.0};
+        double   m_Compensation{0.0};
+    };
+}
+
+struct MeanAggregation_t
+{
+    explicit MeanAggregation_t(const size_t& numberOfSensors)
+    {
+    }
+
+    void Add(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        m_Sum.Add(temperature);
+        ++m_Count;
+    }
+
+    void Remove(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        if (--m_Count == 0)
+        {
+            m_Sum.Reset(); // Whatever rounding remains goes with it.
+            return;
+        }
+        m_Sum.Add(-temperature);
+    }
+
+    void Replace(const size_t& sensorNodeNumber, const double& previous, const double& temperature)
+    {
+        m_Sum.Add(temperature - previous);
+    }
+
+    Aggregate_t Result() const
+    {
+        // Customer Requirement:
+        //
+        // "2. The displayed temperature shall be the average temperature
+        // computed from the latest readings from each node."
+        Aggregate_t aggregate;
+        aggregate.m_Count = m_Count;
+        if (m_Count > 0)
+        {
+            aggregate.m_Value = m_Sum.Value() / static_cast<double>(m_Count);
+        }
+        return aggregate;
+    }
+
+    template <std::size_t SENSOR_COUNT>
+    static Aggregate_t Aggregate(const std::array<LatestReading_t, SENSOR_COUNT>& readings,
+                                 const SteadyClock_t::time_point& timeNow)
+    {
+        Aggregate_t aggregate;
+
+        // Customer Requirement:
+        //
+        // "3. In case of intermittent communications, temperature readings older
+        // than 10 minutes shall be considered stale and excluded from the
+        // displayed temperature."
+        auto accumulate = [&aggregate, &timeNow](const LatestReading_t& reading)
+        {
+            if (reading.m_HasReading && Utility::IsFresh(reading.m_ReadingTime, timeNow))
+            {
+                aggregate.m_Value += reading.m_Temperature;
+                ++aggregate.m_Count;
+            }
+        };
+
+        // Fully unrolled; no loop, no bounds.
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (accumulate(readings[I]), ...);
+        }(std::make_index_sequence<SENSOR_COUNT>{});
+
+        // Customer Requirement:
+        //
+        // "2. The displayed temperature shall be the average temperature
+        // computed from the latest readings from each node."
+        if (aggregate.m_Count > 0)
+        {
+            aggregate.m_Value /= static_cast<double>(aggregate.m_Count);
+        }
+        return aggregate;
+    }
+
+private:
+    Utility::CompensatedSum   m_Sum;
+    size_t                    m_Count{0};
+};
+
+// Weights sensors by their zone; see Utility::ZoneOf().
+struct ZoneWeighting_t
+{
+    static constexpr double WeightOf(const size_t& sensorNodeNumber)
+    {
+        return SENSOR_ZONE_WEIGHTS[sensorNodeNumber % NUMBER_OF_SENSOR_ZONES];
+    }
+};
+
+template <typename Weighting = ZoneWeighting_t>
+struct WeightedMeanAggregation_t
+{
+    explicit WeightedMeanAggregation_t(const size_t& numberOfSensors)
+    {
+    }
+
+    void Add(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        const auto weight = Weighting::WeightOf(sensorNodeNumber);
+        m_WeightedSum.Add(weight * temperature);
+        m_SumOfWeights.Add(weight);
+        ++m_Count;
+    }
+
+    void Remove(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        if (--m_Count == 0)
+        {
+            m_WeightedSum.Reset();
+            m_SumOfWeights.Reset();
+            return;
+        }
+
+        const auto weight = Weighting::WeightOf(sensorNodeNumber);
+        m_WeightedSum.Add(-weight * temperature);
+        m_SumOfWeights.Add(-weight);
+    }
+
+    void Replace(const size_t& sensorNodeNumber, const double& previous, const double& temperature)
+    {
+        m_WeightedSum.Add(Weighting::WeightOf(sensorNodeNumber) * (temperature - previous));
+    }
+
+    Aggregate_t Result() const
+    {
+        Aggregate_t aggregate;
+        const auto sumOfWeights = m_SumOfWeights.Value();
+        if ((m_Count > 0) && (sumOfWeights > 0.0))
+        {
+            aggregate.m_Count = m_Count;
+            aggregate.m_Value = m_WeightedSum.Value() / sumOfWeights;
+        }
+        return aggregate;
+    }
+
+private:
+    Utility::CompensatedSum   m_WeightedSum;
+    Utility::CompensatedSum   m_SumOfWeights;
+    size_t                    m_Count{0};
+};
+
+template <unsigned PERCENT>
+struct TrimmedMeanAggregation_t
+{
+    static_assert(PERCENT < 50, "Trimming half from either end would leave nothing.");
+
+    explicit TrimmedMeanAggregation_t(const size_t& numberOfSensors)
+        : m_Readings(numberOfSensors, std::numeric_limits<double>::quiet_NaN())
+        , m_Count(0)
+    {
+        m_Scratch.reserve(numberOfSensors);
+    }
+
+    void Add(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = temperature;
+        ++m_Count;
+    }
+
+    void Remove(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = std::numeric_limits<double>::quiet_NaN();
+        --m_Count;
+    }
+
+    void Replace(const size_t& sensorNodeNumber, const double& previous, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = temperature;
+    }
+
+    // Order statistics are only needed here, upon display, hence only
+    // computed here; in linear time, without sorting.
+    Aggregate_t Result() const
+    {
+        Aggregate_t aggregate;
+        if (m_Count == 0)
+        {
+            return aggregate;
+        }
+
+        m_Scratch.clear();
+        for (const auto& temperature : m_Readings)
+        {
+            if (!std::isnan(temperature))
+            {
+                m_Scratch.push_back(temperature);
+            }
+        }
+
+        const auto count = m_Scratch.size();
+        const auto trimmed = std::min(count * PERCENT / 100, (count - 1) / 2);
+        auto middle = m_Scratch.begin() + static_cast<std::ptrdiff_t>(trimmed);
+        auto upper = m_Scratch.end() - static_cast<std::ptrdiff_t>(trimmed);
+        if (trimmed > 0)
+        {
+            std::nth_element(m_Scratch.begin(), middle, m_Scratch.end());
+            std::nth_element(middle, upper, m_Scratch.end());
+        }
+
+        Utility::CompensatedSum sum;
+        for (auto it = middle; it != upper; ++it)
+        {
+            sum.Add(*it);
+        }
+
+        aggregate.m_Count = count - 2 * trimmed;
+        aggregate.m_Value = sum.Value() / static_cast<double>(aggregate.m_Count);
+        return aggregate;
+    }
+
+private:
+    std::vector<double>           m_Readings; // By sensor; NaN if none.
+    size_t                        m_Count;
+    mutable std::vector<double>   m_Scratch;  // Reserved up front.
+};
+
+// The extremes are kept up to date as readings arrive, and only searched
+// for anew once a reading that was one of them is superseded or expires.
+struct EnvelopeAggregation_t
+{
+    explicit EnvelopeAggregation_t(const size_t& numberOfSensors)
+        : m_Readings(numberOfSensors, std::numeric_limits<double>::quiet_NaN())
+        , m_Count(0)
+        , m_Minimum(std::numeric_limits<double>::infinity())
+        , m_Maximum(-std::numeric_limits<double>::infinity())
+        , m_IsStale(false)
+    {
+    }
+
+    void Add(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = temperature;
+        ++m_Count;
+        Widen(temperature);
+    }
+
+    void Remove(const size_t& sensorNodeNumber, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = std::numeric_limits<double>::quiet_NaN();
+        --m_Count;
+        Forget(temperature);
+    }
+
+    void Replace(const size_t& sensorNodeNumber, const double& previous, const double& temperature)
+    {
+        m_Readings[sensorNodeNumber] = temperature;
+        Forget(previous);
+        Widen(temperature);
+    }
+
+    Aggregate_t Result() const
+    {
+        if (m_IsStale)
+        {
+            m_Minimum = std::numeric_limits<double>::infinity();
+            m_Maximum = -std::numeric_limits<double>::infinity();
+            for (const auto& temperature : m_Readings)
+            {
+                if (!std::isnan(temperature))
+                {
+                    m_Minimum = std::min(m_Minimum, temperature);
+                    m_Maximum = std::max(m_Maximum, temperature);
+                }
+            }
+            m_IsStale = false;
+        }
+
+        Aggregate_t aggregate;
+        aggregate.m_IsEnvelope = true;
+        aggregate.m_Count = m_Count;
+        if (m_Count > 0)
+        {
+            aggregate.m_Minimum = m_Minimum;
+            aggregate.m_Maximum = m_Maximum;
+            aggregate.m_Value = (m_Minimum + m_Maximum) / 2.0;
+        }
+        return aggregate;
+    }
+
+private:
+    void Widen(const double& temperature)
+    {
+        if (!m_IsStale)
+        {
+            m_Minimum = std::min(m_Minimum, temperature);
+            m_Maximum = std::max(m_Maximum, temperature);
+        }
+    }
+
+    void Forget(const double& temperature)
+    {
+        if ((temperature <= m_Minimum) || (temperature >= m_Maximum))
+        {
+            m_IsStale = true;
+        }
+    }
+
+    std::vector<double>   m_Readings; // By sensor; NaN if none.
+    size_t                m_Count;
+
+    // Cached by Result().
+    mutable double        m_Minimum;
+    mutable double        m_Maximum;
+    mutable bool          m_IsStale;
+};
+
+// Latest fresh reading of each sensor, fed to the policy as they change.
+// A fixed SENSOR_COUNT keeps them in a std::array.
+template <IncrementalAggregation Policy, std::size_t SENSOR_COUNT = DYNAMIC_SENSOR_COUNT>
+class IncrementalAggregator
+{
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    // Fresh entries are linked from the least recently updated to the most,
+    // so that expiry only ever visits the readings that are going stale.
+    // Readings from different dispatcher threads may be applied slightly
+    // out of order; such a reading merely expires that much later.
+    struct Entry_t
+    {
+        double                     m_Temperature{0.0};
+        SteadyClock_t::time_point  m_ReadingTime{};
+        uint32_t                   m_Older{NONE};
+        uint32_t                   m_Newer{NONE};
+        bool                       m_IsFresh{false};
+    };
+
+    using Entries_t = std::conditional_t<SENSOR_COUNT != DYNAMIC_SENSOR_COUNT,
+                                         std::array<Entry_t, SENSOR_COUNT>,
+                                         std::vector<Entry_t>>;
+
+public:
+    explicit IncrementalAggregator(const size_t& numberOfSensors)
+        : m_Policy(numberOfSensors)
+        , m_Entries(MakeEntries(numberOfSensors))
+        , m_Oldest(NONE)
+        , m_Newest(NONE)
+    {
+    }
+
+    // Readings older than the sensor's current one are ignored.
+    void Update(const size_t& sensorNodeNumber, const double& temperature,
+                const SteadyClock_t::time_point& readingTime)
+    {
+        if (sensorNodeNumber >= m_Entries.size())
+        {
+            return;
+        }
+
+        auto& entry = m_Entries[sensorNodeNumber];
+        if (!entry.m_IsFresh)
+        {
+            m_Policy.Add(sensorNodeNumber, temperature);
+        }
+        else if (readingTime < entry.m_ReadingTime)
+        {
+            return;
+        }
+        else
+        {
+            if constexpr (ReplacingAggregation<Policy>)
+            {
+                m_Policy.Replace(sensorNodeNumber, entry.m_Temperature, temperature);
+            }
+            else
+            {
+                m_Policy.Remove(sensorNodeNumber, entry.m_Temperature);
+                m_Policy.Add(sensorNodeNumber, temperature);
+            }
+            Unlink(static_cast<uint32_t>(sensorNodeNumber));
+        }
+
+        entry.m_Temperature = temperature;
+        entry.m_ReadingTime = readingTime;
+        entry.m_IsFresh = true;
+        LinkAsNewest(static_cast<uint32_t>(sensorNodeNumber));
+    }
+
+    // Customer Requirement:
+    //
+    // "3. In case of intermittent communications, temperature readings older
+    // than 10 minutes shall be considered stale and excluded from the
+    // displayed temperature."
+    void Expire(const SteadyClock_t::time_point& timeNow)
+    {
+        while ((m_Oldest != NONE)
+            && !Utility::IsFresh(m_Entries[m_Oldest].m_ReadingTime, timeNow))
+        {
+            auto sensorNodeNumber = m_Oldest;
+            auto& entry = m_Entries[sensorNodeNumber];
+            m_Policy.Remove(sensorNodeNumber, entry.m_Temperature);
+            Unlink(sensorNodeNumber);
+            entry.m_IsFresh = false;
+        }
+    }
+
+    Aggregate_t Result() const
+    {
+        return m_Policy.Result();
+    }
+
+    // That of the least recently updated fresh reading; the epoch if none.
+    SteadyClock_t::time_point OldestReadingTime() const
+    {
+        return (m_Oldest != NONE) ? m_Entries[m_Oldest].m_ReadingTime : SteadyClock_t::time_point{};
+    }
+
+private:
+    static Entries_t MakeEntries(const size_t& numberOfSensors)
+    {
+        if constexpr (SENSOR_COUNT != DYNAMIC_SENSOR_COUNT)
+        {
+            return Entries_t{};
+        }
+        else
+        {
+            return Entries_t(numberOfSensors);
+        }
+    }
+
+    void Unlink(const uint32_t& sensorNodeNumber)
+    {
+        auto& entry = m_Entries[sensorNodeNumber];
+        (entry.m_Older != NONE ? m_Entries[entry.m_Older].m_Newer : m_Oldest) = entry.m_Newer;
+        (entry.m_Newer != NONE ? m_Entries[entry.m_Newer].m_Older : m_Newest) = entry.m_Older;
+        entry.m_Older = NONE;
+        entry.m_Newer = NONE;
+    }
+
+    void LinkAsNewest(const uint32_t& sensorNodeNumber)
+    {
+        auto& entry = m_Entries[sensorNodeNumber];
+        entry.m_Older = m_Newest;
+        entry.m_Newer = NONE;
+        (m_Newest != NONE ? m_Entries[m_Newest].m_Newer : m_Oldest) = sensorNodeNumber;
+        m_Newest = sensorNodeNumber;
+    }
+
+    Policy      m_Policy;
+    Entries_t   m_Entries;
+    uint32_t    m_Oldest;
+    uint32_t    m_Newest;
+};
+
+// A fixed SENSOR_COUNT with a sweeping policy: each reading is merely
+// stored, and staleness and the aggregate are left to the policy's
+// unrolled sweep upon display.
+template <IncrementalAggregation Policy, std::size_t SENSOR_COUNT>
+    requires SweepingAggregation<Policy, SENSOR_COUNT>
+class IncrementalAggregator<Policy, SENSOR_COUNT>
+{
+public:
+    explicit IncrementalAggregator(const size_t& numberOfSensors)
+        : m_Readings()
+        , m_TimeNow()
+    {
+    }
+
+    // Readings older than the sensor's current one are ignored.
+    void Update(const size_t& sensorNodeNumber, const double& temperature,
+                const SteadyClock_t::time_point& readingTime)
+    {
+        if (sensorNodeNumber >= SENSOR_COUNT)
+        {
+            return;
+        }
+
+        auto& reading = m_Readings[sensorNodeNumber];
+        if (reading.m_HasReading && (readingTime < reading.m_ReadingTime))
+        {
+            return;
+        }
+        // Member by member; assigning a braced temporary instead costs
+        // a store-forwarding stall upon the sensor's next reading.
+        reading.m_Temperature = temperature;
+        reading.m_ReadingTime = readingTime;
+        reading.m_HasReading = true;
+    }
+
+    // Stale readings are excluded upon Result(), as of this time.
+    void Expire(const SteadyClock_t::time_point& timeNow)
+    {
+        m_TimeNow = timeNow;
+    }
+
+    Aggregate_t Result() const
+    {
+        return Policy::template Aggregate<SENSOR_COUNT>(m_Readings, m_TimeNow);
+    }
+
+    // That of the least recently updated fresh reading; the epoch if none.
+    SteadyClock_t::time_point OldestReadingTime() const
+    {
+        auto oldest = SteadyClock_t::time_point::max();
+        for (const auto& reading : m_Readings)
+        {
+            if (reading.m_HasReading && Utility::IsFresh(reading.m_ReadingTime, m_TimeNow))
+            {
+                oldest = std::min(oldest, reading.m_ReadingTime);
+            }
+        }
+        return (oldest != SteadyClock_t::time_point::max()) ? oldest : SteadyClock_t::time_point{};
+    }
+
+private:
+    std::array<LatestReading_t, SENSOR_COUNT>   m_Readings;
+    SteadyClock_t::time_point                   m_TimeNow;
+};
@@ -0,0 +1,499 @@
+#include "AlertRules.h"
+#include "CoarseClock.h"
+
+#include <map>
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <algorithm>
+
+namespace
+{
+    std::string_view Trim(std::string_view text)
+    {
+        auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+        {
+            return {};
+        }
+        auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // "<n>s" or "<n>m".
+    bool ParseDuration(const std::string_view& text, SteadyClock_t::duration& duration)
+    {
+        size_t count = 0;
+        auto [pEnd, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+        if ((error != std::errc()) || (pEnd != text.data() + text.size() - 1))
+        {
+            return false;
+        }
+
+        switch (text.back())
+        {
+            case 's': duration = Seconds_t(count); return true;
+            case 'm': duration = Minutes_t(count); return true;
+        }
+        return false;
+    }
+
+    // NaN, i.e. no value, equals itself here.
+    bool IsSameValue(const double& lhs, const double& rhs)
+    {
+        return (lhs == rhs) || (std::isnan(lhs) && std::isnan(rhs));
+    }
+}
+
+std::vector<AlertRuleDefinition_t> AlertRuleEngine::LoadDefinitions(const std::string_view& path)
+{
+    std::vector<AlertRuleDefinition_t> definitions;
+
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        return definitions;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::string_view text(line);
+        text = Trim(text.substr(0, text.find('#')));
+        if (text.empty())
+        {
+            continue;
+        }
+
+        auto equals = text.find('=');
+        AlertRuleDefinition_t definition;
+        std::string comparison;
+        bool isValid = (equals != std::string_view::npos);
+        if (isValid)
+        {
+            definition.m_Name = std::string(Trim(text.substr(0, equals)));
+            definition.m_Expression = std::string(Trim(text.substr(equals + 1)));
+
+            std::istringstream iss(definition.m_Expression);
+            isValid = (iss >> definition.m_Input >> comparison >> definition.m_Threshold)
+                   && ((comparison == ">") || (comparison == "<"));
+
+            std::string keyword;
+            while (isValid && (iss >> keyword))
+            {
+                std::string argument;
+                if ((keyword == "for") && (iss >> argument))
+                {
+                    isValid = ParseDuration(argument, definition.m_Hold);
+                }
+                else if (keyword == "hysteresis")
+                {
+                    isValid = (iss >> definition.m_Hysteresis) && (definition.m_Hysteresis >= 0.0);
+                }
+                else
+                {
+                    isValid = false;
+                }
+            }
+        }
+
+        if (!isValid || definition.m_Name.empty()
+            || (definition.m_Name.find_first_of(" \t") != std::string::npos))
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber
+                      << ": Expected \"<name> = <input> <'>'|'<'> <threshold> [for <n><s|m>] [hysteresis <h>]\"; skipped.\n";
+            continue;
+        }
+
+        definition.m_IsAbove = (comparison == ">");
+        definitions.push_back(std::move(definition));
+    }
+
+    std::cout << "[INFO] Loaded " << definitions.size() << " alert rules from " << path << "\n";
+    return definitions;
+}
+
+AlertRuleEngine::AlertRuleEngine(asio::io_context& ioContext,
+                                 const PriorityScheduler::executor_type& executor,
+                                 const SensorTable& sensorTable, const size_t& numberOfSensors,
+                                 const std::vector<AlertRuleDefinition_t>& definitions)
+    : m_TheSensorTable(sensorTable)
+    , m_NumberOfSensors(numberOfSensors)
+    , m_EvaluationTimer(ioContext)
+    , m_Strand(executor)
+    , m_Slots()
+    , m_Program()
+    , m_Names()
+    , m_Expressions()
+    , m_DefinitionOrder()
+    , m_SensorSlots()
+    , m_pIsSlotDirty()
+    , m_StatusMutex()
+    , m_Status()
+    , m_NumberPending(0)
+    , m_Evaluations(Metrics::Counter("alerts.evaluations"))
+    , m_Raised(Metrics::Counter("alerts.raised"))
+    , m_Cleared(Metrics::Counter("alerts.cleared"))
+    , m_Firing(Metrics::Gauge("alerts.firing"))
+{
+    // Inputs named by several rules are computed but once.
+    std::map<std::pair<RuleInput_t, uint32_t>, uint32_t> slotOf;
+    std::vector<std::pair<uint32_t, size_t>> rules; // Slot, definition.
+
+    for (size_t i = 0; i < definitions.size(); i++)
+    {
+        const auto& definition = definitions[i];
+
+        size_t operand = 0;
+        RuleInput_t kind;
+        if (Utility::ParseIndex(definition.m_Input, "sensor:", operand) && (operand < numberOfSensors))
+        {
+            kind = RuleInput_t::SENSOR;
+        }
+        else if (Utility::ParseIndex(definition.m_Input, "zone:", operand) && (operand < NUMBER_OF_SENSOR_ZONES))
+        {
+            kind = RuleInput_t::ZONE_AVERAGE;
+        }
+        else if (definition.m_Input == "stale_percent")
+        {
+            kind = RuleInput_t::STALE_PERCENT;
+        }
+        else
+        {
+            std::cout << "[ERROR] Alert rule \"" << definition.m_Name << "\": Unknown input \""
+                      << definition.m_Input << "\"; dropped.\n";
+            continue;
+        }
+
+        auto [it, isNew] = slotOf.try_emplace({kind, static_cast<uint32_t>(operand)},
+                                              static_cast<uint32_t>(m_Slots.size()));
+        if (isNew)
+        {
+            m_Slots.push_back(InputSlot_t{kind, static_cast<uint32_t>(operand), 0, 0,
+                                          std::numeric_limits<double>::quiet_NaN(),
+                                          SteadyClock_t::time_point::max()});
+        }
+        rules.emplace_back(it->second, i);
+    }
+
+    // Lay the program out by input, each input's rules contiguous.
+    std::stable_sort(rules.begin(), rules.end(), [](const auto& lhs, const auto& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    std::vector<std::pair<size_t, uint32_t>> definitionOrder; // Definition, instruction.
+    for (const auto& [slot, i] : rules)
+    {
+        const auto& definition = definitions[i];
+        auto instruction = static_cast<uint32_t>(m_Program.size());
+
+        if (m_Slots[slot].m_FirstInstruction == m_Slots[slot].m_LastInstruction)
+        {
+            m_Slots[slot].m_FirstInstruction = instruction;
+        }
+        m_Slots[slot].m_LastInstruction = instruction + 1;
+
+        auto clearThreshold = definition.m_IsAbove ? (definition.m_Threshold - definition.m_Hysteresis)
+                                                   : (definition.m_Threshold + definition.m_Hysteresis);
+        m_Program.push_back(RuleInstruction_t{slot, definition.m_IsAbove, definition.m_Threshold,
+                                              clearThreshold, definition.m_Hold});
+        m_Names.push_back(definition.m_Name);
+        m_Expressions.push_back(definition.m_Expression);
+        definitionOrder.emplace_back(i, instruction);
+    }
+
+    std::sort(definitionOrder.begin(), definitionOrder.end());
+    for (const auto& [i, instruction] : definitionOrder)
+    {
+        m_DefinitionOrder.push_back(instruction);
+    }
+    m_Status.resize(m_Program.size());
+
+    if (m_Program.empty())
+    {
+        return;
+    }
+
+    // Every input is computed at the first evaluation.
+    m_pIsSlotDirty = std::make_unique<std::atomic<bool>[]>(m_Slots.size());
+    for (size_t slot = 0; slot < m_Slots.size(); slot++)
+    {
+        m_pIsSlotDirty[slot].store(true, std::memory_order_relaxed);
+    }
+
+    m_SensorSlots.resize(numberOfSensors);
+    for (size_t slot = 0; slot < m_Slots.size(); slot++)
+    {
+        for (size_t n = 0; n < numberOfSensors; n++)
+        {
+            const auto& input = m_Slots[slot];
+            if (((input.m_Kind == RuleInput_t::SENSOR) && (input.m_Operand == n))
+                || ((input.m_Kind == RuleInput_t::ZONE_AVERAGE) && (input.m_Operand == Utility::ZoneOf(n)))
+                || (input.m_Kind == RuleInput_t::STALE_PERCENT))
+            {
+                m_SensorSlots[n].push_back(static_cast<uint32_t>(slot));
+            }
+        }
+    }
+
+    std::cout << "[INFO] Compiled " << m_Program.size() << " alert rules over "
+              << m_Slots.size() << " inputs\n";
+}
+
+AlertRuleEngine::~AlertRuleEngine()
+{
+}
+
+void AlertRuleEngine::Start()
+{
+    if (!m_Program.empty())
+    {
+        ArmEvaluationTimer();
+    }
+}
+
+void AlertRuleEngine::Stop()
+{
+    m_EvaluationTimer.cancel();
+}
+
+void AlertRuleEngine::Apply(const ReadingRecord_t* pRecords, const size_t& count)
+{
+    if (m_SensorSlots.empty())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (const auto& slot : m_SensorSlots[pRecords[i].m_SensorNodeNumber])
+        {
+            // Read first; the flag is then rarely written, nor its cache
+            // line bounced between threads.
+            auto& isDirty = m_pIsSlotDirty[slot];
+            if (!isDirty.load(std::memory_order_relaxed))
+            {
+                isDirty.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
+
+std::vector<AlertRuleStatus_t> AlertRuleEngine::Status() const
+{
+    std::unique_lock<std::mutex> lock(m_StatusMutex);
+
+    std::vector<AlertRuleStatus_t> status;
+    status.reserve(m_DefinitionOrder.size());
+    for (const auto& instruction : m_DefinitionOrder)
+    {
+        status.push_back(AlertRuleStatus_t{m_Names[instruction], m_Expressions[instruction],
+                                           m_Status[instruction].m_State,
+                                           m_Slots[m_Program[instruction].m_Slot].m_Value});
+    }
+    return status;
+}
+
+const char* AlertRuleEngine::ToString(const AlertState_t& state)
+{
+    switch (state)
+    {
+        case AlertState_t::CLEAR:   return "clear";
+        case AlertState_t::PENDING: return "pending";
+        case AlertState_t::FIRING:  return "firing";
+    }
+    return "unknown";
+}
+
+void AlertRuleEngine::ArmEvaluationTimer()
+{
+    m_EvaluationTimer.expires_after(
+        std::chrono::milliseconds(ALERT_EVALUATION_INTERVAL_MILLISECONDS));
+    m_EvaluationTimer.async_wait(asio::bind_executor(m_Strand,
+    [this](const std::error_code& error)
+    {
+        if (error == asio::error::operation_aborted)
+        {
+            return;
+        }
+
+        Evaluate(Utility::CoarseClock::Refresh());
+        ArmEvaluationTimer();
+    }));
+}
+
+void AlertRuleEngine::Evaluate(const SteadyClock_t::time_point& timeNow)
+{
+    std::unique_lock<std::mutex> lock(m_StatusMutex);
+
+    // Taken only should some input need recomputing.
+    SnapshotPointer_t snapshot;
+
+    for (size_t slot = 0; slot < m_Slots.size(); slot++)
+    {
+        auto& input = m_Slots[slot];
+        auto isDirty = m_pIsSlotDirty[slot].exchange(false, std::memory_order_acq_rel)
+                    || (timeNow >= input.m_ExpiryTime);
+        if (!isDirty)
+        {
+            continue;
+        }
+
+        if (!snapshot)
+        {
+            snapshot = m_TheSensorTable.TakeSnapshot();
+        }
+
+        auto previous = input.m_Value;
+        Recompute(input, *snapshot, timeNow);
+        if (IsSameValue(previous, input.m_Value))
+        {
+            continue;
+        }
+
+        for (auto instruction = input.m_FirstInstruction; instruction < input.m_LastInstruction; instruction++)
+        {
+            Execute(instruction, timeNow);
+        }
+    }
+
+    // Pending rules fire once held for long enough, whether or not their
+    // input has changed since.
+    for (uint32_t instruction = 0; (m_NumberPending > 0) && (instruction < m_Program.size()); instruction++)
+    {
+        if ((m_Status[instruction].m_State == AlertState_t::PENDING)
+            && ((timeNow - m_Status[instruction].m_Since) >= m_Program[instruction].m_Hold))
+        {
+            Transition(instruction, AlertState_t::FIRING, timeNow);
+        }
+    }
+}
+
+void AlertRuleEngine::Recompute(InputSlot_t& input, const SensorTableSnapshot_t& snapshot,
+                                const SteadyClock_t::time_point& timeNow) const
+{
+    double sum = 0.0;
+    size_t count = 0;
+    auto expiryTime = SteadyClock_t::time_point::max();
+
+    auto include = [&](const SensorSample_t& sample)
+    {
+        if (Utility::IsFresh(sample, timeNow))
+        {
+            sum += sample.m_Value;
+            ++count;
+            expiryTime = std::min(expiryTime, sample.m_ReadingTime + Minutes_t(STALE_READING_DURATION_MINUTES));
+        }
+    };
+
+    if (input.m_Kind == RuleInput_t::SENSOR)
+    {
+        include(snapshot.m_Sensors[input.m_Operand]);
+    }
+    else
+    {
+        for (const auto& sample : snapshot.m_Sensors)
+        {
+            if ((input.m_Kind == RuleInput_t::STALE_PERCENT) || (sample.m_Zone == input.m_Operand))
+            {
+                include(sample);
+            }
+        }
+    }
+
+    if (input.m_Kind == RuleInput_t::STALE_PERCENT)
+    {
+        input.m_Value = 100.0 * static_cast<double>(m_NumberOfSensors - count) / static_cast<double>(m_NumberOfSensors);
+    }
+    else
+    {
+        input.m_Value = (count > 0) ? (sum / static_cast<double>(count)) : std::numeric_limits<double>::quiet_NaN();
+    }
+    input.m_ExpiryTime = expiryTime;
+}
+
+void AlertRuleEngine::Execute(const uint32_t& instruction, const SteadyClock_t::time_point& timeNow)
+{
+    const auto& rule = m_Program[instruction];
+    auto value = m_Slots[rule.m_Slot].m_Value;
+
+    // Comparisons with NaN are false; a missing input is thus never
+    // beyond its threshold, and always back from it.
+    bool isBeyond = rule.m_IsAbove ? (value > rule.m_Threshold) : (value < rule.m_Threshold);
+    bool isBack = !(rule.m_IsAbove ? (value > rule.m_ClearThreshold) : (value < rule.m_ClearThreshold));
+
+    m_Evaluations.fetch_add(1, std::memory_order_relaxed);
+
+    switch (m_Status[instruction].m_State)
+    {
+        case AlertState_t::CLEAR:
+            if (isBeyond)
+            {
+                Transition(instruction, (rule.m_Hold.count() > 0) ? AlertState_t::PENDING : AlertState_t::FIRING,
+                           timeNow);
+            }
+            break;
+        case AlertState_t::PENDING:
+            if (!isBeyond)
+            {
+                Transition(instruction, AlertState_t::CLEAR, timeNow);
+            }
+            break;
+        case AlertState_t::FIRING:
+            if (isBack)
+            {
+                Transition(instruction, AlertState_t::CLEAR, timeNow);
+            }
+            break;
+    }
+}
+
+void AlertRuleEngine::Transition(const uint32_t& instruction, const AlertState_t& state,
+                                 const SteadyClock_t::time_point& timeNow)
+{
+    auto& status = m_Status[instruction];
+    auto previous = status.m_State;
+    status = RuleStatus_t{state, timeNow};
+
+    if (previous == AlertState_t::PENDING)
+    {
+        --m_NumberPending;
+    }
+    if (state == AlertState_t::PENDING)
+    {
+        ++m_NumberPending;
+    }
+
+    // Formatted apart from std::cout, whose own format is left alone, and
+    // written in one go.
+    auto value = m_Slots[m_Program[instruction].m_Slot].m_Value;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+
+    if (state == AlertState_t::FIRING)
+    {
+        m_Raised.fetch_add(1, std::memory_order_relaxed);
+        m_Firing.fetch_add(1, std::memory_order_relaxed);
+        oss << "[WARN] Alert \"" << m_Names[instruction] << "\" raised: "
+            << m_Expressions[instruction] << " (value " << value << ")\n";
+        std::cout << oss.str();
+    }
+    else if (previous == AlertState_t::FIRING)
+    {
+        m_Cleared.fetch_add(1, std::memory_order_relaxed);
+        m_Firing.fetch_sub(1, std::memory_order_relaxed);
+        oss << "[INFO] Alert \"" << m_Names[instruction] << "\" cleared";
+        if (!std::isnan(value))
+        {
+            oss << " (value " << value << ")";
+        }
+        oss << "\n";
+        std::cout << oss.str();
+    }
+}
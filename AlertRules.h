@@ -0,0 +1,187 @@
+/***********************************************************************
+* @file      AlertRules.h
+*
+* Threshold alerts, e.g. "zone 0 average above 35 °C for 2 minutes" or
+* "more than 10% of sensors stale", raised and cleared as the sensor
+* table changes.
+*
+* @brief    Each rule is defined on one line of ascii text in
+*           ALERT_RULES_PATH:
+*
+*           # <name> = <input> <'>'|'<'> <threshold> [for <n><s|m>] [hysteresis <h>]
+*           zone0_hot   = zone:0 > 35 for 2m
+*           many_stale  = stale_percent > 10
+*           sensor3_low = sensor:3 < -10 hysteresis 2
+*
+*           An input is the latest fresh reading of a sensor ("sensor:<n>"),
+*           the average fresh reading of a zone ("zone:<z>"), or the
+*           percentage of all sensors that are stale ("stale_percent"). A
+*           sensor or zone without a fresh reading satisfies no threshold.
+*
+*           Rules are compiled at load time into a flat program: the
+*           distinct inputs, each computed once however many rules share
+*           it, and one instruction per rule, ordered by input such that
+*           each input's rules are contiguous. The ingest pipeline merely
+*           flags the inputs that its readings touch; an evaluation then
+*           recomputes only flagged inputs (and those whose oldest fresh
+*           reading has since gone stale), and runs only the instructions
+*           of inputs whose value thereby changed.
+*
+*           A rule beyond its threshold is pending until it has been so for
+*           its hold ("for") duration, then fires; it clears only once its
+*           input is back past the threshold by its hysteresis.
+*
+* @note     Evaluation, and the delivery of alerts, run on a strand of
+*           their own at HandlerPriority_t::ALERT (see PriorityExecutor.h),
+*           every ALERT_EVALUATION_INTERVAL_MILLISECONDS. Not on the
+*           analytics pool, where they would queue behind heatmap
+*           recomputes and the query API's file exports.
+*
+*           Metrics: alerts.evaluations, alerts.raised, alerts.cleared,
+*           alerts.firing.
+*
+* @warning  ALERT is the lowest priority; under a saturating backlog of
+*           readings, alerts are delayed rather than ingest.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "SensorTable.h"
+#include "IngestPipeline.h"
+#include "PriorityExecutor.h"
+
+struct AlertRuleDefinition_t
+{
+    std::string                m_Name;
+    std::string                m_Input; // "sensor:<n>", "zone:<z>" or "stale_percent".
+    bool                       m_IsAbove{true};
+    double                     m_Threshold{0.0};
+    SteadyClock_t::duration    m_Hold{};
+    double                     m_Hysteresis{ALERT_DEFAULT_HYSTERESIS};
+    std::string                m_Expression;
+};
+
+enum class AlertState_t : uint8_t
+{
+    CLEAR,
+    PENDING,
+    FIRING
+};
+
+struct AlertRuleStatus_t
+{
+    std::string                m_Name;
+    std::string                m_Expression;
+    AlertState_t               m_State;
+    double                     m_Value; // NaN if the input has none.
+};
+
+class AlertRuleEngine
+{
+    enum class RuleInput_t : uint8_t
+    {
+        SENSOR,
+        ZONE_AVERAGE,
+        STALE_PERCENT
+    };
+
+    struct InputSlot_t
+    {
+        RuleInput_t                m_Kind;
+        uint32_t                   m_Operand;
+        uint32_t                   m_FirstInstruction;
+        uint32_t                   m_LastInstruction;
+        double                     m_Value;
+        SteadyClock_t::time_point  m_ExpiryTime; // When next a fresh reading of it goes stale.
+    };
+
+    struct RuleInstruction_t
+    {
+        uint32_t                   m_Slot;
+        bool                       m_IsAbove;
+        double                     m_Threshold;
+        double                     m_ClearThreshold;
+        SteadyClock_t::duration    m_Hold;
+    };
+
+    struct RuleStatus_t
+    {
+        AlertState_t               m_State{AlertState_t::CLEAR};
+        SteadyClock_t::time_point  m_Since{};
+    };
+
+    using Strand_t = asio::strand<PriorityScheduler::executor_type>;
+
+public:
+    // Malformed lines are reported and skipped. A missing file simply
+    // defines no rules.
+    static std::vector<AlertRuleDefinition_t> LoadDefinitions(const std::string_view& path);
+
+    // Rules with unknown inputs are reported and dropped.
+    AlertRuleEngine(asio::io_context& ioContext, const PriorityScheduler::executor_type& executor,
+                    const SensorTable& sensorTable, const size_t& numberOfSensors,
+                    const std::vector<AlertRuleDefinition_t>& definitions);
+    virtual ~AlertRuleEngine();
+
+    AlertRuleEngine(const AlertRuleEngine&) = delete;
+    AlertRuleEngine& operator=(const AlertRuleEngine&) = delete;
+
+    void Start();
+    void Stop();
+
+    // Flags the input slots of the batch's sensors for the next
+    // evaluation; rules themselves run on the ALERT strand. Lock-free.
+    void Apply(const ReadingRecord_t* pRecords, const size_t& count);
+
+    // Rules in definition order.
+    std::vector<AlertRuleStatus_t> Status() const;
+
+    static const char* ToString(const AlertState_t& state);
+
+protected:
+    void ArmEvaluationTimer();
+    void Evaluate(const SteadyClock_t::time_point& timeNow);
+
+private:
+    // Require m_StatusMutex.
+    void Recompute(InputSlot_t& slot, const SensorTableSnapshot_t& snapshot,
+                   const SteadyClock_t::time_point& timeNow) const;
+    void Execute(const uint32_t& instruction, const SteadyClock_t::time_point& timeNow);
+    void Transition(const uint32_t& instruction, const AlertState_t& state,
+                    const SteadyClock_t::time_point& timeNow);
+
+    const SensorTable&                         m_TheSensorTable;
+    size_t                                     m_NumberOfSensors;
+    asio::steady_timer                         m_EvaluationTimer;
+    Strand_t                                   m_Strand;
+
+    // The program; instructions, names and expressions in input order.
+    std::vector<InputSlot_t>                   m_Slots;
+    std::vector<RuleInstruction_t>             m_Program;
+    std::vector<std::string>                   m_Names;
+    std::vector<std::string>                   m_Expressions;
+    std::vector<uint32_t>                      m_DefinitionOrder; // Instruction of each rule.
+
+    // Indexed by physical sensor; empty if there are no rules.
+    std::vector<std::vector<uint32_t>>         m_SensorSlots;
+    std::unique_ptr<std::atomic<bool>[]>       m_pIsSlotDirty;
+
+    mutable std::mutex                         m_StatusMutex;
+    std::vector<RuleStatus_t>                  m_Status;
+    size_t                                     m_NumberPending;
+
+    Metrics::Counter_t&                        m_Evaluations;
+    Metrics::Counter_t&                        m_Raised;
+    Metrics::Counter_t&                        m_Cleared;
+    Metrics::Gauge_t&                          m_Firing;
+};
@@ -0,0 +1,154 @@
+#include "AnomalyDetector.h"
+
+#include <cmath>
+
+AnomalyDetector::AnomalyDetector(const size_t& numberOfSensors)
+    : m_Sensors(numberOfSensors)
+    , m_Zones()
+    , m_DetectMutex()
+    , m_pEvents(std::make_unique<EventQueue_t>())
+    , m_HistoryMutex()
+    , m_History()
+    , m_ZScoreAnomalies(Metrics::Counter("anomaly.zscore"))
+    , m_RateAnomalies(Metrics::Counter("anomaly.rate"))
+    , m_ZoneAnomalies(Metrics::Counter("anomaly.zone"))
+    , m_DroppedEvents(Metrics::Counter("anomaly.events.dropped"))
+{
+}
+
+AnomalyDetector::~AnomalyDetector()
+{
+}
+
+void AnomalyDetector::Detect(const ReadingRecord_t* pRecords, const size_t& count)
+{
+    std::unique_lock<std::mutex> lock(m_DetectMutex);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& record = pRecords[i];
+        auto& sensor = m_Sensors[record.m_SensorNodeNumber];
+        auto& zone = m_Zones[Utility::ZoneOf(record.m_SensorNodeNumber)];
+        const auto temperature = record.m_Value;
+
+        // Each reading is judged against the baselines as they stood
+        // before it, lest a spike dilute its own score.
+        uint8_t anomalies = 0;
+        double zScore = 0.0;
+        double rate = 0.0;
+        double divergence = 0.0;
+
+        if (sensor.m_Readings >= ANOMALY_WARMUP_READINGS)
+        {
+            auto standardDeviation = std::max(std::sqrt(static_cast<double>(sensor.m_Variance)),
+                                              ANOMALY_MINIMUM_STANDARD_DEVIATION);
+            zScore = (temperature - sensor.m_Mean) / standardDeviation;
+            anomalies |= (std::abs(zScore) > ANOMALY_Z_SCORE_THRESHOLD) ? ZSCORE : 0;
+        }
+
+        // Readings out of order, or timed alike, have no rate to speak of.
+        if ((sensor.m_Readings > 0) && (record.m_ReadingTime > sensor.m_LastReadingTime))
+        {
+            auto seconds = std::max(std::chrono::duration<double>(record.m_ReadingTime - sensor.m_LastReadingTime).count(),
+                                    ANOMALY_MINIMUM_RATE_INTERVAL_MILLISECONDS / 1000.0);
+            rate = std::abs(temperature - sensor.m_LastTemperature) / seconds;
+            anomalies |= (rate > ANOMALY_MAXIMUM_RATE_DEGREES_PER_SECOND) ? RATE : 0;
+        }
+
+        if (zone.m_Readings >= ANOMALY_WARMUP_READINGS)
+        {
+            divergence = temperature - zone.m_Mean;
+            anomalies |= (std::abs(divergence) > ANOMALY_ZONE_DIVERGENCE_DEGREES) ? ZONE : 0;
+        }
+
+        // Only the onset of an anomaly is an event.
+        if (auto onsets = static_cast<uint8_t>(anomalies & ~sensor.m_ActiveAnomalies); onsets != 0) [[unlikely]]
+        {
+            if (onsets & ZSCORE)
+            {
+                Emit(record, ZSCORE, zScore);
+            }
+            if (onsets & RATE)
+            {
+                Emit(record, RATE, rate);
+            }
+            if (onsets & ZONE)
+            {
+                Emit(record, ZONE, divergence);
+            }
+        }
+        sensor.m_ActiveAnomalies = anomalies;
+
+        // West's incremental EWMA and variance.
+        if (sensor.m_Readings == 0)
+        {
+            sensor.m_Mean = static_cast<float>(temperature);
+            sensor.m_Variance = 0.0f;
+        }
+        else
+        {
+            auto difference = temperature - sensor.m_Mean;
+            auto increment = ANOMALY_EWMA_ALPHA * difference;
+            sensor.m_Mean = static_cast<float>(sensor.m_Mean + increment);
+            sensor.m_Variance = static_cast<float>((1.0 - ANOMALY_EWMA_ALPHA) * (sensor.m_Variance + (difference * increment)));
+        }
+        sensor.m_LastTemperature = static_cast<float>(temperature);
+        sensor.m_LastReadingTime = std::max(sensor.m_LastReadingTime, record.m_ReadingTime);
+        sensor.m_Readings += (sensor.m_Readings < UINT16_MAX);
+
+        zone.m_Mean = (zone.m_Readings == 0) ? temperature
+                    : zone.m_Mean + (ANOMALY_ZONE_EWMA_ALPHA * (temperature - zone.m_Mean));
+        ++zone.m_Readings;
+    }
+}
+
+void AnomalyDetector::Emit(const ReadingRecord_t& record, const AnomalyKind_t& kind, const double& score)
+{
+    switch (kind)
+    {
+        case ZSCORE: m_ZScoreAnomalies.fetch_add(1, std::memory_order_relaxed); break;
+        case RATE:   m_RateAnomalies.fetch_add(1, std::memory_order_relaxed); break;
+        case ZONE:   m_ZoneAnomalies.fetch_add(1, std::memory_order_relaxed); break;
+    }
+
+    AnomalyEvent_t event{record.m_SensorNodeNumber, kind, record.m_Value, score, record.m_ReadingTime};
+    if (!m_pEvents->TryPush(event))
+    {
+        m_DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AnomalyDetector::Collect()
+{
+    std::unique_lock<std::mutex> lock(m_HistoryMutex);
+
+    std::array<AnomalyEvent_t, 64> events;
+    while (auto popped = m_pEvents->PopBatch(events.data(), events.size()))
+    {
+        m_History.insert(m_History.end(), events.begin(), events.begin() + popped);
+    }
+
+    while (m_History.size() > ANOMALY_HISTORY_LENGTH)
+    {
+        m_History.pop_front();
+    }
+}
+
+std::vector<AnomalyEvent_t> AnomalyDetector::History()
+{
+    Collect();
+
+    std::unique_lock<std::mutex> lock(m_HistoryMutex);
+    return {m_History.begin(), m_History.end()};
+}
+
+const char* AnomalyDetector::ToString(const AnomalyKind_t& kind)
+{
+    switch (kind)
+    {
+        case ZSCORE: return "zscore";
+        case RATE:   return "rate";
+        case ZONE:   return "zone";
+    }
+    return "unknown";
+}
@@ -0,0 +1,130 @@
+/***********************************************************************
+* @file      AnomalyDetector.h
+*
+* Streaming detection of sensors whose readings deviate abnormally,
+* evaluated reading by reading as the ingest pipeline applies them.
+*
+* @brief    Three detectors, each O(1) per reading:
+*
+*           ZSCORE - the reading lies more than ANOMALY_Z_SCORE_THRESHOLD
+*                    standard deviations from the sensor's own baseline,
+*                    an exponentially weighted moving average (EWMA) and
+*                    variance of its past readings.
+*
+*           RATE   - the reading changed faster than
+*                    ANOMALY_MAXIMUM_RATE_DEGREES_PER_SECOND since the
+*                    sensor's previous reading, measured over no less
+*                    than ANOMALY_MINIMUM_RATE_INTERVAL_MILLISECONDS.
+*
+*           ZONE   - the reading diverges from the EWMA of all readings of
+*                    its zone (see Utility::ZoneOf()) by more than
+*                    ANOMALY_ZONE_DIVERGENCE_DEGREES.
+*
+*           Per-sensor state is one dense array of 24-byte baselines, so a
+*           reading touches one cache line of state. An event is emitted
+*           only as a sensor enters an anomaly, not for as long as it stays
+*           in one, and is pushed onto a bounded lock-free ring; should the
+*           ring be full, the event is dropped and counted, never waited
+*           for. Collect() moves queued events into a short history, which
+*           the query API serves ("ANOMALIES"; see QueryServer.h).
+*
+* @note     Metrics: anomaly.zscore, anomaly.rate, anomaly.zone,
+*           anomaly.events.dropped.
+*
+* @warning  Baselines are not judged until ANOMALY_WARMUP_READINGS
+*           readings have been seen, and keep on learning from anomalous
+*           readings too; a lasting shift thus becomes the new normal.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "SpscRing.h"
+#include "IngestPipeline.h"
+
+enum AnomalyKind_t : uint8_t
+{
+    ZSCORE = 1 << 0,
+    RATE   = 1 << 1,
+    ZONE   = 1 << 2,
+};
+
+struct AnomalyEvent_t
+{
+    uint32_t                   m_SensorNodeNumber;
+    AnomalyKind_t              m_Kind;
+    double                     m_Temperature;
+    double                     m_Score; // z-score, deg C per second, or deg C off the zone.
+    SteadyClock_t::time_point  m_ReadingTime;
+};
+
+class AnomalyDetector
+{
+    struct SensorBaseline_t
+    {
+        float                      m_Mean{0.0f};
+        float                      m_Variance{0.0f};
+        float                      m_LastTemperature{0.0f};
+        uint16_t                   m_Readings{0}; // Saturates.
+        uint8_t                    m_ActiveAnomalies{0};
+        SteadyClock_t::time_point  m_LastReadingTime{};
+    };
+
+    struct ZoneBaseline_t
+    {
+        double                     m_Mean{0.0};
+        uint64_t                   m_Readings{0};
+    };
+
+    using EventQueue_t = Utility::SpscRing<AnomalyEvent_t, ANOMALY_EVENT_QUEUE_CAPACITY>;
+
+public:
+    explicit AnomalyDetector(const size_t& numberOfSensors);
+    virtual ~AnomalyDetector();
+
+    AnomalyDetector(const AnomalyDetector&) = delete;
+    AnomalyDetector& operator=(const AnomalyDetector&) = delete;
+
+    // Scores each reading of the batch against its sensor's and zone's
+    // baselines, then folds it into them; anomalies are queued for
+    // Collect(). Never blocks on the consumers below.
+    void Detect(const ReadingRecord_t* pRecords, const size_t& count);
+
+    // Moves queued events into the history. Safe to call from any thread.
+    void Collect();
+
+    // The ANOMALY_HISTORY_LENGTH most recent events, oldest first.
+    std::vector<AnomalyEvent_t> History();
+
+    static const char* ToString(const AnomalyKind_t& kind);
+
+private:
+    // Require m_DetectMutex.
+    void Emit(const ReadingRecord_t& record, const AnomalyKind_t& kind, const double& score);
+
+    std::vector<SensorBaseline_t>                          m_Sensors;
+    std::array<ZoneBaseline_t, NUMBER_OF_SENSOR_ZONES>     m_Zones;
+
+    // Uncontended bar the pipeline's bypass path; it makes the one ring
+    // single-producer whichever thread detects.
+    std::mutex                                             m_DetectMutex;
+    std::unique_ptr<EventQueue_t>                          m_pEvents;
+
+    // Serializes the consumers of m_pEvents.
+    std::mutex                                             m_HistoryMutex;
+    std::deque<AnomalyEvent_t>                             m_History;
+
+    Metrics::Counter_t&                                    m_ZScoreAnomalies;
+    Metrics::Counter_t&                                    m_RateAnomalies;
+    Metrics::Counter_t&                                    m_ZoneAnomalies;
+    Metrics::Counter_t&                                    m_DroppedEvents;
+};
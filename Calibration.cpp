@@ -0,0 +1,108 @@
+#include "Calibration.h"
+
+#include <memory>
+#include <fstream>
+#include <sstream>
+
+Calibration::Calibration(const size_t& numberOfSensors)
+    : m_NumberOfSensors(numberOfSensors)
+    , m_pCoefficients(new Coefficients_t(numberOfSensors))
+    , m_LoadMutex()
+    , m_TheEpochDomain()
+    , m_Rejected(Metrics::Counter("calibration.rejected"))
+    , m_Reloads(Metrics::Counter("calibration.reloads"))
+{
+}
+
+Calibration::~Calibration()
+{
+    delete m_pCoefficients.exchange(nullptr);
+}
+
+bool Calibration::Load(const std::string_view& path)
+{
+    std::unique_lock<std::mutex> lock(m_LoadMutex);
+
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        std::cout << "[WARN] No calibration found at " << path
+                  << "; keeping the current calibration.\n";
+        return false;
+    }
+
+    // Built aside, in full, whilst ingest carries on with the current set.
+    auto pCoefficients = std::make_unique<Coefficients_t>(m_NumberOfSensors);
+
+    std::string line;
+    size_t lineNumber = 0;
+    size_t calibrated = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::istringstream iss(line.substr(0, line.find('#')));
+        size_t sensorNodeNumber = 0;
+        double gain = 0.0;
+        double offset = 0.0;
+        if (!(iss >> sensorNodeNumber))
+        {
+            if (iss.eof())
+            {
+                continue; // Blank, or a comment.
+            }
+        }
+        else if ((sensorNodeNumber < m_NumberOfSensors) && (iss >> gain >> offset))
+        {
+            auto minimum = CALIBRATION_DEFAULT_MINIMUM_TEMPERATURE;
+            auto maximum = CALIBRATION_DEFAULT_MAXIMUM_TEMPERATURE;
+            iss >> std::ws;
+            if (iss.eof() || ((iss >> minimum >> maximum) && (iss >> std::ws).eof() && (minimum <= maximum)))
+            {
+                (*pCoefficients)[sensorNodeNumber] = {gain, offset, minimum, maximum};
+                ++calibrated;
+                continue;
+            }
+        }
+
+        std::cout << "[ERROR] " << path << ":" << lineNumber
+                  << ": Expected \"<sensor> <gain> <offset> [<minimum> <maximum>]\"; keeping the current calibration.\n";
+        return false;
+    }
+
+    // Readers still calibrating with the previous set keep it alive until
+    // they unpin; see EpochReclamation.h.
+    auto pPrevious = m_pCoefficients.exchange(pCoefficients.release(), std::memory_order_acq_rel);
+    m_TheEpochDomain.Retire(const_cast<Coefficients_t*>(pPrevious));
+    m_TheEpochDomain.TryReclaim();
+
+    m_Reloads.fetch_add(1, std::memory_order_relaxed);
+    std::cout << "[INFO] Calibration of " << calibrated << " sensor nodes loaded from " << path << "\n";
+    return true;
+}
+
+size_t Calibration::Apply(ReadingRecord_t* pRecords, const size_t& count) const
+{
+    Utility::EpochDomain::ReadGuard_t guard(m_TheEpochDomain);
+    const auto& coefficients = *m_pCoefficients.load(std::memory_order_acquire);
+
+    // Every reading is written back, and only those in range advance the
+    // write position; a misprediction per implausible reading would cost
+    // more than the calibration itself. Rejects NaN too.
+    size_t remaining = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& sensor = coefficients[pRecords[i].m_SensorNodeNumber];
+        auto temperature = (pRecords[i].m_Value * sensor.m_Gain) + sensor.m_Offset;
+
+        pRecords[remaining] = pRecords[i];
+        pRecords[remaining].m_Value = temperature;
+        remaining += static_cast<size_t>((temperature >= sensor.m_Minimum) & (temperature <= sensor.m_Maximum));
+    }
+
+    if (remaining < count)
+    {
+        m_Rejected.fetch_add(count - remaining, std::memory_order_relaxed);
+    }
+    return remaining;
+}
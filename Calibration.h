@@ -0,0 +1,99 @@
+/***********************************************************************
+* @file      Calibration.h
+*
+* Per-sensor offset and gain calibration, plus a plausibility range
+* check, applied to readings before they reach the sensor table and the
+* aggregation.
+*
+* @brief    Coefficients are held in one dense array indexed by sensor
+*           node number: gain, offset, and minimum and maximum plausible
+*           calibrated temperature, packed into 32 bytes, so that each
+*           reading costs one cache line of coefficients at most.
+*
+*           The aggregation stage of the ingest pipeline calibrates each
+*           drained batch in place, in one branchless pass which range
+*           checks and compacts out implausible readings as it goes.
+*
+*           Calibration is one multiply-add per reading, against a random
+*           access to its sensor's coefficients; the "calibration" benchmark
+*           (see PerformanceBenchmarks.cpp) found gathering blocks of
+*           readings into separate coefficient arrays, for SIMD, to be
+*           slower than this single pass.
+*
+*           CALIBRATION_PATH holds one line per calibrated sensor:
+*
+*           # <sensor> <gain> <offset> [<minimum> <maximum>]
+*           0  1.02  -0.35
+*           3  0.98   0.10  -40.0  85.0
+*
+*           Sensors not listed are left uncalibrated, with the default
+*           plausibility range.
+*
+* @note     Live reload: Load() publishes a whole new set of coefficients
+*           by an atomic pointer exchange and retires the previous set to
+*           an epoch reclamation domain (see EpochReclamation.h), exactly
+*           as the sensor table does its records. Ingest never pauses; each
+*           batch is calibrated wholly with one set or the other.
+*
+*           Metrics: calibration.rejected, calibration.reloads.
+*
+* @warning  A file with any malformed line is rejected as a whole, and the
+*           current coefficients are kept.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "EpochReclamation.h"
+#include "IngestPipeline.h"
+
+class Calibration
+{
+    struct alignas(32) SensorCoefficients_t
+    {
+        double   m_Gain{1.0};
+        double   m_Offset{0.0};
+        double   m_Minimum{CALIBRATION_DEFAULT_MINIMUM_TEMPERATURE};
+        double   m_Maximum{CALIBRATION_DEFAULT_MAXIMUM_TEMPERATURE};
+    };
+
+    // Immutable once published.
+    using Coefficients_t = std::vector<SensorCoefficients_t>;
+
+public:
+    // Uncalibrated, i.e. unity gain and zero offset, until loaded.
+    explicit Calibration(const size_t& numberOfSensors);
+    virtual ~Calibration();
+
+    Calibration(const Calibration&) = delete;
+    Calibration& operator=(const Calibration&) = delete;
+
+    // Safe to call at any time, from any thread; concurrent reloads are
+    // serialized. Returns false, keeping the current coefficients, if the
+    // file is missing or malformed.
+    bool Load(const std::string_view& path);
+
+    // Calibrates the temperature readings in place, and removes those
+    // out of range.
+    // Returns the number of readings remaining. Lock-free; safe to call
+    // concurrently from any thread.
+    size_t Apply(ReadingRecord_t* pRecords, const size_t& count) const;
+
+private:
+    size_t                                   m_NumberOfSensors;
+    std::atomic<const Coefficients_t*>       m_pCoefficients;
+    std::mutex                               m_LoadMutex;
+
+    // Readers pin the domain, hence it being mutable.
+    mutable Utility::EpochDomain             m_TheEpochDomain;
+
+    Metrics::Counter_t&                      m_Rejected;
+    Metrics::Counter_t&                      m_Reloads;
+};
@@ -0,0 +1,33 @@
+#include "ChannelHistory.h"
+
+ChannelHistory::ChannelHistory()
+    : m_HistoryMutex()
+    , m_History()
+{
+}
+
+ChannelHistory::~ChannelHistory()
+{
+}
+
+void ChannelHistory::Record(const SensorChannel_t& channel, const SteadyClock_t::time_point& displayTime,
+                            const Aggregate_t& aggregate)
+{
+    std::unique_lock<std::mutex> lock(m_HistoryMutex);
+
+    auto& history = m_History[static_cast<size_t>(channel)];
+    history.push_back(ChannelHistoryPoint_t{displayTime, aggregate});
+
+    while (history.size() > CHANNEL_HISTORY_LENGTH)
+    {
+        history.pop_front();
+    }
+}
+
+std::vector<ChannelHistoryPoint_t> ChannelHistory::Points(const SensorChannel_t& channel) const
+{
+    std::unique_lock<std::mutex> lock(m_HistoryMutex);
+
+    const auto& history = m_History[static_cast<size_t>(channel)];
+    return {history.begin(), history.end()};
+}
@@ -0,0 +1,55 @@
+/***********************************************************************
+* @file      ChannelHistory.h
+*
+* Recent history of each sensor channel in use (temperature, humidity,
+* pressure; see SensorChannel_t): the aggregate that the readout
+* displayed for it, one point per display.
+*
+* @brief    The display records each channel's aggregate as it shows it;
+*           the query API serves the CHANNEL_HISTORY_LENGTH most recent
+*           points of a channel ("HISTORY"; see QueryServer.h).
+*
+* @note     A channel that has never been displayed holds no points, and
+*           no memory.
+*
+* @warning
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 18, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "AggregationPolicies.h"
+
+struct ChannelHistoryPoint_t
+{
+    SteadyClock_t::time_point  m_DisplayTime;
+    Aggregate_t                m_Aggregate;
+};
+
+class ChannelHistory
+{
+public:
+    ChannelHistory();
+    virtual ~ChannelHistory();
+
+    ChannelHistory(const ChannelHistory&) = delete;
+    ChannelHistory& operator=(const ChannelHistory&) = delete;
+
+    // Safe to call from any thread.
+    void Record(const SensorChannel_t& channel, const SteadyClock_t::time_point& displayTime,
+                const Aggregate_t& aggregate);
+
+    // Oldest first.
+    std::vector<ChannelHistoryPoint_t> Points(const SensorChannel_t& channel) const;
+
+private:
+    mutable std::mutex                                                           m_HistoryMutex;
+    std::array<std::deque<ChannelHistoryPoint_t>, NUMBER_OF_SENSOR_CHANNELS>     m_History;
+};
@@ -0,0 +1,58 @@
+/***********************************************************************
+* @file      CoarseClock.h
+*
+* A per-thread cached, coarse, monotonic clock for the hot path.
+*
+* @brief    Rather than asking the kernel (vDSO) for the time once or twice
+*           per temperature reading, each thread reads the steady clock
+*           once per batch of work (per reactor wakeup, aggregator drain,
+*           display tick or query) by calling Refresh(). Everything that
+*           thread does in that batch then reuses the very same time point
+*           through Now(), which costs no more than a thread-local load.
+*
+*           All reading timestamps, staleness and ordering are on the steady
+*           clock, so they are immune to NTP steps of the wall clock.
+*
+* @note     Now() lags real time by at most the duration of the batch in
+*           which it is called; ample for staleness measured in minutes and
+*           for display intervals measured in seconds.
+*
+* @warning  Never use Now() to time a handler or a queueing delay; those
+*           want SteadyClock_t::now() proper.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <chrono>
+
+namespace Utility
+{
+    class CoarseClock
+    {
+    public:
+        using Clock_t = std::chrono::steady_clock;
+
+        // The one real clock read of this thread's current batch of work.
+        static Clock_t::time_point Refresh() noexcept
+        {
+            ts_CachedTime = Clock_t::now();
+            return ts_CachedTime;
+        }
+
+        // As of this thread's last Refresh(); refreshed upon first use.
+        static Clock_t::time_point Now() noexcept
+        {
+            if (ts_CachedTime == Clock_t::time_point{})
+            {
+                return Refresh();
+            }
+            return ts_CachedTime;
+        }
+
+    private:
+        static inline thread_local Clock_t::time_point ts_CachedTime{};
+    };
+}
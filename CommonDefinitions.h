@@ -61,9 +61,11 @@
 
 // Non-Standard Headers:
 #include "Threading.h"
+#include "CoarseClock.h"
 #include "randutils.hpp"
 
 using SystemClock_t = std::chrono::system_clock;
+using SteadyClock_t = std::chrono::steady_clock;
 using Seconds_t     = std::chrono::seconds;
 using Minutes_t     = std::chrono::minutes;
 
@@ -88,8 +90,145 @@ static constexpr std::string_view SENSOR_NODE_STATIC_IP = "127.0.0.1";
 // for different unit test scenarios.
 static constexpr uint8_t NUMBER_OF_SENSOR_NODES = 4;
 
+// Larger sites may name their number of sensor nodes on the command line,
+// up to as many as there are TCP ports from 5000 upwards.
+static constexpr size_t MAXIMUM_NUMBER_OF_SENSOR_NODES = 65535 - 5000 + 1;
+
+// Sensor nodes are grouped into zones around the customer's grounds so
+// that ops tooling can query per-zone averages.
+static constexpr uint8_t NUMBER_OF_SENSOR_ZONES = 2;
+
+// Relative weight of each zone's sensors in a location-weighted average
+// (see WeightedMeanAggregation_t in AggregationPolicies.h).
+static constexpr double SENSOR_ZONE_WEIGHTS[NUMBER_OF_SENSOR_ZONES] = {1.0, 1.0};
+
+// Quantities that a sensor node may report on its one line of ascii text
+// (see Utility::ParseSensorReading() in SensorSnapshot.h). Nodes sending
+// a bare number report temperature only, as the customer's nodes do.
+enum class SensorChannel_t : uint8_t
+{
+    TEMPERATURE = 0, // deg C
+    HUMIDITY    = 1, // %RH
+    PRESSURE    = 2, // hPa
+};
+
+static constexpr std::size_t NUMBER_OF_SENSOR_CHANNELS = 3;
+
+// The displayed aggregate of each channel in use is kept this many
+// displays deep, for the "HISTORY" query.
+static constexpr std::size_t CHANNEL_HISTORY_LENGTH = 60;
+
 static constexpr uint32_t MAXIMUM_TCP_DATA_LENGTH = 87380;
 
+// Embedded deployments (-DEMBEDDED_DEPLOYMENT; see SessionManager.h)
+// embed this much receive buffer in each sensor node instead. One line
+// of ascii text needs but a few bytes; the remainder merely lets a burst
+// of coalesced readings be drained in fewer reads.
+static constexpr uint32_t EMBEDDED_RECEIVE_BUFFER_LENGTH = 512;
+
+// Ops tooling queries the readout application over this Unix domain
+// socket, thus without ever needing to attach a debugger.
+static constexpr std::string_view QUERY_SOCKET_PATH = "/tmp/TemperatureReadoutApplication.sock";
+
+static constexpr uint32_t MAXIMUM_QUERY_LINE_LENGTH = 256;
+
+// Upon a failed accept (e.g. EMFILE), the query API retries after this
+// back-off, doubled upon each consecutive failure up to the maximum.
+static constexpr uint32_t QUERY_ACCEPT_BACKOFF_MILLISECONDS         = 100;
+static constexpr uint32_t QUERY_ACCEPT_MAXIMUM_BACKOFF_MILLISECONDS = 5000;
+
+// Virtual sensors (see VirtualSensors.h) are defined in this file, if any,
+// relative to the working directory.
+static constexpr std::string_view VIRTUAL_SENSORS_PATH = "VirtualSensors.conf";
+
+// Per-sensor calibration (see Calibration.h), likewise relative to the
+// working directory. Reloaded live upon SIGHUP.
+static constexpr std::string_view CALIBRATION_PATH = "Calibration.conf";
+
+// Calibrated readings outside of this range (that of common digital
+// temperature sensors) are implausible, hence rejected, unless a sensor
+// is given a range of its own.
+static constexpr double CALIBRATION_DEFAULT_MINIMUM_TEMPERATURE = -55.0;
+static constexpr double CALIBRATION_DEFAULT_MAXIMUM_TEMPERATURE = 125.0;
+
+// Anomaly detection (see AnomalyDetector.h). A sensor's baseline weighs
+// its latest reading by ANOMALY_EWMA_ALPHA, i.e. spans some 40 readings;
+// a zone's spans some 200 readings of all its sensors.
+static constexpr double   ANOMALY_EWMA_ALPHA                        = 0.05;
+static constexpr double   ANOMALY_ZONE_EWMA_ALPHA                   = 0.01;
+static constexpr uint16_t ANOMALY_WARMUP_READINGS                   = 20;
+static constexpr double   ANOMALY_Z_SCORE_THRESHOLD                 = 4.0;
+
+// Keeps a perfectly steady sensor from flagging its first 0.1 deg C wobble.
+static constexpr double   ANOMALY_MINIMUM_STANDARD_DEVIATION        = 0.1;
+static constexpr double   ANOMALY_MAXIMUM_RATE_DEGREES_PER_SECOND   = 5.0;
+
+// Rates are taken over at least this interval, lest a fast sensor's mere
+// noise between two readings milliseconds apart count as a steep rate.
+static constexpr uint32_t ANOMALY_MINIMUM_RATE_INTERVAL_MILLISECONDS = 1000;
+static constexpr double   ANOMALY_ZONE_DIVERGENCE_DEGREES           = 15.0;
+
+static constexpr std::size_t ANOMALY_EVENT_QUEUE_CAPACITY           = 1024;
+static constexpr std::size_t ANOMALY_HISTORY_LENGTH                 = 64;
+
+// Alert rules (see AlertRules.h), likewise relative to the working
+// directory. Rules whose inputs changed, or which are holding, are
+// evaluated at this interval.
+static constexpr std::string_view ALERT_RULES_PATH = "AlertRules.conf";
+static constexpr uint32_t ALERT_EVALUATION_INTERVAL_MILLISECONDS = 1000;
+
+// A firing rule clears only once its input is back this far (in the
+// input's own unit) on the near side of its threshold, unless the rule
+// names a hysteresis of its own.
+static constexpr double   ALERT_DEFAULT_HYSTERESIS               = 1.0;
+
+// Site heatmap (see SiteHeatmap.h): sensor coordinates are read from this
+// file, relative to the working directory; without it, there is no
+// heatmap. The grid spans the sensors' bounding box, and each cell
+// interpolates its HEATMAP_NEIGHBOURS nearest sensors, weighted by the
+// inverse of their distance raised to HEATMAP_IDW_POWER.
+static constexpr std::string_view SENSOR_LAYOUT_PATH = "SensorLayout.conf";
+static constexpr std::string_view HEATMAP_DUMP_PATH  = "/tmp/TemperatureReadoutApplication.heatmap.pgm";
+
+static constexpr uint32_t HEATMAP_GRID_WIDTH                   = 1000;
+static constexpr uint32_t HEATMAP_GRID_HEIGHT                  = 1000;
+static constexpr uint32_t HEATMAP_NEIGHBOURS                   = 4;
+static constexpr double   HEATMAP_IDW_POWER                    = 2.0;
+static constexpr uint32_t HEATMAP_UPDATE_INTERVAL_MILLISECONDS = 1000;
+
+// Sensor discovery (see SensorDiscovery.h): with --discover, the host and
+// port ranges in this file, relative to the working directory, are probed
+// for sensor nodes, and the sensors found are numbered as listed here.
+static constexpr std::string_view DISCOVERY_RANGES_PATH = "Discovery.conf";
+static constexpr std::string_view DISCOVERED_SENSORS_PATH = "DiscoveredSensors.txt";
+
+// Bounded well within the default limit of 1024 open files. A host that
+// does not answer a connect within the timeout is deemed to have no
+// sensor node on that port; one that refuses it is known at once.
+static constexpr uint32_t DISCOVERY_MAXIMUM_IN_FLIGHT_CONNECTS = 512;
+static constexpr uint32_t DISCOVERY_CONNECT_TIMEOUT_MILLISECONDS = 250;
+
+// Flight recorder (see FlightRecorder.h). Dumped here on SIGUSR1, on the
+// "TRACE" query and on fatal signals.
+static constexpr std::string_view FLIGHT_RECORDER_TRACE_PATH = "/tmp/TemperatureReadoutApplication.trace.json";
+
+static constexpr std::size_t FLIGHT_RECORDER_EVENTS_PER_THREAD = 8192;
+static constexpr std::size_t FLIGHT_RECORDER_MAXIMUM_THREADS   = 32;
+
+// Hardware performance counters (see PerfCounters.h) are read around
+// every this many receive, parse and aggregate stages per thread.
+static constexpr bool     PERF_COUNTERS_ENABLED        = true;
+static constexpr uint32_t PERF_COUNTER_SAMPLE_INTERVAL = 64;
+
+// Sampling profiler (see SamplingProfiler.h), started and stopped through
+// the query API. Its folded stacks are dumped here on "PROFILE DUMP".
+static constexpr std::string_view PROFILER_FOLDED_STACKS_PATH = "/tmp/TemperatureReadoutApplication.folded";
+
+static constexpr uint32_t    PROFILER_SAMPLE_HZ                   = 99;
+static constexpr uint32_t    PROFILER_DRAIN_INTERVAL_MILLISECONDS = 250;
+static constexpr std::size_t PROFILER_SAMPLE_SLOTS                = 4096;
+static constexpr std::size_t PROFILER_MAXIMUM_STACK_DEPTH         = 48;
+
 // Customer Requirement:
 //
 // "1. The readout shall be as close to real time as possible but 
@@ -103,13 +242,85 @@ static constexpr uint8_t MINIMUM_DISPLAY_INTERVAL_SECONDS = 1;
 // displayed temperature."
 static constexpr uint8_t STALE_READING_DURATION_MINUTES = 10;
 
+// Per-sensor token bucket: a node may complete at most this many reads
+// per display interval (beyond an equal burst). Whatever a flooding node
+// sends in excess is conflated, latest value wins, when reads resume.
+static constexpr uint32_t SENSOR_READS_PER_DISPLAY_INTERVAL = 10;
+
+// Bounds how much already-buffered data one read completion drains in
+// search of the latest reading.
+static constexpr uint32_t SENSOR_MAXIMUM_DRAIN_BYTES = 4 * MAXIMUM_TCP_DATA_LENGTH;
+
 // One thread and one io_context is all we need to successfully  
-// serialize all operations invoked from several asynchronous contexts.
-// Implicit in that one thread is an "implicit strand". Going forward,
-// should multiple threads be required, enabled and used, then an explicit
-// strand (i.e. asio::strand) will need to be declared and used to protect
-// and serialize operations to the io_context.
-static constexpr std::size_t DISPATCHER_THREAD_POOL_SIZE = 1;
+// serialize all operations invoked from several asynchronous contexts
+// under normal load. During bursts, the dispatcher grows up to the
+// maximum number of threads, and shrinks back once the burst has passed;
+// see ElasticDispatcher.h. Therefore there is no "implicit strand" to
+// rely upon and all handlers must be thread-safe.
+static constexpr std::size_t MINIMUM_DISPATCHER_THREADS = 1;
+static constexpr std::size_t MAXIMUM_DISPATCHER_THREADS = 4;
+
+// Dispatcher scaling decisions are taken at this interval, from the
+// queueing delay and utilisation measured over the interval.
+static constexpr uint32_t DISPATCHER_SCALING_INTERVAL_MILLISECONDS       = 500;
+static constexpr uint32_t DISPATCHER_SCALE_UP_QUEUE_DELAY_MICROSECONDS   = 2000;
+static constexpr uint32_t DISPATCHER_SCALE_UP_UTILISATION_PERCENT        = 85;
+static constexpr uint32_t DISPATCHER_SCALE_DOWN_QUEUE_DELAY_MICROSECONDS = 500;
+static constexpr uint32_t DISPATCHER_SCALE_DOWN_UTILISATION_PERCENT      = 25;
+
+// Consecutive quiet intervals before a thread is retired, so that we do
+// not flap between thread counts.
+static constexpr uint32_t DISPATCHER_SCALE_DOWN_HYSTERESIS               = 6;
+
+// Idle dispatcher threads wake up at least this often to check whether
+// they have been asked to retire.
+static constexpr uint32_t DISPATCHER_IDLE_CHECK_MILLISECONDS             = 100;
+
+// A dispatcher thread that has been inside one handler for longer than
+// the budget is reported, with its stack, by the watchdog; see
+// HandlerWatchdog.h.
+static constexpr uint32_t    WATCHDOG_HANDLER_BUDGET_MILLISECONDS = 100;
+static constexpr uint32_t    WATCHDOG_CHECK_INTERVAL_MILLISECONDS = 20;
+static constexpr std::size_t WATCHDOG_MAXIMUM_STACK_DEPTH         = 32;
+
+// CPU-heavy follow-on work (analytics, compression, export) is executed
+// on a separate work-stealing pool so as never to delay socket I/O.
+static constexpr std::size_t ANALYTICS_THREAD_POOL_SIZE = 2;
+
+// The ingest pipeline decouples the dispatcher (I/O) threads from the
+// aggregation stage via one single-producer/single-consumer ring per 
+// dispatcher thread. Ring capacity must be a power of 2.
+static constexpr std::size_t MAXIMUM_INGEST_PRODUCERS = 8;
+
+static_assert(MAXIMUM_DISPATCHER_THREADS <= MAXIMUM_INGEST_PRODUCERS,
+              "Each dispatcher thread ought to have its own ingest ring.");
+static constexpr std::size_t INGEST_RING_CAPACITY     = 1024;
+static constexpr std::size_t INGEST_BATCH_SIZE        = 256;
+
+// Batched ingest: rather than one receive completion (and one ring push)
+// per socket, a reactor wakeup on a readable sensor socket sweeps every
+// sensor socket that has signalled readability by then, and hands the
+// aggregation stage one batch of at most INGEST_BATCH_SIZE records per
+// sweep.
+static constexpr bool INGEST_SWEEP_READABLE_SOCKETS = true;
+
+// Overload is entered when either the dispatcher queue delay or the
+// receive-to-aggregation lag exceeds its "enter" threshold, and left once
+// both have stayed below their "exit" thresholds for a while; see
+// OverloadController.h.
+static constexpr uint32_t OVERLOAD_EVALUATION_INTERVAL_MILLISECONDS = 250;
+static constexpr uint32_t OVERLOAD_ENTER_QUEUE_DELAY_MICROSECONDS   = 20000;
+static constexpr uint32_t OVERLOAD_ENTER_HANDLER_LAG_MICROSECONDS   = 50000;
+static constexpr uint32_t OVERLOAD_EXIT_QUEUE_DELAY_MICROSECONDS    = 2000;
+static constexpr uint32_t OVERLOAD_EXIT_HANDLER_LAG_MICROSECONDS    = 5000;
+static constexpr uint32_t OVERLOAD_EXIT_HYSTERESIS                  = 8;
+
+// Whilst overloaded, sensors receiving more than this multiple of the
+// fleet mean have their reads paused, and the display refreshes less
+// often than it otherwise would.
+static constexpr uint32_t OVERLOAD_NOISY_SENSOR_FACTOR              = 2;
+static constexpr uint32_t OVERLOAD_READ_PAUSE_MILLISECONDS          = 100;
+static constexpr uint8_t  OVERLOAD_DISPLAY_INTERVAL_SECONDS         = 3;
 
 namespace Utility 
 {     
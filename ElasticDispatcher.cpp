@@ -0,0 +1,361 @@
+#include "ElasticDispatcher.h"
+#include "HandlerWatchdog.h"
+
+#include <algorithm>
+
+ElasticDispatcher::ElasticDispatcher(asio::io_context& ioContext,
+                                     const size_t& minimumThreads,
+                                     const size_t& maximumThreads)
+    : m_TheIOContext(ioContext)
+    , m_MinimumThreads((minimumThreads > 0) ? minimumThreads : 1)
+    , m_MaximumThreads((maximumThreads > m_MinimumThreads) ? maximumThreads : m_MinimumThreads)
+    , m_WorkersMutex()
+    , m_Workers()
+    , m_RunningWorkers()
+    , m_ActiveThreads(0)
+    , m_RetireRequests(0)
+    , m_BusyNanoseconds(0)
+    , m_ScalingTimer(ioContext)
+    , m_LastScalingTime()
+    , m_LastBusyNanoseconds(0)
+    , m_QuietIntervals(0)
+    , m_ThreadsGauge(Metrics::Gauge("dispatcher.threads"))
+    , m_UtilisationGauge(Metrics::Gauge("dispatcher.utilisation_pct"))
+    , m_QueueDelay(Metrics::Histogram("dispatcher.queue_delay_ns"))
+    , m_ScaleUps(Metrics::Counter("dispatcher.scale_ups"))
+    , m_ScaleDowns(Metrics::Counter("dispatcher.scale_downs"))
+    , m_WorkerMetrics()
+{
+    for (size_t index = 0; index < m_MaximumThreads; index++)
+    {
+        MetricsOfWorker(index);
+    }
+}
+
+ElasticDispatcher::~ElasticDispatcher()
+{
+    m_TheIOContext.stop();
+    Join();
+}
+
+void ElasticDispatcher::Start()
+{
+    for (size_t i = 0; i < m_MinimumThreads; i++)
+    {
+        LaunchThread();
+    }
+
+    m_LastScalingTime = SteadyClock_t::now();
+    m_LastBusyNanoseconds = m_BusyNanoseconds.load(std::memory_order_relaxed);
+    ArmScalingTimer();
+}
+
+void ElasticDispatcher::Join()
+{
+    // Threads may yet be launched or retired whilst we wait; hence take
+    // them off the list one at a time rather than iterating over it.
+    while (true)
+    {
+        std::unique_ptr<Worker_t> pWorker;
+        {
+            std::unique_lock<std::mutex> lock(m_WorkersMutex);
+            if (m_Workers.empty())
+            {
+                break;
+            }
+            pWorker = std::move(m_Workers.front());
+            m_Workers.pop_front();
+        }
+
+        if (pWorker->m_Thread.joinable()
+            && (pWorker->m_Thread.get_id() != std::this_thread::get_id()))
+        {
+            pWorker->m_Thread.join();
+        }
+    }
+}
+
+size_t ElasticDispatcher::NumberOfThreads() const
+{
+    return m_ActiveThreads.load(std::memory_order_relaxed);
+}
+
+ElasticDispatcher::WorkerMetrics_t& ElasticDispatcher::MetricsOfWorker(const size_t& index)
+{
+    while (m_WorkerMetrics.size() <= index)
+    {
+        auto prefix = "dispatcher.worker." + std::to_string(m_WorkerMetrics.size());
+        m_WorkerMetrics.push_back({&Metrics::Counter(prefix + ".busy_ns"),
+                                   &Metrics::Counter(prefix + ".wait_ns"),
+                                   &Metrics::Counter(prefix + ".handlers"),
+                                   &Metrics::Counter(prefix + ".cpu_ns"),
+                                   &Metrics::Gauge(prefix + ".utilisation_pct"),
+                                   0});
+    }
+    return m_WorkerMetrics[index];
+}
+
+size_t ElasticDispatcher::LowestFreeWorkerIndex() const
+{
+    size_t index = 0;
+    while (std::any_of(m_RunningWorkers.begin(), m_RunningWorkers.end(), [index](const auto pWorker)
+           {
+               return (pWorker->m_Index == index);
+           }))
+    {
+        ++index;
+    }
+    return index;
+}
+
+void ElasticDispatcher::LaunchThread()
+{
+    std::unique_lock<std::mutex> lock(m_WorkersMutex);
+
+    auto index = LowestFreeWorkerIndex();
+    auto& pWorker = m_Workers.emplace_back(std::make_unique<Worker_t>());
+    pWorker->m_Index = index;
+    pWorker->m_pMetrics = &MetricsOfWorker(index);
+    m_RunningWorkers.push_back(pWorker.get());
+    pWorker->m_Thread = std::thread(&ElasticDispatcher::WorkerThread, this, pWorker.get());
+    pWorker->m_HasCpuClock = (::pthread_getcpuclockid(pWorker->m_Thread.native_handle(),
+                                                      &pWorker->m_CpuClock) == 0);
+
+    auto active = m_ActiveThreads.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_ThreadsGauge.store(static_cast<int64_t>(active), std::memory_order_relaxed);
+}
+
+void ElasticDispatcher::ReapRetiredThreads()
+{
+    std::unique_lock<std::mutex> lock(m_WorkersMutex);
+
+    for (auto it = m_Workers.begin(); it != m_Workers.end(); )
+    {
+        if ((*it)->m_HasExited.load(std::memory_order_acquire))
+        {
+            // Has already exited hence this join does not block.
+            (*it)->m_Thread.join();
+            it = m_Workers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool ElasticDispatcher::ShouldRetire()
+{
+    auto requests = m_RetireRequests.load(std::memory_order_relaxed);
+    while (requests > 0)
+    {
+        if (m_RetireRequests.compare_exchange_weak(requests, requests - 1,
+                                                   std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ElasticDispatcher::AccountCpuTime(Worker_t& worker, const uint64_t& cpuNanoseconds)
+{
+    // Both the worker itself (as it exits) and the scaling timer account
+    // for its CPU time; only ever advance.
+    auto accounted = worker.m_AccountedCpuNanoseconds.load(std::memory_order_relaxed);
+    while (cpuNanoseconds > accounted)
+    {
+        if (worker.m_AccountedCpuNanoseconds.compare_exchange_weak(accounted, cpuNanoseconds,
+                                                                   std::memory_order_relaxed))
+        {
+            worker.m_pMetrics->m_pCpuNanoseconds->fetch_add(
+                cpuNanoseconds - accounted, std::memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+void ElasticDispatcher::AccountWorkers(const uint64_t& elapsedNanoseconds)
+{
+    std::unique_lock<std::mutex> lock(m_WorkersMutex);
+
+    for (auto pWorker : m_RunningWorkers)
+    {
+        timespec cpuTime{};
+        if (pWorker->m_HasCpuClock && (::clock_gettime(pWorker->m_CpuClock, &cpuTime) == 0))
+        {
+            AccountCpuTime(*pWorker, static_cast<uint64_t>(cpuTime.tv_sec) * 1000000000
+                                   + static_cast<uint64_t>(cpuTime.tv_nsec));
+        }
+    }
+
+    for (auto& metrics : m_WorkerMetrics)
+    {
+        auto busy = metrics.m_pBusyNanoseconds->load(std::memory_order_relaxed);
+        auto utilisation = (elapsedNanoseconds > 0)
+                         ? (100 * (busy - metrics.m_LastBusyNanoseconds)) / elapsedNanoseconds
+                         : 0;
+        metrics.m_pUtilisation->store(static_cast<int64_t>(utilisation), std::memory_order_relaxed);
+        metrics.m_LastBusyNanoseconds = busy;
+    }
+}
+
+void ElasticDispatcher::WorkerThread(Worker_t* pWorker)
+{
+    // To aid debugging by means of strace, ps, valgrind, gdb, and
+    // variants, name our created threads; after their (reused) index.
+    auto uniqueName = "Dispatcher_" + std::to_string(pWorker->m_Index);
+    Utility::SetThreadName(uniqueName.c_str());
+    std::cout << "[INFO] : Parent just created a thread. ThreadName = "
+              << uniqueName << "\n";
+
+    // Named first, so that the watchdog reports us by name.
+    HandlerWatchdog::WatchedThread_t watched;
+
+    bool isRetired = false;
+    auto pMetrics = pWorker->m_pMetrics;
+
+    // Rather than simply blocking in run(), execute one handler at a time
+    // so as to account for busy versus idle time, and to notice in good
+    // time that we have been asked to retire.
+    while (!m_TheIOContext.stopped())
+    {
+        if (ShouldRetire())
+        {
+            isRetired = true;
+            break;
+        }
+
+        try
+        {
+            auto startTime = SteadyClock_t::now();
+            [[maybe_unused]] auto busyBefore = watched.BusyNanoseconds();
+
+            auto handlers = m_TheIOContext.poll_one();
+            auto isPolled = (handlers > 0);
+            if (!isPolled)
+            {
+                // Nothing ready. Block (in the kernel) until something is,
+                // or until it is time to check for retirement again.
+                handlers = m_TheIOContext.run_one_for(
+                    std::chrono::milliseconds(DISPATCHER_IDLE_CHECK_MILLISECONDS));
+            }
+
+            auto elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    SteadyClock_t::now() - startTime).count());
+#if defined(ASIO_CUSTOM_HANDLER_TRACKING)
+            // The handler invocation alone, even when run from within
+            // run_one_for(), whose waiting is then idle time still.
+            auto busy = std::min(watched.BusyNanoseconds() - busyBefore, elapsed);
+#else
+            // Only a handler run by poll_one() can be told from waiting.
+            auto busy = isPolled ? elapsed : 0;
+#endif
+            m_BusyNanoseconds.fetch_add(busy, std::memory_order_relaxed);
+            pMetrics->m_pBusyNanoseconds->fetch_add(busy, std::memory_order_relaxed);
+            pMetrics->m_pWaitNanoseconds->fetch_add(elapsed - busy, std::memory_order_relaxed);
+            pMetrics->m_pHandlers->fetch_add(handlers, std::memory_order_relaxed);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "[ERROR] : Caught an exception! " << e.what() << "\n";
+        }
+    }
+
+    if (isRetired)
+    {
+        std::cout << "[INFO] : Retiring Dispatcher Worker Thread "
+                  << uniqueName << "\n";
+    }
+    else
+    {
+        std::cout << "[WARN] : Exiting Dispatcher Worker Thread "
+                  << uniqueName << "\n";
+    }
+
+    timespec cpuTime{};
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) == 0)
+    {
+        AccountCpuTime(*pWorker, static_cast<uint64_t>(cpuTime.tv_sec) * 1000000000
+                               + static_cast<uint64_t>(cpuTime.tv_nsec));
+    }
+
+    {
+        // Frees our index for reuse.
+        std::unique_lock<std::mutex> lock(m_WorkersMutex);
+        std::erase(m_RunningWorkers, pWorker);
+    }
+
+    pWorker->m_HasExited.store(true, std::memory_order_release);
+}
+
+void ElasticDispatcher::ArmScalingTimer()
+{
+    m_ScalingTimer.expires_after(
+        std::chrono::milliseconds(DISPATCHER_SCALING_INTERVAL_MILLISECONDS));
+    m_ScalingTimer.async_wait([this](const std::error_code& error)
+    {
+        OnScalingTimer(error);
+    });
+}
+
+void ElasticDispatcher::OnScalingTimer(const std::error_code& error)
+{
+    if (error == asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    auto timeNow = SteadyClock_t::now();
+
+    // How late we were run is how long any handler is presently queued.
+    auto queueDelay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          timeNow - m_ScalingTimer.expiry()).count();
+    queueDelay = (queueDelay > 0) ? queueDelay : 0;
+    m_QueueDelay.Record(static_cast<uint64_t>(queueDelay));
+
+    auto busy = m_BusyNanoseconds.load(std::memory_order_relaxed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       timeNow - m_LastScalingTime).count();
+    auto active = m_ActiveThreads.load(std::memory_order_relaxed);
+    auto utilisation = (elapsed > 0)
+                     ? (100 * (busy - m_LastBusyNanoseconds)) / (static_cast<uint64_t>(elapsed) * active)
+                     : 0;
+    m_UtilisationGauge.store(static_cast<int64_t>(utilisation), std::memory_order_relaxed);
+
+    m_LastScalingTime = timeNow;
+    m_LastBusyNanoseconds = busy;
+
+    AccountWorkers(static_cast<uint64_t>(elapsed));
+    ReapRetiredThreads();
+
+    bool isOverloaded = (queueDelay > DISPATCHER_SCALE_UP_QUEUE_DELAY_MICROSECONDS * 1000)
+                     || (utilisation > DISPATCHER_SCALE_UP_UTILISATION_PERCENT);
+    bool isQuiet = (queueDelay < DISPATCHER_SCALE_DOWN_QUEUE_DELAY_MICROSECONDS * 1000)
+                && (utilisation < DISPATCHER_SCALE_DOWN_UTILISATION_PERCENT);
+
+    m_QuietIntervals = isQuiet ? (m_QuietIntervals + 1) : 0;
+
+    if (isOverloaded && (active < m_MaximumThreads))
+    {
+        std::cout << "[INFO] : Scaling dispatcher up to " << (active + 1)
+                  << " threads (queue delay " << queueDelay << " ns, utilisation "
+                  << utilisation << "%)\n";
+        LaunchThread();
+        m_ScaleUps.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if ((m_QuietIntervals >= DISPATCHER_SCALE_DOWN_HYSTERESIS) && (active > m_MinimumThreads))
+    {
+        std::cout << "[INFO] : Scaling dispatcher down to " << (active - 1)
+                  << " threads (queue delay " << queueDelay << " ns, utilisation "
+                  << utilisation << "%)\n";
+        m_ActiveThreads.fetch_sub(1, std::memory_order_relaxed);
+        m_RetireRequests.fetch_add(1, std::memory_order_relaxed);
+        m_ThreadsGauge.store(static_cast<int64_t>(active - 1), std::memory_order_relaxed);
+        m_ScaleDowns.fetch_add(1, std::memory_order_relaxed);
+        m_QuietIntervals = 0;
+    }
+
+    ArmScalingTimer();
+}
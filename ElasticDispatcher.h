@@ -0,0 +1,156 @@
+/***********************************************************************
+* @file      ElasticDispatcher.h
+*
+* Elastic pool of dispatcher threads running the one io_context, whose
+* thread count is adjusted between configured bounds according to the
+* measured queue latency and utilisation.
+*
+* @brief    Every DISPATCHER_SCALING_INTERVAL_MILLISECONDS a scaling timer
+*           expires on the io_context itself. How late its completion
+*           handler runs is the queueing delay any other handler would
+*           have suffered too. Each dispatcher thread furthermore accounts
+*           for the time it spends executing handlers (busy) versus waiting
+*           upon the reactor (idle), from which utilisation is derived.
+*           Busy time is that of the handler invocations themselves, as
+*           timed by HandlerTracking.h, whether they were run by poll_one()
+*           or from within the blocking run_one_for().
+*
+*           - Queue delay or utilisation above the scale-up thresholds
+*             immediately adds one thread, up to the maximum.
+*
+*           - Queue delay and utilisation below the scale-down thresholds
+*             for DISPATCHER_SCALE_DOWN_HYSTERESIS consecutive intervals
+*             retires one thread, down to the minimum.
+*
+*           Retired threads finish the handler they are executing, if any,
+*           exit of their own accord, and are then joined by the scaling
+*           handler. Their ingest rings are released as they exit.
+*
+*           Each thread holds the lowest worker index not held by another
+*           live thread, and is named Dispatcher_<index> after it, so that
+*           per-worker accounting stays keyed by a stable, bounded index
+*           however often threads come and go.
+*
+* @note     All decisions are logged, and exposed through Metrics.h:
+*
+*           dispatcher.threads, dispatcher.utilisation_pct,
+*           dispatcher.queue_delay_ns, dispatcher.scale_ups,
+*           dispatcher.scale_downs
+*
+*           As is per-worker accounting, by worker index:
+*
+*           dispatcher.worker.<index>.busy_ns         - Executing handlers.
+*           dispatcher.worker.<index>.wait_ns         - Waiting upon the reactor.
+*           dispatcher.worker.<index>.handlers        - Handlers executed.
+*           dispatcher.worker.<index>.cpu_ns          - CLOCK_THREAD_CPUTIME_ID.
+*           dispatcher.worker.<index>.utilisation_pct - Busy over the last
+*                                                       scaling interval.
+*
+* @warning  With more than one dispatcher thread there is no longer an
+*           "implicit strand"; every handler must be thread-safe.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <time.h>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+
+class ElasticDispatcher
+{
+    struct WorkerMetrics_t
+    {
+        Metrics::Counter_t*    m_pBusyNanoseconds;
+        Metrics::Counter_t*    m_pWaitNanoseconds;
+        Metrics::Counter_t*    m_pHandlers;
+        Metrics::Counter_t*    m_pCpuNanoseconds;
+        Metrics::Gauge_t*      m_pUtilisation;
+        uint64_t               m_LastBusyNanoseconds; // Scaling timer only.
+    };
+
+    struct Worker_t
+    {
+        std::thread            m_Thread;
+        std::atomic<bool>      m_HasExited{false};
+        size_t                 m_Index{0};
+        WorkerMetrics_t*       m_pMetrics{nullptr};
+        clockid_t              m_CpuClock{CLOCK_THREAD_CPUTIME_ID};
+        bool                   m_HasCpuClock{false};
+
+        // CPU time already accounted for, by whichever thread got there first.
+        std::atomic<uint64_t>  m_AccountedCpuNanoseconds{0};
+    };
+
+public:
+    ElasticDispatcher(asio::io_context& ioContext,
+                      const size_t& minimumThreads, const size_t& maximumThreads);
+    virtual ~ElasticDispatcher();
+
+    ElasticDispatcher(const ElasticDispatcher&) = delete;
+    ElasticDispatcher& operator=(const ElasticDispatcher&) = delete;
+
+    // Launches the minimum number of threads and arms the scaling timer.
+    void Start();
+
+    // Blocks until the io_context has been stopped and ALL dispatcher
+    // threads, including any launched in the meantime, have exited.
+    void Join();
+
+    size_t NumberOfThreads() const;
+
+protected:
+    void WorkerThread(Worker_t* pWorker);
+    void LaunchThread();
+    size_t LowestFreeWorkerIndex() const;
+    WorkerMetrics_t& MetricsOfWorker(const size_t& index);
+    void AccountCpuTime(Worker_t& worker, const uint64_t& cpuNanoseconds);
+    void AccountWorkers(const uint64_t& elapsedNanoseconds);
+    void ReapRetiredThreads();
+    bool ShouldRetire();
+
+    void ArmScalingTimer();
+    void OnScalingTimer(const std::error_code& error);
+
+private:
+    asio::io_context&                        m_TheIOContext;
+    const size_t                             m_MinimumThreads;
+    const size_t                             m_MaximumThreads;
+
+    mutable std::mutex                       m_WorkersMutex;
+    std::list<std::unique_ptr<Worker_t>>     m_Workers;
+
+    // Those yet to exit; unlike m_Workers, not emptied by Join().
+    std::vector<Worker_t*>                   m_RunningWorkers;
+
+    // Threads still running minus those asked to retire.
+    std::atomic<size_t>                      m_ActiveThreads;
+    std::atomic<size_t>                      m_RetireRequests;
+
+    alignas(64) std::atomic<uint64_t>        m_BusyNanoseconds;
+
+    asio::steady_timer                       m_ScalingTimer;
+    SteadyClock_t::time_point                m_LastScalingTime;
+    uint64_t                                 m_LastBusyNanoseconds;
+    size_t                                   m_QuietIntervals;
+
+    Metrics::Gauge_t&                        m_ThreadsGauge;
+    Metrics::Gauge_t&                        m_UtilisationGauge;
+    Metrics::Histogram_t&                    m_QueueDelay;
+    Metrics::Counter_t&                      m_ScaleUps;
+    Metrics::Counter_t&                      m_ScaleDowns;
+
+    // By worker index. Grown (under m_WorkersMutex) should retiring
+    // threads linger on beyond the maximum; a deque keeps the addresses
+    // that the threads hold on to valid.
+    std::deque<WorkerMetrics_t>              m_WorkerMetrics;
+};
@@ -0,0 +1,236 @@
+/***********************************************************************
+* @file      EpochReclamation.h
+*
+* Epoch-based memory reclamation (EBR) so that lock-free writers may
+* unlink objects which concurrent readers might still be looking at,
+* and have those objects safely deleted once no reader is left.
+*
+* @brief    Readers pin the domain for the (short) duration of their read
+*           by announcing the global epoch they observed in one of a fixed
+*           number of participant slots. Writers unlink an object first
+*           and then retire it, stamping it with the epoch at retirement
+*           whilst advancing the global epoch. A retired object is freed
+*           only once every pinned reader has announced a later epoch,
+*           i.e. once no reader can possibly still hold a pointer to it.
+*
+* @note     Readers never block writers and writers never block readers.
+*           Retirement is a lock-free push onto a Treiber stack; only
+*           one thread at a time (whoever wins a try-lock flag) walks the
+*           retired list to reclaim, and nobody ever waits on that flag.
+*
+* @warning  Do NOT hold a ReadGuard_t across a blocking call or across
+*           an asynchronous operation; a long-lived pin merely delays
+*           reclamation but it does so for every retired object.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <limits>
+#include <functional>
+
+namespace Utility
+{
+    class EpochDomain
+    {
+        // Enough for every dispatcher thread plus the display, query and
+        // exporter readers. Surplus readers merely yield until a slot frees.
+        static constexpr size_t MAXIMUM_PARTICIPANTS = 64;
+
+        // A free participant slot announces this epoch. Epochs start at 1.
+        static constexpr uint64_t UNPINNED = 0;
+
+        struct RetiredNode_t
+        {
+            void*           m_pObject;
+            void          (*m_Deleter)(void*);
+            uint64_t        m_RetireEpoch;
+            RetiredNode_t*  m_pNext;
+        };
+
+        struct alignas(64) Participant_t // One cache line each; no false sharing.
+        {
+            std::atomic<uint64_t>  m_AnnouncedEpoch{UNPINNED};
+        };
+
+    public:
+        class ReadGuard_t
+        {
+        public:
+            explicit ReadGuard_t(EpochDomain& domain)
+                : m_pSlot(domain.Pin())
+            {
+            }
+
+            ~ReadGuard_t()
+            {
+                m_pSlot->m_AnnouncedEpoch.store(UNPINNED, std::memory_order_release);
+            }
+
+            ReadGuard_t(const ReadGuard_t&) = delete;
+            ReadGuard_t& operator=(const ReadGuard_t&) = delete;
+
+        private:
+            Participant_t*  m_pSlot;
+        };
+
+        EpochDomain()
+            : m_GlobalEpoch(1)
+            , m_pRetiredHead(nullptr)
+            , m_IsReclaiming(false)
+            , m_RetiredCount(0)
+            , m_ReclaimedCount(0)
+        {
+        }
+
+        ~EpochDomain()
+        {
+            // No reader may outlive the domain, thus everything goes.
+            FreeList(m_pRetiredHead.exchange(nullptr), std::numeric_limits<uint64_t>::max());
+        }
+
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        // The caller MUST have already unlinked pObject such that no new
+        // reader can reach it.
+        template <typename T>
+        void Retire(T* pObject)
+        {
+            auto pNode = new RetiredNode_t{pObject,
+                                           [](void* p) { delete static_cast<T*>(p); },
+                                           m_GlobalEpoch.fetch_add(1, std::memory_order_seq_cst),
+                                           nullptr};
+
+            pNode->m_pNext = m_pRetiredHead.load(std::memory_order_relaxed);
+            while (!m_pRetiredHead.compare_exchange_weak(pNode->m_pNext, pNode,
+                                                         std::memory_order_release,
+                                                         std::memory_order_relaxed))
+            {
+            }
+            m_RetiredCount.fetch_add(1, std::memory_order_relaxed);
+
+            TryReclaim();
+        }
+
+        // Opportunistically free whatever no reader can still observe.
+        // Non-blocking; returns immediately should another thread already
+        // be reclaiming.
+        void TryReclaim()
+        {
+            if (m_IsReclaiming.exchange(true, std::memory_order_acquire))
+            {
+                return;
+            }
+
+            auto pList = m_pRetiredHead.exchange(nullptr, std::memory_order_acquire);
+            if (pList != nullptr)
+            {
+                FreeList(pList, OldestPinnedEpoch());
+            }
+
+            m_IsReclaiming.store(false, std::memory_order_release);
+        }
+
+        uint64_t RetiredCount() const
+        {
+            return m_RetiredCount.load(std::memory_order_relaxed);
+        }
+
+        uint64_t ReclaimedCount() const
+        {
+            return m_ReclaimedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        Participant_t* Pin()
+        {
+            // Each thread remembers the slot it last used so that, in
+            // the steady state, pinning is one uncontended CAS.
+            static thread_local size_t ts_SlotHint =
+                std::hash<std::thread::id>{}(std::this_thread::get_id()) % MAXIMUM_PARTICIPANTS;
+
+            while (true)
+            {
+                for (size_t i = 0; i < MAXIMUM_PARTICIPANTS; i++)
+                {
+                    auto& slot = m_Participants[(ts_SlotHint + i) % MAXIMUM_PARTICIPANTS];
+                    uint64_t expected = UNPINNED;
+
+                    // Announcing an epoch that has since moved on is merely
+                    // conservative; it can only delay reclamation.
+                    if (slot.m_AnnouncedEpoch.compare_exchange_strong(expected,
+                            m_GlobalEpoch.load(std::memory_order_seq_cst),
+                            std::memory_order_seq_cst))
+                    {
+                        ts_SlotHint = (ts_SlotHint + i) % MAXIMUM_PARTICIPANTS;
+
+                        // Order the announcement before any subsequent load
+                        // of a protected pointer (pairs with Retire()).
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        return &slot;
+                    }
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        uint64_t OldestPinnedEpoch() const
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            auto oldest = std::numeric_limits<uint64_t>::max();
+            for (const auto& slot : m_Participants)
+            {
+                auto epoch = slot.m_AnnouncedEpoch.load(std::memory_order_seq_cst);
+                if ((epoch != UNPINNED) && (epoch < oldest))
+                {
+                    oldest = epoch;
+                }
+            }
+            return oldest;
+        }
+
+        // Frees every node retired strictly before oldestPinnedEpoch and
+        // pushes the survivors back for a later attempt.
+        void FreeList(RetiredNode_t* pList, const uint64_t& oldestPinnedEpoch)
+        {
+            while (pList != nullptr)
+            {
+                auto pNext = pList->m_pNext;
+
+                if (pList->m_RetireEpoch < oldestPinnedEpoch)
+                {
+                    pList->m_Deleter(pList->m_pObject);
+                    delete pList;
+                    m_ReclaimedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    pList->m_pNext = m_pRetiredHead.load(std::memory_order_relaxed);
+                    while (!m_pRetiredHead.compare_exchange_weak(pList->m_pNext, pList,
+                                                                 std::memory_order_release,
+                                                                 std::memory_order_relaxed))
+                    {
+                    }
+                }
+
+                pList = pNext;
+            }
+        }
+
+        std::array<Participant_t, MAXIMUM_PARTICIPANTS>  m_Participants;
+        alignas(64) std::atomic<uint64_t>                m_GlobalEpoch;
+        alignas(64) std::atomic<RetiredNode_t*>          m_pRetiredHead;
+        std::atomic<bool>                                m_IsReclaiming;
+        std::atomic<uint64_t>                            m_RetiredCount;
+        std::atomic<uint64_t>                            m_ReclaimedCount;
+    };
+}
@@ -0,0 +1,344 @@
+#include "FlightRecorder.h"
+#include "Metrics.h"
+
+#include <array>
+#include <mutex>
+#include <cstring>
+#include <charconv>
+#include <fcntl.h>
+#include <signal.h>
+
+namespace FlightRecorder
+{
+    namespace
+    {
+        static_assert((FLIGHT_RECORDER_EVENTS_PER_THREAD & (FLIGHT_RECORDER_EVENTS_PER_THREAD - 1)) == 0,
+                      "FLIGHT_RECORDER_EVENTS_PER_THREAD must be a power of 2");
+
+        struct Entry_t
+        {
+            uint64_t  m_StartTicks;
+            uint64_t  m_EndTicks;
+            uint32_t  m_Argument;
+            Event_t   m_Event;
+        };
+
+        struct ThreadRing_t
+        {
+            // Cleared when the owning thread exits, so that the ring may
+            // be reused by a later thread.
+            std::atomic<bool>                                        m_IsInUse{true};
+            std::atomic<uint64_t>                                    m_Head{0};
+            pid_t                                                    m_ThreadId{0};
+            char                                                     m_ThreadName[Utility::THREAD_NAME_LENGTH]{};
+            std::array<Entry_t, FLIGHT_RECORDER_EVENTS_PER_THREAD>   m_Entries{};
+        };
+
+        struct EventName_t
+        {
+            std::string_view  m_Name;
+            std::string_view  m_ArgumentName;
+        };
+
+        constexpr std::array<EventName_t, NUMBER_OF_EVENT_TYPES> EVENT_NAMES =
+        {{
+            {"connect",   "sensor"},
+            {"receive",   "readings"},
+            {"parse",     "sensor"},
+            {"aggregate", "records"},
+            {"publish",   "sensors"},
+        }};
+
+        // A fixed array rather than a vector, so that the signal handler
+        // may walk it without locking.
+        std::array<std::atomic<ThreadRing_t*>, FLIGHT_RECORDER_MAXIMUM_THREADS>  g_Rings{};
+        std::atomic<size_t>                                                      g_NumberOfRings{0};
+        std::mutex                                                               g_RingsMutex;
+
+        // Ticks to nanoseconds calibration reference.
+        const uint64_t                    g_BaseTicks = ReadTicks();
+        const SteadyClock_t::time_point   g_BaseTime  = SteadyClock_t::now();
+
+        char g_FatalTracePath[PATH_MAX]{};
+
+        ThreadRing_t* ClaimRing()
+        {
+            std::unique_lock<std::mutex> lock(g_RingsMutex);
+
+            ThreadRing_t* pRing = nullptr;
+            auto numberOfRings = g_NumberOfRings.load(std::memory_order_relaxed);
+
+            for (size_t i = 0; (pRing == nullptr) && (i < numberOfRings); i++)
+            {
+                auto pCandidate = g_Rings[i].load(std::memory_order_relaxed);
+                bool isInUse = false;
+                if (pCandidate->m_IsInUse.compare_exchange_strong(isInUse, true))
+                {
+                    // The previous owner's events would otherwise be
+                    // attributed to this thread.
+                    pCandidate->m_Head.store(0, std::memory_order_release);
+                    pRing = pCandidate;
+                }
+            }
+
+            if ((pRing == nullptr) && (numberOfRings < g_Rings.size()))
+            {
+                pRing = new ThreadRing_t();
+                g_Rings[numberOfRings].store(pRing, std::memory_order_release);
+                g_NumberOfRings.store(numberOfRings + 1, std::memory_order_release);
+            }
+
+            if (pRing == nullptr)
+            {
+                static auto& s_UnrecordedThreads = Metrics::Counter("flightrecorder.unrecorded_threads");
+                s_UnrecordedThreads.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            pRing->m_ThreadId = static_cast<pid_t>(gettid());
+            Utility::GetThreadName(pRing->m_ThreadName, sizeof(pRing->m_ThreadName));
+            return pRing;
+        }
+
+        // Releases this thread's ring for reuse when the thread exits.
+        struct RingClaim_t
+        {
+            ThreadRing_t*  m_pRing{ClaimRing()};
+
+            ~RingClaim_t()
+            {
+                if (m_pRing != nullptr)
+                {
+                    m_pRing->m_IsInUse.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        ThreadRing_t* RingOfThisThread()
+        {
+            static thread_local RingClaim_t ts_TheClaim;
+            return ts_TheClaim.m_pRing;
+        }
+
+        // Buffered, async-signal-safe writer; no allocation, no locks.
+        class TraceWriter_t
+        {
+        public:
+            explicit TraceWriter_t(const int& fileDescriptor)
+                : m_FileDescriptor(fileDescriptor)
+                , m_Length(0)
+                , m_IsFailed(false)
+            {
+            }
+
+            ~TraceWriter_t()
+            {
+                Flush();
+            }
+
+            TraceWriter_t& operator<<(const std::string_view& text)
+            {
+                for (auto character : text)
+                {
+                    if (m_Length == m_Buffer.size())
+                    {
+                        Flush();
+                    }
+                    m_Buffer[m_Length++] = character;
+                }
+                return *this;
+            }
+
+            TraceWriter_t& operator<<(const uint64_t& value)
+            {
+                char digits[24];
+                auto [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+                return *this << std::string_view(digits, static_cast<size_t>(ptr - digits));
+            }
+
+            // Nanoseconds as microseconds with 3 decimals, as Chrome wants.
+            void WriteMicroseconds(const uint64_t& nanoseconds)
+            {
+                char fraction[4] = {'.',
+                                    static_cast<char>('0' + ((nanoseconds / 100) % 10)),
+                                    static_cast<char>('0' + ((nanoseconds / 10) % 10)),
+                                    static_cast<char>('0' + (nanoseconds % 10))};
+                *this << (nanoseconds / 1000) << std::string_view(fraction, sizeof(fraction));
+            }
+
+            void Flush()
+            {
+                size_t written = 0;
+                while (!m_IsFailed && (written < m_Length))
+                {
+                    auto result = ::write(m_FileDescriptor, m_Buffer.data() + written, m_Length - written);
+                    if (result > 0)
+                    {
+                        written += static_cast<size_t>(result);
+                    }
+                    else if ((result < 0) && (errno != EINTR))
+                    {
+                        m_IsFailed = true;
+                    }
+                }
+                m_Length = 0;
+            }
+
+            bool IsFailed() const
+            {
+                return m_IsFailed;
+            }
+
+        private:
+            int                    m_FileDescriptor;
+            std::array<char, 4096> m_Buffer;
+            size_t                 m_Length;
+            bool                   m_IsFailed;
+        };
+
+        void WriteThreadName(TraceWriter_t& writer, const uint64_t& processId,
+                             const ThreadRing_t& ring, bool& isFirst)
+        {
+            writer << (isFirst ? "\n" : ",\n")
+                   << R"({"name":"thread_name","ph":"M","pid":)" << processId
+                   << R"(,"tid":)" << static_cast<uint64_t>(ring.m_ThreadId)
+                   << R"(,"args":{"name":")"
+                   << std::string_view(ring.m_ThreadName, ::strnlen(ring.m_ThreadName, sizeof(ring.m_ThreadName)))
+                   << R"("}})";
+            isFirst = false;
+        }
+
+        void WriteEntry(TraceWriter_t& writer, const uint64_t& processId, const ThreadRing_t& ring,
+                        const Entry_t& entry, const double& nanosecondsPerTick)
+        {
+            auto index = static_cast<size_t>(entry.m_Event);
+            if ((index >= EVENT_NAMES.size()) || (entry.m_StartTicks < g_BaseTicks)
+                || (entry.m_EndTicks < entry.m_StartTicks))
+            {
+                return; // Torn or predates calibration.
+            }
+
+            auto start = static_cast<uint64_t>(static_cast<double>(entry.m_StartTicks - g_BaseTicks) * nanosecondsPerTick);
+            auto duration = static_cast<uint64_t>(static_cast<double>(entry.m_EndTicks - entry.m_StartTicks) * nanosecondsPerTick);
+
+            writer << ",\n" << R"({"name":")" << EVENT_NAMES[index].m_Name
+                   << R"(","cat":"ingest","ph":"X","pid":)" << processId
+                   << R"(,"tid":)" << static_cast<uint64_t>(ring.m_ThreadId)
+                   << R"(,"ts":)";
+            writer.WriteMicroseconds(start);
+            writer << R"(,"dur":)";
+            writer.WriteMicroseconds(duration);
+            writer << R"(,"args":{")" << EVENT_NAMES[index].m_ArgumentName << R"(":)"
+                   << static_cast<uint64_t>(entry.m_Argument) << "}}";
+        }
+
+        void OnFatalSignal(int signalNumber)
+        {
+            DumpChromeTrace(g_FatalTracePath);
+
+            // SA_RESETHAND has restored the default action; re-raise so
+            // that we still terminate (and dump core) as we would have.
+            ::raise(signalNumber);
+        }
+    }
+
+    void Record(const Event_t& event, const uint64_t& startTicks, const uint32_t& argument)
+    {
+        auto pRing = RingOfThisThread();
+        if (pRing == nullptr)
+        {
+            return;
+        }
+
+        // Single writer per ring; the release store publishes the entry.
+        auto head = pRing->m_Head.load(std::memory_order_relaxed);
+        pRing->m_Entries[head & (FLIGHT_RECORDER_EVENTS_PER_THREAD - 1)] =
+            {startTicks, ReadTicks(), argument, event};
+        pRing->m_Head.store(head + 1, std::memory_order_release);
+    }
+
+    bool DumpChromeTrace(const std::string_view& path)
+    {
+        char pathName[PATH_MAX];
+        if (path.empty() || (path.size() >= sizeof(pathName)))
+        {
+            return false;
+        }
+        std::memcpy(pathName, path.data(), path.size());
+        pathName[path.size()] = '\0';
+
+        auto fileDescriptor = ::open(pathName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        // Calibrate the TSC against the steady clock over our lifetime.
+        auto elapsedTicks = ReadTicks() - g_BaseTicks;
+        auto elapsedNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      SteadyClock_t::now() - g_BaseTime).count();
+        auto nanosecondsPerTick = ((elapsedTicks > 0) && (elapsedNanoseconds > 0))
+                                ? (static_cast<double>(elapsedNanoseconds) / static_cast<double>(elapsedTicks))
+                                : 1.0;
+
+        auto processId = static_cast<uint64_t>(::getpid());
+        bool isFailed = false;
+        {
+            TraceWriter_t writer(fileDescriptor);
+            bool isFirst = true;
+
+            writer << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+            auto numberOfRings = g_NumberOfRings.load(std::memory_order_acquire);
+            for (size_t i = 0; i < numberOfRings; i++)
+            {
+                auto pRing = g_Rings[i].load(std::memory_order_acquire);
+                if (pRing == nullptr)
+                {
+                    continue;
+                }
+
+                WriteThreadName(writer, processId, *pRing, isFirst);
+
+                auto head = pRing->m_Head.load(std::memory_order_acquire);
+                auto first = (head > FLIGHT_RECORDER_EVENTS_PER_THREAD)
+                           ? (head - FLIGHT_RECORDER_EVENTS_PER_THREAD) : 0;
+
+                for (auto index = first; index < head; index++)
+                {
+                    WriteEntry(writer, processId, *pRing,
+                               pRing->m_Entries[index & (FLIGHT_RECORDER_EVENTS_PER_THREAD - 1)],
+                               nanosecondsPerTick);
+                }
+            }
+
+            writer << "\n]}\n";
+            writer.Flush();
+            isFailed = writer.IsFailed();
+        }
+
+        ::close(fileDescriptor);
+        return !isFailed;
+    }
+
+    void InstallFatalSignalHandlers(const std::string_view& path)
+    {
+        auto length = std::min(path.size(), sizeof(g_FatalTracePath) - 1);
+        std::memcpy(g_FatalTracePath, path.data(), length);
+        g_FatalTracePath[length] = '\0';
+
+        struct sigaction action{};
+        action.sa_handler = OnFatalSignal;
+        action.sa_flags = SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+
+        for (auto signalNumber : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT})
+        {
+            if (::sigaction(signalNumber, &action, nullptr) != 0)
+            {
+                std::cout << "[WARN] : Unable to install the flight recorder handler for signal "
+                          << signalNumber << "\n";
+            }
+        }
+    }
+}
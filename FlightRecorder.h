@@ -0,0 +1,113 @@
+/***********************************************************************
+* @file      FlightRecorder.h
+*
+* Always-on, low-overhead event tracer ("flight recorder") for the
+* ingest path, dumped as Chrome/Perfetto trace JSON after the fact.
+*
+* @brief    Every thread records its events into its own fixed-size ring
+*           of FLIGHT_RECORDER_EVENTS_PER_THREAD entries, overwriting the
+*           oldest. Recording an event is a handful of plain stores and one
+*           release store; no lock, no allocation, no system call. Events
+*           are timestamped with the TSC (the steady clock elsewhere than
+*           x86) and converted to microseconds only when dumped.
+*
+*           @code
+*           {
+*               FlightRecorder::Span_t span(FlightRecorder::Event_t::PARSE, sensorNodeNumber);
+*               ...
+*           } // Recorded here, with its start time and duration.
+*           @endcode
+*
+*           The rings are dumped, as one "complete" event per entry, to
+*           FLIGHT_RECORDER_TRACE_PATH:
+*
+*           - On demand, upon SIGUSR1 or the query API "TRACE" request.
+*           - On a fatal signal (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT),
+*             once InstallFatalSignalHandlers() has been called.
+*
+*           Load the file in chrome://tracing or https://ui.perfetto.dev.
+*
+* @note     Dumping is async-signal-safe: open(2), write(2) and close(2)
+*           over a stack buffer, with neither locks nor allocation.
+*
+* @warning  Rings are read whilst their threads may still be recording, so
+*           the oldest few events of a busy thread may be torn in a dump.
+*           Threads beyond FLIGHT_RECORDER_MAXIMUM_THREADS (alive at once)
+*           go unrecorded; see flightrecorder.unrecorded_threads.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include "CommonDefinitions.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace FlightRecorder
+{
+    enum class Event_t : uint8_t
+    {
+        CONNECT   = 0, // Connection establishment, per sensor.
+        RECEIVE   = 1, // Receive completion or readable-socket sweep.
+        PARSE     = 2, // Parsing of one reading, per sensor.
+        AGGREGATE = 3, // Application of a batch to the sensor table.
+        PUBLISH   = 4, // Display of the average temperature.
+    };
+
+    static constexpr size_t NUMBER_OF_EVENT_TYPES = 5;
+
+    inline uint64_t ReadTicks() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(SteadyClock_t::now().time_since_epoch().count());
+#endif
+    }
+
+    // Records one event of this thread, from startTicks until now.
+    void Record(const Event_t& event, const uint64_t& startTicks, const uint32_t& argument);
+
+    class Span_t
+    {
+    public:
+        explicit Span_t(const Event_t& event, const uint32_t& argument = 0) noexcept
+            : m_Event(event)
+            , m_Argument(argument)
+            , m_StartTicks(ReadTicks())
+        {
+        }
+
+        ~Span_t()
+        {
+            Record(m_Event, m_StartTicks, m_Argument);
+        }
+
+        Span_t(const Span_t&) = delete;
+        Span_t& operator=(const Span_t&) = delete;
+
+        // For arguments only known by the end of the span.
+        void SetArgument(const uint32_t& argument) noexcept
+        {
+            m_Argument = argument;
+        }
+
+    private:
+        Event_t   m_Event;
+        uint32_t  m_Argument;
+        uint64_t  m_StartTicks;
+    };
+
+    // Async-signal-safe. Returns false if the file could not be written.
+    bool DumpChromeTrace(const std::string_view& path);
+
+    // Dump to path upon any fatal signal, before the default action.
+    void InstallFatalSignalHandlers(const std::string_view& path);
+}
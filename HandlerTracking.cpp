@@ -0,0 +1,58 @@
+#include "HandlerTracking.h"
+#include "Metrics.h"
+
+#include <array>
+#include <string>
+
+namespace
+{
+    constexpr std::array<const char*, NUMBER_OF_HANDLER_TYPES> HANDLER_TYPE_NAMES =
+    {
+        "other", "receive", "send", "connect", "accept", "timer", "signal",
+        "resolve", "post", "alert", "bulk", "query", "reconnect", "display", "control"
+    };
+
+    struct HandlerHistograms_t
+    {
+        HandlerHistograms_t()
+        {
+            for (size_t i = 0; i < NUMBER_OF_HANDLER_TYPES; i++)
+            {
+                auto prefix = std::string("handler.") + HANDLER_TYPE_NAMES[i];
+                m_QueueWaits[i] = &Metrics::Histogram(prefix + ".queue_wait_ns");
+                m_Executions[i] = &Metrics::Histogram(prefix + ".execution_ns");
+            }
+        }
+
+        std::array<Metrics::Histogram_t*, NUMBER_OF_HANDLER_TYPES>  m_QueueWaits;
+        std::array<Metrics::Histogram_t*, NUMBER_OF_HANDLER_TYPES>  m_Executions;
+    };
+
+    // Function-local static, as handlers may well run during static
+    // initialization of other translation units.
+    const HandlerHistograms_t& TheHistograms()
+    {
+        static const HandlerHistograms_t s_TheHistograms;
+        return s_TheHistograms;
+    }
+}
+
+const char* HandlerTracking::NameOf(const HandlerType_t& type) noexcept
+{
+    auto index = static_cast<size_t>(type);
+    return (index < HANDLER_TYPE_NAMES.size()) ? HANDLER_TYPE_NAMES[index] : "unknown";
+}
+
+void HandlerTracking::Record(const HandlerType_t& type, const bool& isReady,
+                             const uint64_t& queueWaitNanoseconds,
+                             const uint64_t& executionNanoseconds) noexcept
+{
+    const auto& histograms = TheHistograms();
+    auto index = static_cast<size_t>(type);
+
+    if (isReady)
+    {
+        histograms.m_QueueWaits[index]->Record(queueWaitNanoseconds);
+    }
+    histograms.m_Executions[index]->Record(executionNanoseconds);
+}
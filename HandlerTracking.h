@@ -0,0 +1,365 @@
+/***********************************************************************
+* @file      HandlerTracking.h
+*
+* Custom ASIO handler tracking (ASIO_CUSTOM_HANDLER_TRACKING) feeding
+* per-handler-type latency histograms, instead of the text log that
+* ASIO_ENABLE_HANDLER_TRACKING writes for every single handler.
+*
+* @brief    ASIO includes this header from within its own, and calls into
+*           it upon the creation, readiness and invocation of every handler.
+*           For each handler type we record, into Metrics.h histograms:
+*
+*           handler.<type>.queue_wait_ns  - From the handler being ready to
+*                                           run (its socket having been
+*                                           serviced by the reactor, or its
+*                                           being posted) to its invocation.
+*           handler.<type>.execution_ns   - Duration of its invocation.
+*
+*           Types are classified from ASIO's object and operation names:
+*           receive, send, connect, accept, timer, signal, resolve, post.
+*
+*           Handlers that are scheduled through the PriorityScheduler run
+*           inside one of its "post" tokens, which it relabels by priority
+*           class (alert, bulk, query, reconnect, display, control) and by the
+*           time at which the handler itself was submitted; see
+*           RelabelCurrentHandler(). Readings are thus measured as "bulk"
+*           and the readout display as "display".
+*
+*           Threads that publish an Activity_t (see PublishActivity()) have
+*           the type and start time of their outermost handler invocation
+*           kept up to date therein, for HandlerWatchdog.h to observe, as
+*           well as the total time spent in such invocations, for
+*           ElasticDispatcher.h to account busy time by.
+*
+* @note     Enabled in meson.build with:
+*
+*           -DASIO_CUSTOM_HANDLER_TRACKING="HandlerTracking.h"
+*
+*           The cost is three steady clock reads and two relaxed histogram
+*           updates per handler; cheap enough to leave on in production.
+*
+* @warning  Included from deep within ASIO; hence never include ASIO, nor
+*           anything that does, from here. Queue wait is not recorded for
+*           timers, signals and socket readiness waits (async_wait), whose
+*           readiness ASIO does not report.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+enum class HandlerType_t : uint8_t
+{
+    OTHER     = 0,
+    RECEIVE   = 1,
+    SEND      = 2,
+    CONNECT   = 3,
+    ACCEPT    = 4,
+    TIMER     = 5,
+    SIGNAL    = 6,
+    RESOLVE   = 7,
+    POST      = 8,
+
+    // PriorityScheduler classes; see PriorityExecutor.h.
+    ALERT     = 9,
+    BULK      = 10,
+    QUERY     = 11,
+    RECONNECT = 12,
+    DISPLAY   = 13,
+    CONTROL   = 14,
+};
+
+static constexpr size_t NUMBER_OF_HANDLER_TYPES = 15;
+
+class HandlerTracking
+{
+public:
+    // Inherited by every ASIO operation; fields are mutable as ASIO only
+    // hands us const references upon reactor readiness.
+    struct TrackedHandler_t
+    {
+        mutable uint64_t       m_QueuedSinceNanoseconds{0};
+        mutable HandlerType_t  m_Type{HandlerType_t::OTHER};
+        mutable bool           m_IsReady{false};
+    };
+
+    // What a thread is currently executing, as observed by other threads.
+    struct Activity_t
+    {
+        std::atomic<uint64_t>       m_BusySinceNanoseconds{0}; // 0 whilst idle.
+        std::atomic<HandlerType_t>  m_Type{HandlerType_t::OTHER};
+        std::atomic<uint64_t>       m_Invocations{0};
+        std::atomic<uint64_t>       m_BusyNanoseconds{0};      // Outermost invocations, in total.
+    };
+
+    class Completion_t
+    {
+    public:
+        explicit Completion_t(const TrackedHandler_t& handler) noexcept
+            : m_Type(handler.m_Type)
+            , m_IsReady(handler.m_IsReady)
+            , m_QueuedSinceNanoseconds(handler.m_QueuedSinceNanoseconds)
+            , m_StartNanoseconds(0)
+            , m_pPrevious(nullptr)
+        {
+        }
+
+        ~Completion_t()
+        {
+            // Invocation threw; still account for it.
+            if (m_StartNanoseconds != 0)
+            {
+                InvocationEnd();
+            }
+        }
+
+        Completion_t(const Completion_t&) = delete;
+        Completion_t& operator=(const Completion_t&) = delete;
+
+        template <typename... Args>
+        void InvocationBegin(Args&&...) noexcept
+        {
+            m_StartNanoseconds = NowNanoseconds();
+            m_pPrevious = ts_pCurrentCompletion;
+            ts_pCurrentCompletion = this;
+
+            if (ts_pActivity != nullptr)
+            {
+                ts_pActivity->m_Type.store(m_Type, std::memory_order_relaxed);
+                if (m_pPrevious == nullptr)
+                {
+                    ts_pActivity->m_Invocations.fetch_add(1, std::memory_order_relaxed);
+                    ts_pActivity->m_BusySinceNanoseconds.store(m_StartNanoseconds, std::memory_order_release);
+                }
+            }
+        }
+
+        void InvocationEnd() noexcept;
+
+    private:
+        friend class HandlerTracking;
+
+        HandlerType_t   m_Type;
+        bool            m_IsReady;
+        uint64_t        m_QueuedSinceNanoseconds;
+        uint64_t        m_StartNanoseconds;
+        Completion_t*   m_pPrevious;
+    };
+
+    static void Init() noexcept
+    {
+    }
+
+    static void Location(const char* fileName, int line, const char* functionName) noexcept
+    {
+    }
+
+    template <typename Context>
+    static void Creation(Context& context, TrackedHandler_t& handler,
+                         const char* objectType, void* object,
+                         uintmax_t nativeHandle, const char* operationName) noexcept
+    {
+        handler.m_Type = Classify(objectType, operationName);
+        handler.m_QueuedSinceNanoseconds = NowNanoseconds();
+
+        // Posted handlers are ready to run as of now.
+        handler.m_IsReady = (handler.m_Type == HandlerType_t::POST);
+    }
+
+    template <typename Context>
+    static void Operation(Context& context, const char* objectType, void* object,
+                          uintmax_t nativeHandle, const char* operationName) noexcept
+    {
+    }
+
+    template <typename Context>
+    static void ReactorRegistration(Context& context, uintmax_t nativeHandle,
+                                    uintmax_t registration) noexcept
+    {
+    }
+
+    template <typename Context>
+    static void ReactorDeregistration(Context& context, uintmax_t nativeHandle,
+                                      uintmax_t registration) noexcept
+    {
+    }
+
+    template <typename Context>
+    static void ReactorEvents(Context& context, uintmax_t registration,
+                              unsigned events) noexcept
+    {
+    }
+
+    // The reactor performed the operation; it is ready to run.
+    template <typename... Args>
+    static void ReactorOperation(const TrackedHandler_t& handler,
+                                 const char* operationName, Args&&...) noexcept
+    {
+        handler.m_QueuedSinceNanoseconds = NowNanoseconds();
+        handler.m_IsReady = true;
+    }
+
+    // Attributes the handler being invoked on this thread to another type,
+    // queued since the given time. Has no effect outside of a tracked
+    // invocation, or when handler tracking is not compiled in.
+    static void RelabelCurrentHandler(const HandlerType_t& type,
+                                      const std::chrono::steady_clock::time_point& queuedSince) noexcept
+    {
+        if (ts_pCurrentCompletion != nullptr)
+        {
+            ts_pCurrentCompletion->m_Type = type;
+            ts_pCurrentCompletion->m_IsReady = true;
+            ts_pCurrentCompletion->m_QueuedSinceNanoseconds = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    queuedSince.time_since_epoch()).count());
+
+            if (ts_pActivity != nullptr)
+            {
+                ts_pActivity->m_Type.store(type, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Publishes this thread's activity from now on; nullptr to stop.
+    static void PublishActivity(Activity_t* pActivity) noexcept
+    {
+        ts_pActivity = pActivity;
+    }
+
+    static const char* NameOf(const HandlerType_t& type) noexcept;
+
+private:
+    static uint64_t NowNanoseconds() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static HandlerType_t Classify(const char* objectType, const char* operationName) noexcept
+    {
+        if (std::strcmp(objectType, "socket") == 0)
+        {
+            if (std::strstr(operationName, "connect") != nullptr)
+            {
+                return HandlerType_t::CONNECT;
+            }
+            if (std::strstr(operationName, "accept") != nullptr)
+            {
+                return HandlerType_t::ACCEPT;
+            }
+            if ((std::strstr(operationName, "send") != nullptr)
+                || (std::strstr(operationName, "write") != nullptr))
+            {
+                return HandlerType_t::SEND;
+            }
+            return HandlerType_t::RECEIVE; // Receives, reads and readiness waits.
+        }
+        if (std::strcmp(objectType, "deadline_timer") == 0)
+        {
+            return HandlerType_t::TIMER;
+        }
+        if (std::strcmp(objectType, "signal_set") == 0)
+        {
+            return HandlerType_t::SIGNAL;
+        }
+        if (std::strcmp(objectType, "resolver") == 0)
+        {
+            return HandlerType_t::RESOLVE;
+        }
+        if ((std::strcmp(objectType, "io_context") == 0)
+            || (std::strcmp(objectType, "thread_pool") == 0)
+            || (std::strstr(objectType, "strand") != nullptr))
+        {
+            return HandlerType_t::POST;
+        }
+        return HandlerType_t::OTHER;
+    }
+
+    static void Record(const HandlerType_t& type, const bool& isReady,
+                       const uint64_t& queueWaitNanoseconds,
+                       const uint64_t& executionNanoseconds) noexcept;
+
+    static inline thread_local Completion_t* ts_pCurrentCompletion = nullptr;
+    static inline thread_local Activity_t*   ts_pActivity = nullptr;
+};
+
+inline void HandlerTracking::Completion_t::InvocationEnd() noexcept
+{
+    auto endNanoseconds = NowNanoseconds();
+
+    auto queueWait = (m_StartNanoseconds > m_QueuedSinceNanoseconds)
+                   ? (m_StartNanoseconds - m_QueuedSinceNanoseconds) : 0;
+    HandlerTracking::Record(m_Type, m_IsReady, queueWait, endNanoseconds - m_StartNanoseconds);
+
+    if (ts_pActivity != nullptr)
+    {
+        if (m_pPrevious == nullptr)
+        {
+            ts_pActivity->m_BusySinceNanoseconds.store(0, std::memory_order_release);
+
+            // Written by this thread alone.
+            ts_pActivity->m_BusyNanoseconds.store(
+                ts_pActivity->m_BusyNanoseconds.load(std::memory_order_relaxed)
+                    + (endNanoseconds - m_StartNanoseconds),
+                std::memory_order_relaxed);
+        }
+        else
+        {
+            ts_pActivity->m_Type.store(m_pPrevious->m_Type, std::memory_order_relaxed);
+        }
+    }
+
+    ts_pCurrentCompletion = m_pPrevious;
+    m_StartNanoseconds = 0;
+}
+
+#if defined(ASIO_CUSTOM_HANDLER_TRACKING)
+# define ASIO_INHERIT_TRACKED_HANDLER \
+    : public ::HandlerTracking::TrackedHandler_t
+
+# define ASIO_ALSO_INHERIT_TRACKED_HANDLER \
+    , public ::HandlerTracking::TrackedHandler_t
+
+# define ASIO_HANDLER_TRACKING_INIT \
+    ::HandlerTracking::Init()
+
+# define ASIO_HANDLER_LOCATION(args) \
+    ::HandlerTracking::Location args
+
+# define ASIO_HANDLER_CREATION(args) \
+    ::HandlerTracking::Creation args
+
+# define ASIO_HANDLER_COMPLETION(args) \
+    ::HandlerTracking::Completion_t tracked_completion args
+
+# define ASIO_HANDLER_INVOCATION_BEGIN(args) \
+    tracked_completion.InvocationBegin args
+
+# define ASIO_HANDLER_INVOCATION_END \
+    tracked_completion.InvocationEnd()
+
+# define ASIO_HANDLER_OPERATION(args) \
+    ::HandlerTracking::Operation args
+
+# define ASIO_HANDLER_REACTOR_REGISTRATION(args) \
+    ::HandlerTracking::ReactorRegistration args
+
+# define ASIO_HANDLER_REACTOR_DEREGISTRATION(args) \
+    ::HandlerTracking::ReactorDeregistration args
+
+# define ASIO_HANDLER_REACTOR_READ_EVENT 1
+# define ASIO_HANDLER_REACTOR_WRITE_EVENT 2
+# define ASIO_HANDLER_REACTOR_ERROR_EVENT 4
+
+# define ASIO_HANDLER_REACTOR_EVENTS(args) \
+    ::HandlerTracking::ReactorEvents args
+
+# define ASIO_HANDLER_REACTOR_OPERATION(args) \
+    ::HandlerTracking::ReactorOperation args
+#endif
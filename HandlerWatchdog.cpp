@@ -0,0 +1,244 @@
+#include "HandlerWatchdog.h"
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <cstdlib>
+#include <cstring>
+#include <signal.h>
+#include <cxxabi.h>
+#include <execinfo.h>
+
+namespace
+{
+    std::mutex                                      g_WatchedThreadsMutex;
+    std::vector<HandlerWatchdog::WatchedThread_t*>  g_WatchedThreads;
+
+    // One capture at a time, by the watchdog thread; the signal handler
+    // only writes when it runs upon the thread that was asked.
+    std::array<void*, WATCHDOG_MAXIMUM_STACK_DEPTH>  g_CapturedFrames{};
+    std::atomic<int>                                 g_CapturedDepth{-1};
+    std::atomic<pid_t>                               g_CaptureThreadId{0};
+
+    // Our own frame and the kernel's signal trampoline.
+    constexpr int CAPTURE_FRAMES_TO_SKIP = 2;
+
+    constexpr auto CAPTURE_TIMEOUT = std::chrono::milliseconds(50);
+
+    void OnCaptureSignal(int signalNumber)
+    {
+        auto savedErrno = errno;
+        if (g_CaptureThreadId.load(std::memory_order_acquire) == static_cast<pid_t>(gettid()))
+        {
+            auto depth = ::backtrace(g_CapturedFrames.data(), static_cast<int>(g_CapturedFrames.size()));
+            g_CapturedDepth.store(depth, std::memory_order_release);
+        }
+        errno = savedErrno;
+    }
+
+    uint64_t NowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            SteadyClock_t::now().time_since_epoch()).count());
+    }
+
+    // "binary(mangled+0x1f) [0x4011d6]" to "binary(demangled+0x1f) [0x4011d6]".
+    std::string Demangle(const char* symbol)
+    {
+        std::string frame(symbol);
+        auto begin = frame.find('(');
+        auto end = frame.find('+', begin);
+        if ((begin == std::string::npos) || (end == std::string::npos) || (end == begin + 1))
+        {
+            return frame;
+        }
+
+        auto mangled = frame.substr(begin + 1, end - begin - 1);
+        int status = -1;
+        char* pDemangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        if ((status == 0) && (pDemangled != nullptr))
+        {
+            frame.replace(begin + 1, end - begin - 1, pDemangled);
+        }
+        std::free(pDemangled);
+        return frame;
+    }
+}
+
+HandlerWatchdog::WatchedThread_t::WatchedThread_t()
+    : m_Activity()
+    , m_ThreadId(static_cast<pid_t>(gettid()))
+    , m_ThreadName()
+    , m_LastReportedInvocation(0)
+{
+    Utility::GetThreadName(m_ThreadName, sizeof(m_ThreadName));
+    HandlerTracking::PublishActivity(&m_Activity);
+
+    std::unique_lock<std::mutex> lock(g_WatchedThreadsMutex);
+    g_WatchedThreads.push_back(this);
+}
+
+HandlerWatchdog::WatchedThread_t::~WatchedThread_t()
+{
+    HandlerTracking::PublishActivity(nullptr);
+
+    std::unique_lock<std::mutex> lock(g_WatchedThreadsMutex);
+    std::erase(g_WatchedThreads, this);
+}
+
+HandlerWatchdog::HandlerWatchdog(const std::chrono::milliseconds& budget,
+                                 const std::chrono::milliseconds& checkInterval)
+    : m_BudgetNanoseconds(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(budget).count()))
+    , m_CheckInterval(checkInterval)
+    , m_Thread()
+    , m_StopMutex()
+    , m_StopCondition()
+    , m_IsStopping(false)
+    , m_Overruns(Metrics::Counter("watchdog.overruns"))
+{
+}
+
+HandlerWatchdog::~HandlerWatchdog()
+{
+    Stop();
+}
+
+void HandlerWatchdog::Start()
+{
+#if !defined(ASIO_CUSTOM_HANDLER_TRACKING)
+    std::cout << "[WARN] : Handler tracking is not compiled in; the handler watchdog "
+              << "will see no handlers.\n";
+#endif
+
+    // backtrace() loads libgcc upon its first call, which must therefore
+    // not happen within the signal handler.
+    void* frame = nullptr;
+    ::backtrace(&frame, 1);
+
+    struct sigaction action{};
+    action.sa_handler = OnCaptureSignal;
+    action.sa_flags = SA_RESTART; // The blocked call carries on regardless.
+    sigemptyset(&action.sa_mask);
+    if (::sigaction(SIGRTMIN, &action, nullptr) != 0)
+    {
+        std::cout << "[WARN] : Unable to install the handler watchdog stack capture signal; "
+                  << std::strerror(errno) << "\n";
+    }
+
+    m_Thread = std::thread(&HandlerWatchdog::WatchdogThread, this);
+}
+
+void HandlerWatchdog::Stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_StopMutex);
+        m_IsStopping = true;
+    }
+    m_StopCondition.notify_all();
+
+    if (m_Thread.joinable())
+    {
+        m_Thread.join();
+    }
+}
+
+void HandlerWatchdog::WatchdogThread()
+{
+    Utility::SetThreadName("Watchdog");
+
+    std::unique_lock<std::mutex> lock(m_StopMutex);
+    while (!m_StopCondition.wait_for(lock, m_CheckInterval, [this]() { return m_IsStopping; }))
+    {
+        lock.unlock();
+        CheckWatchedThreads();
+        lock.lock();
+    }
+}
+
+void HandlerWatchdog::CheckWatchedThreads()
+{
+    std::optional<Overrun_t> overrun;
+
+    // Held just long enough to find an overrun, signal its thread and copy
+    // it out, so that no watched thread may exit and take its
+    // WatchedThread_t with it meanwhile. Waiting for the stack, which may
+    // take up to CAPTURE_TIMEOUT, and the report are done without it.
+    std::unique_lock<std::mutex> lock(g_WatchedThreadsMutex);
+
+    for (auto pWatched : g_WatchedThreads)
+    {
+        auto& activity = pWatched->m_Activity;
+        auto busySince = activity.m_BusySinceNanoseconds.load(std::memory_order_acquire);
+        auto invocation = activity.m_Invocations.load(std::memory_order_relaxed);
+        auto type = activity.m_Type.load(std::memory_order_relaxed);
+        auto timeNow = NowNanoseconds();
+
+        if ((busySince == 0) || (timeNow < busySince)
+            || (timeNow - busySince <= m_BudgetNanoseconds)
+            || (invocation == pWatched->m_LastReportedInvocation))
+        {
+            continue;
+        }
+
+        pWatched->m_LastReportedInvocation = invocation;
+
+        // Signalled whilst the overrun is confirmed, so that the stack is
+        // as close as may be to that of the blocked handler.
+        g_CapturedDepth.store(-1, std::memory_order_relaxed);
+        g_CaptureThreadId.store(pWatched->m_ThreadId, std::memory_order_release);
+        auto isSignalled = (::syscall(SYS_tgkill, ::getpid(), pWatched->m_ThreadId, SIGRTMIN) == 0);
+
+        overrun = Overrun_t{pWatched->m_ThreadId, {}, type, timeNow - busySince, isSignalled};
+        std::memcpy(overrun->m_ThreadName, pWatched->m_ThreadName, sizeof(overrun->m_ThreadName));
+
+        // One capture at a time; any other overrun is seen, as yet
+        // unreported, upon the next check.
+        break;
+    }
+
+    lock.unlock();
+
+    if (overrun)
+    {
+        ReportOverrun(*overrun);
+    }
+}
+
+void HandlerWatchdog::ReportOverrun(const Overrun_t& overrun)
+{
+    m_Overruns.fetch_add(1, std::memory_order_relaxed);
+    Metrics::Counter(std::string("watchdog.") + HandlerTracking::NameOf(overrun.m_Type) + ".overruns")
+        .fetch_add(1, std::memory_order_relaxed);
+
+    auto depth = -1;
+    if (overrun.m_IsSignalled)
+    {
+        auto deadline = SteadyClock_t::now() + CAPTURE_TIMEOUT;
+        while (((depth = g_CapturedDepth.load(std::memory_order_acquire)) < 0)
+               && (SteadyClock_t::now() < deadline))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    g_CaptureThreadId.store(0, std::memory_order_release);
+
+    std::cout << "[WARN] : Handler \"" << HandlerTracking::NameOf(overrun.m_Type) << "\" has blocked "
+              << overrun.m_ThreadName << " (" << overrun.m_ThreadId << ") for "
+              << (overrun.m_BlockedNanoseconds / 1000000) << " ms";
+
+    if (depth <= CAPTURE_FRAMES_TO_SKIP)
+    {
+        std::cout << "; its stack could not be captured.\n";
+        return;
+    }
+
+    std::cout << ":\n";
+    char** pSymbols = ::backtrace_symbols(g_CapturedFrames.data(), depth);
+    for (int i = CAPTURE_FRAMES_TO_SKIP; i < depth; i++)
+    {
+        std::cout << "    #" << (i - CAPTURE_FRAMES_TO_SKIP) << " "
+                  << ((pSymbols != nullptr) ? Demangle(pSymbols[i]) : std::string("?")) << "\n";
+    }
+    std::free(pSymbols);
+}
@@ -0,0 +1,118 @@
+/***********************************************************************
+* @file      HandlerWatchdog.h
+*
+* Watchdog over the dispatcher threads, reporting any handler which
+* blocks its thread (and thereby every sensor) beyond a time budget.
+*
+* @brief    Each watched thread publishes, through HandlerTracking.h, the
+*           type of the handler it is executing and since when. A watchdog
+*           thread checks every WATCHDOG_CHECK_INTERVAL_MILLISECONDS; once
+*           a handler invocation has run for longer than
+*           WATCHDOG_HANDLER_BUDGET_MILLISECONDS, it is reported, once:
+*
+*           - Its thread is signalled to capture its own stack (backtrace),
+*             which the watchdog then logs, symbolized and demangled,
+*             together with the handler type and how long it has blocked.
+*             The signal goes out as soon as the overrun is seen, but the
+*             handler may yet return before it is delivered, whereupon
+*             the stack shows whatever the thread went on to do.
+*
+*           - watchdog.overruns and watchdog.<type>.overruns are counted
+*             through Metrics.h.
+*
+*           Threads are watched for the lifetime of a WatchedThread_t:
+*
+*           @code
+*           HandlerWatchdog::WatchedThread_t watched; // On the thread itself.
+*           @endcode
+*
+* @note     Typical culprits are synchronous calls on a dispatcher thread,
+*           e.g. resolver.resolve(), or std::cout into a full pipe.
+*
+* @warning  Requires ASIO_CUSTOM_HANDLER_TRACKING (see meson.build);
+*           without it no handler is ever seen to run. The stack capture
+*           signal (SIGRTMIN) is reserved for the watchdog.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include "CommonDefinitions.h"
+#include "HandlerTracking.h"
+#include "Metrics.h"
+
+class HandlerWatchdog
+{
+public:
+    // Registers the calling thread with the watchdog for its lifetime.
+    class WatchedThread_t
+    {
+    public:
+        WatchedThread_t();
+        ~WatchedThread_t();
+
+        WatchedThread_t(const WatchedThread_t&) = delete;
+        WatchedThread_t& operator=(const WatchedThread_t&) = delete;
+
+        // Time this thread has spent executing handlers so far; always 0
+        // without ASIO_CUSTOM_HANDLER_TRACKING.
+        uint64_t BusyNanoseconds() const
+        {
+            return m_Activity.m_BusyNanoseconds.load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class HandlerWatchdog;
+
+        HandlerTracking::Activity_t  m_Activity;
+        pid_t                        m_ThreadId;
+        char                         m_ThreadName[Utility::THREAD_NAME_LENGTH];
+
+        // Touched by the watchdog thread only.
+        uint64_t                     m_LastReportedInvocation;
+    };
+
+    HandlerWatchdog(const std::chrono::milliseconds& budget,
+                    const std::chrono::milliseconds& checkInterval);
+    virtual ~HandlerWatchdog();
+
+    HandlerWatchdog(const HandlerWatchdog&) = delete;
+    HandlerWatchdog& operator=(const HandlerWatchdog&) = delete;
+
+    void Start();
+    void Stop();
+
+protected:
+    // Copied out of its WatchedThread_t, such that it may be reported
+    // upon without holding up the watched threads' registration.
+    struct Overrun_t
+    {
+        pid_t         m_ThreadId;
+        char          m_ThreadName[Utility::THREAD_NAME_LENGTH];
+        HandlerType_t m_Type;
+        uint64_t      m_BlockedNanoseconds;
+        bool          m_IsSignalled; // Asked to capture its stack.
+    };
+
+    void WatchdogThread();
+    void CheckWatchedThreads();
+    void ReportOverrun(const Overrun_t& overrun);
+
+private:
+    const uint64_t                   m_BudgetNanoseconds;
+    const std::chrono::milliseconds  m_CheckInterval;
+
+    std::thread                      m_Thread;
+    std::mutex                       m_StopMutex;
+    std::condition_variable          m_StopCondition;
+    bool                             m_IsStopping;
+
+    Metrics::Counter_t&              m_Overruns;
+};
@@ -0,0 +1,409 @@
+#include "IngestPipeline.h"
+#include "Calibration.h"
+#include "FlightRecorder.h"
+#include "PerfCounters.h"
+
+#include <algorithm>
+
+// Each I/O thread claims one producer stage upon its first push and
+// releases it when the thread exits, such that each ring only ever has
+// a single producer even as dispatcher threads come and go.
+class IngestPipeline::ProducerClaim_t
+{
+public:
+    ~ProducerClaim_t()
+    {
+        if (m_pStage != nullptr)
+        {
+            m_pStage->m_IsClaimed.store(false, std::memory_order_release);
+        }
+    }
+
+    IngestPipeline*   m_pOwner{nullptr};
+    ProducerStage_t*  m_pStage{nullptr};
+};
+
+IngestPipeline::IngestPipeline(SensorTable& sensorTable, BatchAppliedHandler_t onBatchApplied,
+                               RecordsAppliedHandler_t onRecordsApplied,
+                               const Calibration* pCalibration)
+    : m_TheSensorTable(sensorTable)
+    , m_OnBatchApplied(std::move(onBatchApplied))
+    , m_OnRecordsApplied(std::move(onRecordsApplied))
+    , m_pCalibration(pCalibration)
+    , m_ProducerStages()
+    , m_PushSequence(0)
+    , m_IsRunning(false)
+    , m_IsConflating(false)
+    , m_MaximumLag(0)
+    , m_AggregationThread()
+    , m_ConflationStages()
+    , m_ConflatedRecords()
+    , m_RecordsPushed(Metrics::Counter("ingest.records.pushed"))
+    , m_RecordsDropped(Metrics::Counter("ingest.records.dropped"))
+    , m_RecordsBypassed(Metrics::Counter("ingest.records.bypassed"))
+    , m_RecordsAggregated(Metrics::Counter("aggregate.records"))
+    , m_RecordsConflated(Metrics::Counter("aggregate.records.conflated"))
+    , m_BatchSizes(Metrics::Histogram("aggregate.batch_size"))
+    , m_AggregationLag(Metrics::Histogram("aggregate.lag_ns"))
+{
+    // Every site reports temperature; other channels are sized as and
+    // when they first conflate.
+    auto& stage = m_ConflationStages[static_cast<size_t>(SensorChannel_t::TEMPERATURE)];
+    stage.m_LatestBySensor.resize(sensorTable.Size());
+    stage.m_HasLatest.resize(sensorTable.Size(), false);
+    stage.m_TouchedSensors.reserve(sensorTable.Size());
+    m_ConflatedRecords.reserve(sensorTable.Size());
+
+    for (size_t i = 0; i < m_ProducerStages.size(); i++)
+    {
+        auto prefix = "ingest.ring." + std::to_string(i);
+        m_ProducerStages[i].m_pDepth = &Metrics::Gauge(prefix + ".depth");
+        m_ProducerStages[i].m_pHighWaterMark = &Metrics::Gauge(prefix + ".depth_hwm");
+    }
+}
+
+IngestPipeline::~IngestPipeline()
+{
+    Stop();
+}
+
+void IngestPipeline::Start()
+{
+    if (!m_IsRunning.exchange(true))
+    {
+        m_AggregationThread = std::thread(&IngestPipeline::AggregationThread, this);
+    }
+}
+
+void IngestPipeline::Stop()
+{
+    if (m_IsRunning.exchange(false))
+    {
+        // Wake the aggregation thread up so that it notices.
+        m_PushSequence.fetch_add(1, std::memory_order_release);
+        m_PushSequence.notify_one();
+
+        if (m_AggregationThread.joinable())
+        {
+            m_AggregationThread.join();
+        }
+    }
+}
+
+IngestPipeline::ProducerStage_t* IngestPipeline::ClaimProducerStage()
+{
+    for (auto& stage : m_ProducerStages)
+    {
+        bool expected = false;
+        if (stage.m_IsClaimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return &stage;
+        }
+    }
+    return nullptr;
+}
+
+IngestPipeline::ProducerStage_t* IngestPipeline::ProducerStageOfThisThread()
+{
+    static thread_local ProducerClaim_t ts_TheClaim;
+
+    if (ts_TheClaim.m_pOwner != this)
+    {
+        if (ts_TheClaim.m_pStage != nullptr)
+        {
+            ts_TheClaim.m_pStage->m_IsClaimed.store(false, std::memory_order_release);
+        }
+
+        ts_TheClaim.m_pOwner = this;
+        ts_TheClaim.m_pStage = ClaimProducerStage();
+    }
+
+    // Null if bypassing the pipeline.
+    return ts_TheClaim.m_pStage;
+}
+
+bool IngestPipeline::Push(const ReadingRecord_t& record)
+{
+    return PushBatch(&record, 1) == 1;
+}
+
+size_t IngestPipeline::PushBatch(const ReadingRecord_t* pRecords, const size_t& count)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    auto pStage = ProducerStageOfThisThread();
+
+    if (pStage == nullptr)
+    {
+        // More I/O threads than rings; the sensor table is lock-free so
+        // applying the readings synchronously is merely slower, not unsafe.
+        // Calibration is likewise lock-free, but works in place, as does
+        // the grouping by channel.
+        static thread_local std::vector<ReadingRecord_t> ts_Prepared;
+        ts_Prepared.assign(pRecords, pRecords + count);
+
+        auto runs = PrepareBatch(ts_Prepared.data(), count);
+        for (size_t channel = 0; channel < runs.size(); channel++)
+        {
+            ApplyRun(static_cast<SensorChannel_t>(channel), ts_Prepared.data() + runs[channel].m_First,
+                     runs[channel].m_Count);
+        }
+        m_RecordsBypassed.fetch_add(count, std::memory_order_relaxed);
+
+        // As the aggregation thread does for the rings' batches.
+        if (m_OnBatchApplied)
+        {
+            m_OnBatchApplied();
+        }
+        return count;
+    }
+
+    size_t pushed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (pStage->m_Ring.TryPush(pRecords[i]))
+        {
+            ++pushed;
+        }
+    }
+
+    if (pushed < count)
+    {
+        m_RecordsDropped.fetch_add(count - pushed, std::memory_order_relaxed);
+    }
+
+    if (pushed > 0)
+    {
+        // One counter update and at most one wakeup per batch.
+        m_RecordsPushed.fetch_add(pushed, std::memory_order_relaxed);
+        m_PushSequence.fetch_add(1, std::memory_order_release);
+        m_PushSequence.notify_one();
+    }
+    return pushed;
+}
+
+void IngestPipeline::SetConflating(const bool& isConflating)
+{
+    m_IsConflating.store(isConflating, std::memory_order_relaxed);
+}
+
+uint64_t IngestPipeline::TakeMaximumLag()
+{
+    return m_MaximumLag.exchange(0, std::memory_order_relaxed);
+}
+
+IngestPipeline::ChannelRuns_t IngestPipeline::PrepareBatch(ReadingRecord_t* pRecords,
+                                                           const size_t& count) const
+{
+    ChannelRuns_t runs{};
+
+    // Count the records of each channel. Batches of the one channel, e.g.
+    // those of temperature-only sites, need no more than this one pass.
+    for (size_t i = 0; i < count; i++)
+    {
+        ++runs[static_cast<size_t>(pRecords[i].m_Channel)].m_Count;
+    }
+
+    size_t first = 0;
+    for (auto& run : runs)
+    {
+        run.m_First = first;
+        first += run.m_Count;
+    }
+
+    if (std::none_of(runs.begin(), runs.end(), [&count](const auto& run) { return run.m_Count == count; }))
+    {
+        // Stable counting sort, such that each channel's readings remain
+        // in the order received.
+        static thread_local std::vector<ReadingRecord_t> ts_Grouped;
+        ts_Grouped.resize(count);
+
+        auto next = runs;
+        for (size_t i = 0; i < count; i++)
+        {
+            ts_Grouped[next[static_cast<size_t>(pRecords[i].m_Channel)].m_First++] = pRecords[i];
+        }
+        std::copy(ts_Grouped.begin(), ts_Grouped.end(), pRecords);
+    }
+
+    // Only temperatures are calibrated. Those rejected leave a gap at the
+    // end of their run.
+    auto& temperatures = runs[static_cast<size_t>(SensorChannel_t::TEMPERATURE)];
+    if ((m_pCalibration != nullptr) && (temperatures.m_Count > 0))
+    {
+        temperatures.m_Count = m_pCalibration->Apply(pRecords + temperatures.m_First,
+                                                     temperatures.m_Count);
+    }
+    return runs;
+}
+
+void IngestPipeline::ApplyRun(const SensorChannel_t& channel, const ReadingRecord_t* pRecords,
+                              const size_t& count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_TheSensorTable.Update(pRecords[i].m_SensorNodeNumber, pRecords[i].m_Value,
+                                pRecords[i].m_ReadingTime, channel);
+    }
+    if (m_OnRecordsApplied)
+    {
+        m_OnRecordsApplied(channel, pRecords, count);
+    }
+}
+
+void IngestPipeline::ApplyBatch(const ReadingRecord_t* pRecords, const ChannelRuns_t& runs)
+{
+    if (!m_IsConflating.load(std::memory_order_relaxed))
+    {
+        for (size_t channel = 0; channel < runs.size(); channel++)
+        {
+            ApplyRun(static_cast<SensorChannel_t>(channel), pRecords + runs[channel].m_First,
+                     runs[channel].m_Count);
+        }
+        return;
+    }
+
+    // Defer to ApplyConflated(), keeping only the latest per sensor and
+    // channel.
+    for (size_t channel = 0; channel < runs.size(); channel++)
+    {
+        const auto& run = runs[channel];
+        auto& stage = m_ConflationStages[channel];
+        if ((run.m_Count > 0) && stage.m_LatestBySensor.empty())
+        {
+            stage.m_LatestBySensor.resize(m_TheSensorTable.Size());
+            stage.m_HasLatest.resize(m_TheSensorTable.Size(), false);
+            stage.m_TouchedSensors.reserve(m_TheSensorTable.Size());
+        }
+
+        for (size_t i = run.m_First; i < run.m_First + run.m_Count; i++)
+        {
+            auto sensorNodeNumber = pRecords[i].m_SensorNodeNumber;
+            if (!stage.m_HasLatest[sensorNodeNumber])
+            {
+                stage.m_HasLatest[sensorNodeNumber] = true;
+                stage.m_LatestBySensor[sensorNodeNumber] = pRecords[i];
+                stage.m_TouchedSensors.push_back(sensorNodeNumber);
+            }
+            else
+            {
+                if (pRecords[i].m_ReadingTime >= stage.m_LatestBySensor[sensorNodeNumber].m_ReadingTime)
+                {
+                    stage.m_LatestBySensor[sensorNodeNumber] = pRecords[i];
+                }
+                m_RecordsConflated.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void IngestPipeline::ApplyConflated()
+{
+    for (size_t channel = 0; channel < m_ConflationStages.size(); channel++)
+    {
+        auto& stage = m_ConflationStages[channel];
+        for (auto sensorNodeNumber : stage.m_TouchedSensors)
+        {
+            m_ConflatedRecords.push_back(stage.m_LatestBySensor[sensorNodeNumber]);
+            stage.m_HasLatest[sensorNodeNumber] = false;
+        }
+        stage.m_TouchedSensors.clear();
+
+        ApplyRun(static_cast<SensorChannel_t>(channel), m_ConflatedRecords.data(), m_ConflatedRecords.size());
+        m_ConflatedRecords.clear();
+    }
+}
+
+size_t IngestPipeline::DrainOnce()
+{
+    std::array<ReadingRecord_t, INGEST_BATCH_SIZE> batch;
+    size_t total = 0;
+
+    for (auto& stage : m_ProducerStages)
+    {
+        auto depth = static_cast<int64_t>(stage.m_Ring.Size());
+        stage.m_pDepth->store(depth, std::memory_order_relaxed);
+        if (depth > stage.m_pHighWaterMark->load(std::memory_order_relaxed))
+        {
+            stage.m_pHighWaterMark->store(depth, std::memory_order_relaxed);
+        }
+
+        auto count = stage.m_Ring.PopBatch(batch.data(), batch.size());
+        if (count == 0)
+        {
+            continue;
+        }
+
+        auto timeNow = Utility::CoarseClock::Refresh();
+        auto oldestReadingTime = batch[0].m_ReadingTime;
+        {
+            FlightRecorder::Span_t span(FlightRecorder::Event_t::AGGREGATE,
+                                        static_cast<uint32_t>(count));
+            PerfScope_t perfScope(PerfStage_t::AGGREGATE, static_cast<uint32_t>(count));
+
+            // Readings rejected by the calibration are dropped here, but
+            // still count towards the lag and batch size below.
+            ApplyBatch(batch.data(), PrepareBatch(batch.data(), count));
+        }
+
+        // Lag of the oldest record in the batch is representative.
+        auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       timeNow - oldestReadingTime).count();
+        auto lagNanoseconds = static_cast<uint64_t>((lag > 0) ? lag : 0);
+        m_AggregationLag.Record(lagNanoseconds);
+
+        auto maximumLag = m_MaximumLag.load(std::memory_order_relaxed);
+        while ((lagNanoseconds > maximumLag)
+            && !m_MaximumLag.compare_exchange_weak(maximumLag, lagNanoseconds,
+                                                   std::memory_order_relaxed))
+        {
+        }
+
+        m_BatchSizes.Record(count);
+        m_RecordsAggregated.fetch_add(count, std::memory_order_relaxed);
+
+        total += count;
+    }
+
+    // A no-op unless conflating.
+    ApplyConflated();
+
+    return total;
+}
+
+void IngestPipeline::AggregationThread()
+{
+    // To aid debugging by means of strace, ps, valgrind, gdb, and
+    // variants, name our created threads.
+    Utility::SetThreadName("Aggregator");
+
+    while (m_IsRunning.load(std::memory_order_acquire))
+    {
+        // Snapshot the sequence before draining so that a push which
+        // lands after our drain is guaranteed to wake us up again.
+        auto sequence = m_PushSequence.load(std::memory_order_acquire);
+
+        if (DrainOnce() > 0)
+        {
+            if (m_OnBatchApplied)
+            {
+                m_OnBatchApplied();
+            }
+            continue;
+        }
+
+        // All rings are empty; block (in the kernel) until a producer pushes.
+        m_PushSequence.wait(sequence, std::memory_order_acquire);
+    }
+
+    // Do not lose what was already accepted.
+    DrainOnce();
+}
@@ -0,0 +1,171 @@
+/***********************************************************************
+* @file      IngestPipeline.h
+*
+* Staged ingest pipeline decoupling the I/O (dispatcher) threads from
+* the aggregation of temperature readings.
+*
+* @brief    Stage 1 - the dispatcher threads receive and parse readings,
+*           then push (sensor, channel, timestamp, value) records into
+*           their very own single-producer/single-consumer ring; one record
+*           per channel that a reading carries.
+*
+*           Stage 2 - one dedicated aggregation thread drains all rings
+*           in batches, groups each batch by channel, calibrates its
+*           temperatures (see Calibration.h), applies each channel's
+*           records to that channel's column of the sensor table and hands
+*           them to the incremental aggregation (see AggregationPolicies.h),
+*           and then notifies the display once per batch rather than once
+*           per reading. A batch of temperatures alone is grouped at the
+*           cost of one pass over it.
+*
+*           Consequently, I/O latency is isolated from analytics cost;
+*           a slow aggregation merely deepens the rings instead of
+*           delaying the re-arming of socket reads.
+*
+* @note     Per-stage queue depths (current and high-water mark), pushed,
+*           dropped and aggregated record counts, batch sizes and ingest-
+*           to-aggregation lag are all exported through Metrics.h.
+*
+*           Whilst conflating (see OverloadController.h), the aggregation
+*           stage applies only the latest reading of each sensor and channel
+*           per drain; the others are counted as aggregate.records.conflated.
+*
+* @warning  Should more dispatcher threads exist than rings, the surplus
+*           threads bypass the pipeline and apply their readings to the
+*           (lock-free) sensor table directly.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include "Metrics.h"
+#include "SpscRing.h"
+#include "SensorTable.h"
+
+struct ReadingRecord_t
+{
+    uint32_t                   m_SensorNodeNumber;
+    SensorChannel_t            m_Channel;
+    SteadyClock_t::time_point  m_ReadingTime;
+    double                     m_Value; // In the channel's unit.
+};
+
+// The channel packs into the sensor node number's padding; the rings
+// carry as many records as before channels were introduced.
+static_assert(sizeof(ReadingRecord_t) == 24, "ReadingRecord_t must stay 24 bytes");
+
+class Calibration;
+
+class IngestPipeline
+{
+    using Ring_t = Utility::SpscRing<ReadingRecord_t, INGEST_RING_CAPACITY>;
+
+    // A span of a batch's records, all of the one channel.
+    struct ChannelRun_t
+    {
+        size_t                  m_First{0};
+        size_t                  m_Count{0};
+    };
+
+    using ChannelRuns_t = std::array<ChannelRun_t, NUMBER_OF_SENSOR_CHANNELS>;
+
+    // Aggregation thread only: latest record per sensor whilst conflating.
+    // Sized upon the channel's first conflated reading.
+    struct ConflationStage_t
+    {
+        std::vector<ReadingRecord_t>  m_LatestBySensor;
+        std::vector<bool>             m_HasLatest;
+        std::vector<uint32_t>         m_TouchedSensors;
+    };
+
+    struct ProducerStage_t
+    {
+        Ring_t                  m_Ring;
+        std::atomic<bool>       m_IsClaimed{false};
+        Metrics::Gauge_t*       m_pDepth{nullptr};
+        Metrics::Gauge_t*       m_pHighWaterMark{nullptr};
+    };
+
+    class ProducerClaim_t;
+
+public:
+    // Called once per batch applied, by whichever thread applied it.
+    using BatchAppliedHandler_t = std::function<void()>;
+
+    // Called with the records just applied to the sensor table; once per
+    // batch and channel, by whichever thread applied them.
+    using RecordsAppliedHandler_t = std::function<void(const SensorChannel_t&, const ReadingRecord_t*,
+                                                       const size_t&)>;
+
+    // Temperatures are applied uncalibrated without a calibration; other
+    // channels always are.
+    IngestPipeline(SensorTable& sensorTable, BatchAppliedHandler_t onBatchApplied,
+                   RecordsAppliedHandler_t onRecordsApplied = nullptr,
+                   const Calibration* pCalibration = nullptr);
+    virtual ~IngestPipeline();
+
+    IngestPipeline(const IngestPipeline&) = delete;
+    IngestPipeline& operator=(const IngestPipeline&) = delete;
+
+    void Start();
+    void Stop();
+
+    // Called by the I/O threads. Never blocks. Returns false if the
+    // record had to be dropped because the aggregation stage has fallen
+    // a whole ring behind.
+    bool Push(const ReadingRecord_t& record);
+
+    // As Push(), for a whole batch at the cost of one wakeup of the
+    // aggregation thread. Returns the number of records accepted.
+    size_t PushBatch(const ReadingRecord_t* pRecords, const size_t& count);
+
+    // Latest value wins, per sensor, until told otherwise.
+    void SetConflating(const bool& isConflating);
+
+    // Worst receive-to-aggregation lag (ns) since the previous call.
+    uint64_t TakeMaximumLag();
+
+protected:
+    void AggregationThread();
+    size_t DrainOnce();
+    ChannelRuns_t PrepareBatch(ReadingRecord_t* pRecords, const size_t& count) const;
+    void ApplyRun(const SensorChannel_t& channel, const ReadingRecord_t* pRecords, const size_t& count);
+    void ApplyBatch(const ReadingRecord_t* pRecords, const ChannelRuns_t& runs);
+    void ApplyConflated();
+    ProducerStage_t* ClaimProducerStage();
+    ProducerStage_t* ProducerStageOfThisThread();
+
+private:
+    SensorTable&                                                      m_TheSensorTable;
+    BatchAppliedHandler_t                                             m_OnBatchApplied;
+    RecordsAppliedHandler_t                                           m_OnRecordsApplied;
+    const Calibration*                                                m_pCalibration;
+    std::array<ProducerStage_t, MAXIMUM_INGEST_PRODUCERS>             m_ProducerStages;
+
+    // Bumped by producers upon every push; the aggregation thread waits
+    // upon it when all rings are found empty.
+    alignas(64) std::atomic<uint64_t>                                 m_PushSequence;
+    std::atomic<bool>                                                 m_IsRunning;
+    std::atomic<bool>                                                 m_IsConflating;
+    std::atomic<uint64_t>                                             m_MaximumLag;
+    std::thread                                                       m_AggregationThread;
+
+    std::array<ConflationStage_t, NUMBER_OF_SENSOR_CHANNELS>          m_ConflationStages;
+    std::vector<ReadingRecord_t>                                      m_ConflatedRecords;
+
+    Metrics::Counter_t&                                               m_RecordsPushed;
+    Metrics::Counter_t&                                               m_RecordsDropped;
+    Metrics::Counter_t&                                               m_RecordsBypassed;
+    Metrics::Counter_t&                                               m_RecordsAggregated;
+    Metrics::Counter_t&                                               m_RecordsConflated;
+    Metrics::Histogram_t&                                             m_BatchSizes;
+    Metrics::Histogram_t&                                             m_AggregationLag;
+};
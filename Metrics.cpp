@@ -0,0 +1,120 @@
+#include "Metrics.h"
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <sstream>
+
+namespace Metrics
+{
+    namespace
+    {
+        struct Registry_t
+        {
+            std::mutex                                            m_Mutex;
+            std::map<std::string, std::unique_ptr<Counter_t>>     m_Counters;
+            std::map<std::string, std::unique_ptr<Gauge_t>>       m_Gauges;
+            std::map<std::string, std::unique_ptr<Histogram_t>>   m_Histograms;
+        };
+
+        // Function-local static so that metrics may safely be registered
+        // from within other static initializers.
+        Registry_t& TheRegistry()
+        {
+            static Registry_t s_TheRegistry;
+            return s_TheRegistry;
+        }
+
+        template <typename T>
+        T& FindOrCreate(std::map<std::string, std::unique_ptr<T>>& metrics,
+                        const std::string& name)
+        {
+            auto& pMetric = metrics[name];
+            if (!pMetric)
+            {
+                pMetric = std::make_unique<T>();
+            }
+            return *pMetric;
+        }
+    }
+
+    uint64_t Histogram_t::Percentile(const double& percentile) const
+    {
+        auto count = Count();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        auto target = static_cast<uint64_t>(percentile * count);
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < NUMBER_OF_BUCKETS; i++)
+        {
+            seen += m_Buckets[i].load(std::memory_order_relaxed);
+            if (seen > target)
+            {
+                return (i == 0) ? 1 : (i >= 64 ? UINT64_MAX : (1ULL << i));
+            }
+        }
+        return Max();
+    }
+
+    Counter_t& Counter(const std::string& name)
+    {
+        auto& registry = TheRegistry();
+        std::unique_lock<std::mutex> lock(registry.m_Mutex);
+        return FindOrCreate(registry.m_Counters, name);
+    }
+
+    Gauge_t& Gauge(const std::string& name)
+    {
+        auto& registry = TheRegistry();
+        std::unique_lock<std::mutex> lock(registry.m_Mutex);
+        return FindOrCreate(registry.m_Gauges, name);
+    }
+
+    Histogram_t& Histogram(const std::string& name)
+    {
+        auto& registry = TheRegistry();
+        std::unique_lock<std::mutex> lock(registry.m_Mutex);
+        return FindOrCreate(registry.m_Histograms, name);
+    }
+
+    std::string Render()
+    {
+        auto& registry = TheRegistry();
+        std::map<std::string, std::string> lines;
+
+        {
+            std::unique_lock<std::mutex> lock(registry.m_Mutex);
+
+            for (const auto& [name, pCounter] : registry.m_Counters)
+            {
+                lines[name] = std::to_string(pCounter->load(std::memory_order_relaxed));
+            }
+            for (const auto& [name, pGauge] : registry.m_Gauges)
+            {
+                lines[name] = std::to_string(pGauge->load(std::memory_order_relaxed));
+            }
+            for (const auto& [name, pHistogram] : registry.m_Histograms)
+            {
+                std::ostringstream oss;
+                oss << "count=" << pHistogram->Count()
+                    << " sum="  << pHistogram->Sum()
+                    << " max="  << pHistogram->Max()
+                    << " p50="  << pHistogram->Percentile(0.50)
+                    << " p90="  << pHistogram->Percentile(0.90)
+                    << " p99="  << pHistogram->Percentile(0.99);
+                lines[name] = oss.str();
+            }
+        }
+
+        std::ostringstream oss;
+        for (const auto& [name, value] : lines)
+        {
+            oss << name << ' ' << value << '\n';
+        }
+        return oss.str();
+    }
+}
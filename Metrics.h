@@ -0,0 +1,85 @@
+/***********************************************************************
+* @file      Metrics.h
+*
+* Process-wide, in-memory metrics: monotonic counters, gauges and
+* log2-bucketed histograms, all of which are cheap enough to update
+* from the hot ingest path.
+*
+* @brief    Registration (by name) takes a mutex and hence ought to be
+*           done once, with the returned reference cached by the caller.
+*           Thereafter, updates are single relaxed atomic operations.
+*           References remain valid for the lifetime of the process.
+*
+*           Metrics are exposed to ops tooling through the "METRICS"
+*           request of the query API (see QueryServer.h), one metric per
+*           line, sorted by name:
+*
+*           ingest.records.pushed 1234
+*           aggregate.lag_ns count=56 sum=789 max=99 p50=64 p90=128 p99=128
+*
+* @note
+*
+* @warning  Histogram percentiles are bucket upper bounds (powers of 2),
+*           i.e. they may overstate the true value by up to 2x.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+namespace Metrics
+{
+    using Counter_t = std::atomic<uint64_t>;
+    using Gauge_t   = std::atomic<int64_t>;
+
+    class Histogram_t
+    {
+    public:
+        // Bucket i holds values v with 2^(i-1) < v <= 2^i; bucket 0 holds 0 and 1.
+        static constexpr size_t NUMBER_OF_BUCKETS = 65;
+
+        Histogram_t() = default;
+        Histogram_t(const Histogram_t&) = delete;
+        Histogram_t& operator=(const Histogram_t&) = delete;
+
+        void Record(const uint64_t& value)
+        {
+            auto bucket = (value <= 1) ? 0 : (64 - __builtin_clzll(value - 1));
+            m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            m_Count.fetch_add(1, std::memory_order_relaxed);
+            m_Sum.fetch_add(value, std::memory_order_relaxed);
+
+            auto max = m_Max.load(std::memory_order_relaxed);
+            while ((value > max)
+                && !m_Max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        uint64_t Count() const { return m_Count.load(std::memory_order_relaxed); }
+        uint64_t Sum() const   { return m_Sum.load(std::memory_order_relaxed); }
+        uint64_t Max() const   { return m_Max.load(std::memory_order_relaxed); }
+
+        // Upper bound of the bucket holding the requested percentile.
+        uint64_t Percentile(const double& percentile) const;
+
+    private:
+        std::array<std::atomic<uint64_t>, NUMBER_OF_BUCKETS>  m_Buckets{};
+        std::atomic<uint64_t>                                 m_Count{0};
+        std::atomic<uint64_t>                                 m_Sum{0};
+        std::atomic<uint64_t>                                 m_Max{0};
+    };
+
+    Counter_t&   Counter(const std::string& name);
+    Gauge_t&     Gauge(const std::string& name);
+    Histogram_t& Histogram(const std::string& name);
+
+    // Render all metrics as text, one per line, sorted by name.
+    std::string Render();
+}
@@ -0,0 +1,61 @@
+/***********************************************************************
+* @file      MoveOnlyTask.h
+*
+* Move-only, type-erased, nullary unit of work.
+*
+* @brief    Our own executors (see WorkStealingExecutor.h and
+*           PriorityExecutor.h) must queue ASIO completion handlers, which
+*           are move-only, hence std::function<void()> cannot hold them.
+*
+* @note     Equivalent to C++23 std::move_only_function<void()>, which
+*           our C++20 toolchain does not yet provide.
+*
+* @warning  Invoking an empty task is undefined behavior.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace Utility
+{
+    class MoveOnlyTask_t
+    {
+        struct Concept_t
+        {
+            virtual ~Concept_t() = default;
+            virtual void Invoke() = 0;
+        };
+
+        template <typename Function>
+        struct Model_t : Concept_t
+        {
+            template <typename F>
+            explicit Model_t(F&& function) : m_Function(std::forward<F>(function)) {}
+            void Invoke() override { m_Function(); }
+            Function m_Function;
+        };
+
+    public:
+        MoveOnlyTask_t() = default;
+
+        template <typename Function>
+            requires (!std::is_same_v<std::decay_t<Function>, MoveOnlyTask_t>)
+        explicit MoveOnlyTask_t(Function&& function)
+            : m_pTask(std::make_unique<Model_t<std::decay_t<Function>>>(
+                          std::forward<Function>(function)))
+        {
+        }
+
+        void operator()() { m_pTask->Invoke(); }
+        explicit operator bool() const { return static_cast<bool>(m_pTask); }
+
+    private:
+        std::unique_ptr<Concept_t>  m_pTask;
+    };
+}
@@ -0,0 +1,166 @@
+#include "OverloadController.h"
+
+OverloadController::OverloadController(asio::io_context& ioContext,
+                                       const size_t& numberOfSensors,
+                                       LagProbe_t takeHandlerLag,
+                                       TransitionHandler_t onTransition)
+    : m_EvaluationTimer(ioContext)
+    , m_NumberOfSensors(numberOfSensors)
+    , m_TakeHandlerLag(std::move(takeHandlerLag))
+    , m_OnTransition(std::move(onTransition))
+    , m_IsOverloaded(false)
+    , m_CalmEvaluations(0)
+    , m_pReceives(std::make_unique<std::atomic<uint64_t>[]>(numberOfSensors))
+    , m_pPreviousReceives(std::make_unique<uint64_t[]>(numberOfSensors))
+    , m_pIsNoisy(std::make_unique<std::atomic<bool>[]>(numberOfSensors))
+    , m_ActiveGauge(Metrics::Gauge("overload.active"))
+    , m_Transitions(Metrics::Counter("overload.transitions"))
+    , m_NoisySensorsGauge(Metrics::Gauge("overload.noisy_sensors"))
+    , m_ReadPauses(Metrics::Counter("overload.read_pauses"))
+    , m_QueueDelay(Metrics::Histogram("overload.queue_delay_ns"))
+    , m_HandlerLag(Metrics::Histogram("overload.handler_lag_ns"))
+{
+    for (size_t i = 0; i < m_NumberOfSensors; i++)
+    {
+        m_pReceives[i].store(0, std::memory_order_relaxed);
+        m_pPreviousReceives[i] = 0;
+        m_pIsNoisy[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+OverloadController::~OverloadController()
+{
+}
+
+void OverloadController::Start()
+{
+    ArmEvaluationTimer();
+}
+
+void OverloadController::Stop()
+{
+    m_EvaluationTimer.cancel();
+}
+
+bool OverloadController::IsOverloaded() const
+{
+    return m_IsOverloaded.load(std::memory_order_relaxed);
+}
+
+void OverloadController::RecordReceive(const size_t& sensorNodeNumber)
+{
+    m_pReceives[sensorNodeNumber].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool OverloadController::ShouldPauseReads(const size_t& sensorNodeNumber)
+{
+    if (m_IsOverloaded.load(std::memory_order_relaxed)
+        && m_pIsNoisy[sensorNodeNumber].load(std::memory_order_relaxed))
+    {
+        m_ReadPauses.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void OverloadController::ArmEvaluationTimer()
+{
+    m_EvaluationTimer.expires_after(
+        std::chrono::milliseconds(OVERLOAD_EVALUATION_INTERVAL_MILLISECONDS));
+    m_EvaluationTimer.async_wait([this](const std::error_code& error)
+    {
+        OnEvaluationTimer(error);
+    });
+}
+
+void OverloadController::OnEvaluationTimer(const std::error_code& error)
+{
+    if (error == asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    // How late we were run is how long any handler is presently queued.
+    auto queueDelay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          SteadyClock_t::now() - m_EvaluationTimer.expiry()).count();
+    auto queueDelayNanoseconds = static_cast<uint64_t>((queueDelay > 0) ? queueDelay : 0);
+    auto handlerLagNanoseconds = m_TakeHandlerLag ? m_TakeHandlerLag() : 0;
+
+    m_QueueDelay.Record(queueDelayNanoseconds);
+    m_HandlerLag.Record(handlerLagNanoseconds);
+
+    bool isStressed = (queueDelayNanoseconds > OVERLOAD_ENTER_QUEUE_DELAY_MICROSECONDS * 1000ULL)
+                   || (handlerLagNanoseconds > OVERLOAD_ENTER_HANDLER_LAG_MICROSECONDS * 1000ULL);
+    bool isCalm = (queueDelayNanoseconds < OVERLOAD_EXIT_QUEUE_DELAY_MICROSECONDS * 1000ULL)
+               && (handlerLagNanoseconds < OVERLOAD_EXIT_HANDLER_LAG_MICROSECONDS * 1000ULL);
+
+    m_CalmEvaluations = isCalm ? (m_CalmEvaluations + 1) : 0;
+
+    FlagNoisySensors();
+
+    auto wasOverloaded = m_IsOverloaded.load(std::memory_order_relaxed);
+    auto isOverloaded = wasOverloaded;
+
+    if (!wasOverloaded && isStressed)
+    {
+        isOverloaded = true;
+    }
+    else if (wasOverloaded && (m_CalmEvaluations >= OVERLOAD_EXIT_HYSTERESIS))
+    {
+        isOverloaded = false;
+    }
+
+    if (isOverloaded != wasOverloaded)
+    {
+        std::cout << (isOverloaded ? "[WARN] : Entering" : "[INFO] : Leaving")
+                  << " overload (queue delay " << queueDelayNanoseconds
+                  << " ns, handler lag " << handlerLagNanoseconds << " ns)\n";
+
+        m_IsOverloaded.store(isOverloaded, std::memory_order_relaxed);
+        m_ActiveGauge.store(isOverloaded ? 1 : 0, std::memory_order_relaxed);
+        m_Transitions.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_OnTransition)
+        {
+            m_OnTransition(isOverloaded);
+        }
+    }
+
+    ArmEvaluationTimer();
+}
+
+void OverloadController::FlagNoisySensors()
+{
+    std::vector<uint64_t> deltas(m_NumberOfSensors);
+    uint64_t total = 0;
+    size_t noisiest = 0;
+
+    for (size_t i = 0; i < m_NumberOfSensors; i++)
+    {
+        auto receives = m_pReceives[i].load(std::memory_order_relaxed);
+        deltas[i] = receives - m_pPreviousReceives[i];
+        m_pPreviousReceives[i] = receives;
+        total += deltas[i];
+
+        if (deltas[i] > deltas[noisiest])
+        {
+            noisiest = i;
+        }
+    }
+
+    // Noisy is well above the fleet mean. Should the whole fleet be
+    // equally noisy, the single noisiest sensor is nonetheless paused so
+    // that overload always sheds something at the source.
+    auto threshold = (total * OVERLOAD_NOISY_SENSOR_FACTOR) / (m_NumberOfSensors ? m_NumberOfSensors : 1);
+    int64_t noisySensors = 0;
+
+    for (size_t i = 0; i < m_NumberOfSensors; i++)
+    {
+        bool isNoisy = (deltas[i] > 0)
+                    && ((deltas[i] > threshold) || (i == noisiest));
+        m_pIsNoisy[i].store(isNoisy, std::memory_order_relaxed);
+        noisySensors += isNoisy ? 1 : 0;
+    }
+
+    m_NoisySensorsGauge.store(noisySensors, std::memory_order_relaxed);
+}
@@ -0,0 +1,106 @@
+/***********************************************************************
+* @file      OverloadController.h
+*
+* Overload detection and the load shedding policy that keeps latency
+* bounded when the offered load exceeds what we can process.
+*
+* @brief    Every OVERLOAD_EVALUATION_INTERVAL_MILLISECONDS an evaluation
+*           timer expires on the dispatcher io_context. Two signals decide:
+*
+*           - Queue delay: how late that timer's handler runs, i.e. how long
+*             any handler is currently queued on the dispatcher.
+*
+*           - Handler lag: the worst time, since the previous evaluation,
+*             from a reading being received to its being applied to the
+*             sensor table by the aggregation stage.
+*
+*           Either exceeding its "enter" threshold declares overload. Both
+*           must stay below their "exit" thresholds for several consecutive
+*           evaluations before overload is declared over.
+*
+*           Whilst overloaded:
+*
+*           - Per-sensor updates are conflated; the aggregation stage only
+*             applies the latest reading of each sensor per drain.
+*
+*           - Reads on the noisiest sockets are paused for a while, pushing
+*             back on those nodes via TCP flow control.
+*
+*           - The display cadence is degraded.
+*
+* @note     Metrics: overload.active, overload.transitions,
+*           overload.noisy_sensors, overload.read_pauses,
+*           overload.queue_delay_ns, overload.handler_lag_ns.
+*
+* @warning  The noisiest sensors are judged by their receive completions
+*           since the previous evaluation, relative to the fleet mean.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+
+class OverloadController
+{
+public:
+    // Called (on a dispatcher thread) for each transition into or out of
+    // overload.
+    using TransitionHandler_t = std::function<void(bool isOverloaded)>;
+
+    // Returns, and resets, the worst handler lag (ns) since the last call.
+    using LagProbe_t = std::function<uint64_t()>;
+
+    OverloadController(asio::io_context& ioContext, const size_t& numberOfSensors,
+                       LagProbe_t takeHandlerLag, TransitionHandler_t onTransition);
+    virtual ~OverloadController();
+
+    OverloadController(const OverloadController&) = delete;
+    OverloadController& operator=(const OverloadController&) = delete;
+
+    void Start();
+    void Stop();
+
+    bool IsOverloaded() const;
+
+    // Called by the receive path once per receive completion.
+    void RecordReceive(const size_t& sensorNodeNumber);
+
+    // True if reads from this sensor ought to be paused (for
+    // OVERLOAD_READ_PAUSE_MILLISECONDS) before being re-armed.
+    bool ShouldPauseReads(const size_t& sensorNodeNumber);
+
+protected:
+    void ArmEvaluationTimer();
+    void OnEvaluationTimer(const std::error_code& error);
+    void FlagNoisySensors();
+
+private:
+    asio::steady_timer                               m_EvaluationTimer;
+    size_t                                           m_NumberOfSensors;
+    LagProbe_t                                       m_TakeHandlerLag;
+    TransitionHandler_t                              m_OnTransition;
+
+    std::atomic<bool>                                m_IsOverloaded;
+    uint32_t                                         m_CalmEvaluations;
+
+    // Receive completions per sensor, and their count at the previous
+    // evaluation, from which the noisiest sensors are judged.
+    std::unique_ptr<std::atomic<uint64_t>[]>         m_pReceives;
+    std::unique_ptr<uint64_t[]>                      m_pPreviousReceives;
+    std::unique_ptr<std::atomic<bool>[]>             m_pIsNoisy;
+
+    Metrics::Gauge_t&                                m_ActiveGauge;
+    Metrics::Counter_t&                              m_Transitions;
+    Metrics::Gauge_t&                                m_NoisySensorsGauge;
+    Metrics::Counter_t&                              m_ReadPauses;
+    Metrics::Histogram_t&                            m_QueueDelay;
+    Metrics::Histogram_t&                            m_HandlerLag;
+};
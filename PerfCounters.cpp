@@ -0,0 +1,223 @@
+#include "PerfCounters.h"
+#include "Metrics.h"
+
+#include <mutex>
+#include <cstring>
+#include <linux/perf_event.h>
+
+namespace
+{
+    constexpr std::array<const char*, NUMBER_OF_PERF_STAGES> STAGE_NAMES =
+    {
+        "receive", "parse", "aggregate"
+    };
+
+    constexpr std::array<uint64_t, PerfCounterGroup::NUMBER_OF_COUNTERS> HARDWARE_EVENTS =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    // Misses are rare per reading, hence reported in thousandths.
+    constexpr std::array<const char*, PerfCounterGroup::NUMBER_OF_COUNTERS> AVERAGE_NAMES =
+    {
+        "cycles_per_reading",
+        "instructions_per_reading",
+        "cache_misses_per_reading_x1000",
+        "branch_misses_per_reading_x1000"
+    };
+
+    constexpr std::array<uint64_t, PerfCounterGroup::NUMBER_OF_COUNTERS> AVERAGE_SCALES =
+    {
+        1, 1, 1000, 1000
+    };
+
+    struct StageTotals_t
+    {
+        std::mutex                                                       m_Mutex;
+        PerfCounterGroup::Sample_t                                       m_Totals{};
+        uint64_t                                                         m_Readings{0};
+        std::array<Metrics::Gauge_t*, PerfCounterGroup::NUMBER_OF_COUNTERS> m_pAverages{};
+    };
+
+    struct PerfMetrics_t
+    {
+        PerfMetrics_t()
+            : m_Available(Metrics::Gauge("perf.available"))
+        {
+            for (size_t stage = 0; stage < NUMBER_OF_PERF_STAGES; stage++)
+            {
+                for (size_t counter = 0; counter < PerfCounterGroup::NUMBER_OF_COUNTERS; counter++)
+                {
+                    m_Stages[stage].m_pAverages[counter] = &Metrics::Gauge(
+                        std::string("perf.") + STAGE_NAMES[stage] + "." + AVERAGE_NAMES[counter]);
+                }
+            }
+        }
+
+        Metrics::Gauge_t&                                    m_Available;
+        std::array<StageTotals_t, NUMBER_OF_PERF_STAGES>     m_Stages;
+    };
+
+    PerfMetrics_t& ThePerfMetrics()
+    {
+        static PerfMetrics_t s_ThePerfMetrics;
+        return s_ThePerfMetrics;
+    }
+
+    int OpenCounter(const uint64_t& event, const int& groupLeader)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = event;
+        attributes.exclude_kernel = 1; // Permitted with perf_event_paranoid <= 2.
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+
+        // This thread, on whichever CPU it runs.
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, groupLeader, 0));
+    }
+
+    // Logged once, not per thread.
+    std::once_flag g_UnavailableOnce;
+
+    const PerfCounterGroup* SampledGroupOfThisThread(const PerfStage_t& stage)
+    {
+        static thread_local std::array<uint32_t, NUMBER_OF_PERF_STAGES> ts_Countdowns{};
+        static thread_local std::unique_ptr<PerfCounterGroup> ts_pGroup;
+        static thread_local bool ts_IsUnavailable = false;
+
+        if constexpr (!PERF_COUNTERS_ENABLED)
+        {
+            return nullptr;
+        }
+
+        if (ts_IsUnavailable)
+        {
+            return nullptr;
+        }
+
+        auto& countdown = ts_Countdowns[static_cast<size_t>(stage)];
+        if (countdown > 0)
+        {
+            --countdown;
+            return nullptr;
+        }
+        countdown = PERF_COUNTER_SAMPLE_INTERVAL - 1;
+
+        if (!ts_pGroup)
+        {
+            ts_pGroup = std::make_unique<PerfCounterGroup>();
+            if (!ts_pGroup->IsAvailable())
+            {
+                auto error = errno;
+                ts_IsUnavailable = true;
+                ts_pGroup.reset();
+
+                // perf.available is left alone; another thread may have
+                // opened its counters.
+                std::call_once(g_UnavailableOnce, [error]()
+                {
+                    std::cout << "[WARN] Hardware performance counters are unavailable ("
+                              << std::strerror(error) << "); perf.* metrics will remain 0.\n";
+                });
+                return nullptr;
+            }
+            ThePerfMetrics().m_Available.store(1, std::memory_order_relaxed);
+        }
+        return ts_pGroup.get();
+    }
+}
+
+PerfCounterGroup::PerfCounterGroup()
+    : m_FileDescriptors()
+    , m_NumberOfOpenCounters(0)
+{
+    m_FileDescriptors.fill(-1);
+    m_FileDescriptors[CYCLES] = OpenCounter(HARDWARE_EVENTS[CYCLES], -1);
+    if (m_FileDescriptors[CYCLES] < 0)
+    {
+        return;
+    }
+    m_NumberOfOpenCounters = 1;
+
+    for (size_t i = CYCLES + 1; i < NUMBER_OF_COUNTERS; i++)
+    {
+        m_FileDescriptors[i] = OpenCounter(HARDWARE_EVENTS[i], m_FileDescriptors[CYCLES]);
+        m_NumberOfOpenCounters += (m_FileDescriptors[i] >= 0) ? 1 : 0;
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup()
+{
+    for (auto fileDescriptor : m_FileDescriptors)
+    {
+        if (fileDescriptor >= 0)
+        {
+            ::close(fileDescriptor);
+        }
+    }
+}
+
+bool PerfCounterGroup::IsAvailable() const
+{
+    // Cycles at the very least; some PMUs lack the cache miss event.
+    return m_FileDescriptors[CYCLES] >= 0;
+}
+
+bool PerfCounterGroup::Read(Sample_t& sample) const
+{
+    // PERF_FORMAT_GROUP: the number of counters, then their values in
+    // the order in which they joined the group.
+    std::array<uint64_t, 1 + NUMBER_OF_COUNTERS> values{};
+    auto expected = static_cast<ssize_t>((1 + m_NumberOfOpenCounters) * sizeof(uint64_t));
+
+    if (!IsAvailable() || (::read(m_FileDescriptors[CYCLES], values.data(), sizeof(values)) != expected))
+    {
+        return false;
+    }
+
+    size_t next = 1;
+    for (size_t i = 0; i < NUMBER_OF_COUNTERS; i++)
+    {
+        sample[i] = (m_FileDescriptors[i] >= 0) ? values[next++] : 0;
+    }
+    return true;
+}
+
+PerfScope_t::PerfScope_t(const PerfStage_t& stage, const uint32_t& readings)
+    : m_Stage(stage)
+    , m_Readings(readings)
+    , m_pGroup(SampledGroupOfThisThread(stage))
+    , m_Start()
+{
+    if ((m_pGroup != nullptr) && !m_pGroup->Read(m_Start))
+    {
+        m_pGroup = nullptr;
+    }
+}
+
+PerfScope_t::~PerfScope_t()
+{
+    PerfCounterGroup::Sample_t end;
+    if ((m_pGroup == nullptr) || (m_Readings == 0) || !m_pGroup->Read(end))
+    {
+        return;
+    }
+
+    auto& totals = ThePerfMetrics().m_Stages[static_cast<size_t>(m_Stage)];
+    std::unique_lock<std::mutex> lock(totals.m_Mutex);
+
+    totals.m_Readings += m_Readings;
+    for (size_t i = 0; i < PerfCounterGroup::NUMBER_OF_COUNTERS; i++)
+    {
+        totals.m_Totals[i] += end[i] - m_Start[i];
+        totals.m_pAverages[i]->store(static_cast<int64_t>(
+            (totals.m_Totals[i] * AVERAGE_SCALES[i]) / totals.m_Readings),
+            std::memory_order_relaxed);
+    }
+}
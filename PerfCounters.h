@@ -0,0 +1,110 @@
+/***********************************************************************
+* @file      PerfCounters.h
+*
+* Optional hardware performance counter instrumentation (perf_event_open)
+* of the receive, parse and aggregate stages of the ingest path.
+*
+* @brief    Each thread opens, upon first use, one counter group of its
+*           own: cycles, instructions, cache misses and branch misses, in
+*           user space only. A PerfScope_t reads the group on entry and on
+*           exit, every PERF_COUNTER_SAMPLE_INTERVAL-th time that it is
+*           constructed for its stage on that thread, and accumulates the
+*           deltas together with the number of readings that were covered:
+*
+*           @code
+*           {
+*               PerfScope_t scope(PerfStage_t::PARSE);
+*               ...
+*           }
+*           @endcode
+*
+*           Per-reading averages are exported through Metrics.h as gauges:
+*           perf.<stage>.cycles_per_reading, .instructions_per_reading,
+*           .cache_misses_per_reading_x1000 and
+*           .branch_misses_per_reading_x1000 (misses being rare, in
+*           thousandths). perf.available is 0 unless counters could be
+*           opened on at least one thread.
+*
+* @note     Counters are unavailable in many containers and VMs, and when
+*           /proc/sys/kernel/perf_event_paranoid forbids them. Scopes then
+*           cost one thread-local branch and report nothing.
+*
+* @warning  Reading the group costs a system call, hence the sampling.
+*           PERF_COUNTERS_ENABLED = false disables all sampling.
+*           Nested scopes (e.g. parse within receive) are each counted in
+*           full, i.e. the outer includes the inner.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "CommonDefinitions.h"
+
+enum class PerfStage_t : uint8_t
+{
+    RECEIVE   = 0,
+    PARSE     = 1,
+    AGGREGATE = 2,
+};
+
+static constexpr size_t NUMBER_OF_PERF_STAGES = 3;
+
+class PerfCounterGroup
+{
+public:
+    enum Counter_t : size_t
+    {
+        CYCLES        = 0,
+        INSTRUCTIONS  = 1,
+        CACHE_MISSES  = 2,
+        BRANCH_MISSES = 3,
+    };
+
+    static constexpr size_t NUMBER_OF_COUNTERS = 4;
+
+    using Sample_t = std::array<uint64_t, NUMBER_OF_COUNTERS>;
+
+    // Counts the calling thread only.
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool IsAvailable() const;
+
+    // One system call for the whole group. Counters that the PMU lacks
+    // read as 0.
+    bool Read(Sample_t& sample) const;
+
+private:
+    // Cycles leads the group; others join it if the PMU supports them.
+    std::array<int, NUMBER_OF_COUNTERS>  m_FileDescriptors;
+    size_t                               m_NumberOfOpenCounters;
+};
+
+class PerfScope_t
+{
+public:
+    explicit PerfScope_t(const PerfStage_t& stage, const uint32_t& readings = 1);
+    ~PerfScope_t();
+
+    PerfScope_t(const PerfScope_t&) = delete;
+    PerfScope_t& operator=(const PerfScope_t&) = delete;
+
+    // For reading counts only known by the end of the scope.
+    void SetReadings(const uint32_t& readings)
+    {
+        m_Readings = readings;
+    }
+
+private:
+    PerfStage_t                  m_Stage;
+    uint32_t                     m_Readings;
+    const PerfCounterGroup*      m_pGroup; // Null unless sampling.
+    PerfCounterGroup::Sample_t   m_Start;
+};
@@ -0,0 +1,1387 @@
+/***********************************************************************
+* @file      PerformanceBenchmarks.cpp
+*
+* Stand-alone micro/macro benchmarks backing the performance-related
+* design decisions taken in this application.
+*
+* @brief    Each benchmark is a self-contained section which may be run
+*           on its own by naming it on the command line:
+*
+*           ./PerformanceBenchmarks                # Run all sections.
+*           ./PerformanceBenchmarks workstealing   # Run just the one.
+*
+*           Results are printed as plain text, one line per variant, so
+*           that runs on different machines may be simply diffed.
+*
+* @note     This executable is deliberately built WITHOUT the sanitizers
+*           and instrumentation that the application itself is built with;
+*           see meson.build.
+*
+* @warning  Numbers from a single core (or from a loaded machine) say
+*           little about scalability; pin and isolate CPUs if possible.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#include <cmath>
+#include <random>
+#include <future>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include "CommonDefinitions.h"
+#include "WorkStealingExecutor.h"
+#include "PriorityExecutor.h"
+#include "FlightRecorder.h"
+#include "PerfCounters.h"
+#include "SensorTable.h"
+#include "AggregationPolicies.h"
+#include "Calibration.h"
+#include "AnomalyDetector.h"
+#include "AlertRules.h"
+#include "IngestPipeline.h"
+#include "SiteHeatmap.h"
+#include "SensorDiscovery.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_Sink{0};
+
+    // Stand-in for CPU-bound analytics/compression; cannot be elided.
+    void Spin(const uint32_t& iterations)
+    {
+        uint64_t x = iterations;
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        g_Sink.fetch_add(x & 1, std::memory_order_relaxed);
+    }
+
+    uint64_t NanosecondsSince(const SteadyClock_t::time_point& then)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   SteadyClock_t::now() - then).count());
+    }
+
+    uint64_t Percentile(std::vector<uint64_t>& samples, const double& fraction)
+    {
+        if (samples.empty())
+        {
+            return 0;
+        }
+        auto rank = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+
+    // ---------------------------------------------------------------------
+    // Work-stealing pool vs. the shared-queue io_context.
+    // ---------------------------------------------------------------------
+
+    constexpr size_t   SKEWED_SENSOR_COUNT       = 64;
+    constexpr size_t   SKEWED_EVENT_COUNT        = 100000;
+    constexpr double   SKEWED_ZIPF_EXPONENT      = 1.2;
+    constexpr size_t   HOT_SENSOR_COUNT          = 4;
+    constexpr size_t   HOT_SENSOR_FAN_OUT        = 8;
+    constexpr uint32_t READING_WORK_ITERATIONS   = 200;
+    constexpr uint32_t FOLLOW_ON_WORK_ITERATIONS = 800;
+
+    struct SkewedLoad_t
+    {
+        std::vector<uint8_t>  m_EventSensors;
+        size_t                m_TotalTasks{0};
+    };
+
+    size_t FanOutOf(const size_t& sensor)
+    {
+        // Hot sensors trigger a burst of follow-on analytics per reading.
+        return (sensor < HOT_SENSOR_COUNT) ? HOT_SENSOR_FAN_OUT : 1;
+    }
+
+    SkewedLoad_t MakeSkewedLoad()
+    {
+        // Zipf-distributed sensor popularity: sensor 0 is the hottest.
+        std::vector<double> weights(SKEWED_SENSOR_COUNT);
+        for (size_t i = 0; i < weights.size(); i++)
+        {
+            weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), SKEWED_ZIPF_EXPONENT);
+        }
+
+        std::mt19937 generator(20261017);
+        std::discrete_distribution<size_t> distribution(weights.begin(), weights.end());
+
+        SkewedLoad_t load;
+        load.m_EventSensors.reserve(SKEWED_EVENT_COUNT);
+        for (size_t i = 0; i < SKEWED_EVENT_COUNT; i++)
+        {
+            auto sensor = distribution(generator);
+            load.m_EventSensors.push_back(static_cast<uint8_t>(sensor));
+            load.m_TotalTasks += 1 + FanOutOf(sensor);
+        }
+        return load;
+    }
+
+    struct SkewedLoadRun_t
+    {
+        std::vector<uint64_t>  m_QueueingLatencies;
+        std::atomic<size_t>    m_NextSample{0};
+        std::atomic<size_t>    m_Remaining{0};
+
+        void Record(const SteadyClock_t::time_point& submitted)
+        {
+            auto index = m_NextSample.fetch_add(1, std::memory_order_relaxed);
+            m_QueueingLatencies[index] = NanosecondsSince(submitted);
+        }
+
+        void Complete()
+        {
+            if (m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_Remaining.notify_all();
+            }
+        }
+    };
+
+    template <typename Executor>
+    void RunSkewedLoad(const std::string& variant, const Executor& executor,
+                       const SkewedLoad_t& load)
+    {
+        SkewedLoadRun_t run;
+        run.m_QueueingLatencies.resize(load.m_TotalTasks);
+        run.m_Remaining.store(load.m_TotalTasks);
+
+        auto startTime = SteadyClock_t::now();
+
+        for (auto sensor : load.m_EventSensors)
+        {
+            auto submitted = SteadyClock_t::now();
+            asio::post(executor, [&run, &executor, sensor, submitted]()
+            {
+                run.Record(submitted);
+                Spin(READING_WORK_ITERATIONS);
+
+                for (size_t i = 0; i < FanOutOf(sensor); i++)
+                {
+                    auto followOnSubmitted = SteadyClock_t::now();
+                    asio::post(executor, [&run, followOnSubmitted]()
+                    {
+                        run.Record(followOnSubmitted);
+                        Spin(FOLLOW_ON_WORK_ITERATIONS);
+                        run.Complete();
+                    });
+                }
+                run.Complete();
+            });
+        }
+
+        for (auto remaining = run.m_Remaining.load(); remaining != 0;
+             remaining = run.m_Remaining.load())
+        {
+            run.m_Remaining.wait(remaining);
+        }
+
+        auto elapsed = std::chrono::duration<double>(SteadyClock_t::now() - startTime).count();
+
+        std::cout << std::left << std::setw(24) << variant
+                  << " tasks/s=" << std::setw(12) << static_cast<uint64_t>(load.m_TotalTasks / elapsed)
+                  << " queueing p50=" << std::setw(10) << Percentile(run.m_QueueingLatencies, 0.50)
+                  << " p99=" << std::setw(10) << Percentile(run.m_QueueingLatencies, 0.99)
+                  << " (ns)\n";
+    }
+
+    void BenchmarkWorkStealing()
+    {
+        auto numberOfThreads = std::max(2u, std::thread::hardware_concurrency());
+        auto load = MakeSkewedLoad();
+
+        std::cout << "[INFO] workstealing: " << load.m_EventSensors.size() << " readings, "
+                  << load.m_TotalTasks << " tasks, " << numberOfThreads << " threads, zipf s="
+                  << SKEWED_ZIPF_EXPONENT << "\n";
+
+        {
+            asio::io_context ioContext;
+            auto work = asio::make_work_guard(ioContext);
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < numberOfThreads; i++)
+            {
+                threads.emplace_back([&ioContext]() { ioContext.run(); });
+            }
+
+            RunSkewedLoad("io_context (shared)", ioContext.get_executor(), load);
+
+            work.reset();
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        {
+            WorkStealingPool pool(numberOfThreads, "Bench");
+            RunSkewedLoad("WorkStealingPool", pool.get_executor(), load);
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Latency of the high priority class under a saturating bulk load.
+    // ---------------------------------------------------------------------
+
+    constexpr size_t   SATURATING_BULK_BACKLOG       = 20000;
+    constexpr uint32_t BULK_WORK_ITERATIONS          = 400;
+    constexpr size_t   HIGH_PRIORITY_SAMPLES         = 500;
+    constexpr auto     HIGH_PRIORITY_PERIOD          = std::chrono::milliseconds(2);
+
+    template <typename BulkExecutor, typename HighExecutor>
+    void RunSaturated(const std::string& variant, asio::io_context& ioContext,
+                      const BulkExecutor& bulkExecutor, const HighExecutor& highExecutor)
+    {
+        std::atomic<bool> isSaturating{true};
+        std::atomic<size_t> bulkInFlight{0};
+
+        // Each bulk task re-posts itself, so the backlog stays constant.
+        std::function<void()> bulkTask;
+        bulkTask = [&]()
+        {
+            Spin(BULK_WORK_ITERATIONS);
+            if (isSaturating.load(std::memory_order_relaxed))
+            {
+                asio::post(bulkExecutor, bulkTask);
+            }
+            else
+            {
+                bulkInFlight.fetch_sub(1, std::memory_order_relaxed);
+            }
+        };
+
+        bulkInFlight.store(SATURATING_BULK_BACKLOG);
+        for (size_t i = 0; i < SATURATING_BULK_BACKLOG; i++)
+        {
+            asio::post(bulkExecutor, bulkTask);
+        }
+
+        std::thread dispatcher([&ioContext]() { ioContext.run(); });
+
+        std::vector<uint64_t> latencies(HIGH_PRIORITY_SAMPLES);
+        std::atomic<size_t> completed{0};
+
+        for (size_t i = 0; i < HIGH_PRIORITY_SAMPLES; i++)
+        {
+            auto submitted = SteadyClock_t::now();
+            asio::post(highExecutor, [&latencies, &completed, i, submitted]()
+            {
+                latencies[i] = NanosecondsSince(submitted);
+                completed.fetch_add(1, std::memory_order_release);
+            });
+            std::this_thread::sleep_for(HIGH_PRIORITY_PERIOD);
+        }
+
+        // Let the backlog drain so that every high priority sample lands.
+        isSaturating.store(false);
+        while ((completed.load(std::memory_order_acquire) < HIGH_PRIORITY_SAMPLES)
+            || (bulkInFlight.load(std::memory_order_relaxed) > 0))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        ioContext.stop();
+        dispatcher.join();
+
+        auto max = *std::max_element(latencies.begin(), latencies.end());
+        std::cout << std::left << std::setw(24) << variant
+                  << " high priority p50=" << std::setw(10) << Percentile(latencies, 0.50)
+                  << " p99=" << std::setw(10) << Percentile(latencies, 0.99)
+                  << " max=" << std::setw(10) << max
+                  << " (ns)\n";
+    }
+
+    void BenchmarkPriority()
+    {
+        std::cout << "[INFO] priority: " << SATURATING_BULK_BACKLOG << " bulk handlers queued, "
+                  << HIGH_PRIORITY_SAMPLES << " high priority handlers, 1 dispatcher thread\n";
+
+        {
+            asio::io_context ioContext;
+            auto work = asio::make_work_guard(ioContext);
+            RunSaturated("io_context (FIFO)", ioContext,
+                         ioContext.get_executor(), ioContext.get_executor());
+        }
+
+        {
+            asio::io_context ioContext;
+            auto work = asio::make_work_guard(ioContext);
+            PriorityScheduler scheduler(ioContext);
+            RunSaturated("PriorityScheduler", ioContext,
+                         scheduler.get_executor(HandlerPriority_t::BULK),
+                         scheduler.get_executor(HandlerPriority_t::DISPLAY));
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Per-reading clock reads vs. one cached clock read per batch.
+    // ---------------------------------------------------------------------
+
+    constexpr size_t CLOCK_READING_COUNT = 4000000;
+    constexpr size_t CLOCK_BATCH_SIZES[] = {8, 64, 256};
+
+    template <typename Function>
+    void TimePerReading(const std::string& variant, const size_t& clockReads,
+                        Function&& function)
+    {
+        auto startTime = SteadyClock_t::now();
+        uint64_t sink = 0;
+        for (size_t i = 0; i < CLOCK_READING_COUNT; i++)
+        {
+            sink += function(i);
+        }
+        auto elapsed = NanosecondsSince(startTime);
+        g_Sink.fetch_add(sink & 1, std::memory_order_relaxed);
+
+        std::cout << std::left << std::setw(32) << variant
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / CLOCK_READING_COUNT)
+                  << " ns/reading, clock reads=" << clockReads << "\n";
+    }
+
+    void BenchmarkClock()
+    {
+        std::cout << "[INFO] clock: " << CLOCK_READING_COUNT
+                  << " readings timestamped, staleness checked\n";
+
+        auto staleness = std::chrono::minutes(STALE_READING_DURATION_MINUTES);
+
+        // Before: the wall clock upon receipt, the steady clock for the
+        // token bucket, and the wall clock again for staleness.
+        TimePerReading("system+steady+system (before)", 3 * CLOCK_READING_COUNT,
+        [&staleness](const size_t&)
+        {
+            auto readingTime = SystemClock_t::now();
+            auto bucketTime = SteadyClock_t::now();
+            bool isFresh = (SystemClock_t::now() - readingTime) < staleness;
+            return static_cast<uint64_t>(isFresh)
+                 + static_cast<uint64_t>(bucketTime.time_since_epoch().count() & 1);
+        });
+
+        TimePerReading("steady per reading", CLOCK_READING_COUNT,
+        [&staleness](const size_t&)
+        {
+            auto readingTime = Utility::CoarseClock::Refresh();
+            auto bucketTime = Utility::CoarseClock::Now();
+            bool isFresh = (bucketTime - readingTime) < staleness;
+            return static_cast<uint64_t>(isFresh);
+        });
+
+        for (const auto& batchSize : CLOCK_BATCH_SIZES)
+        {
+            TimePerReading("cached, refreshed per " + std::to_string(batchSize),
+                           CLOCK_READING_COUNT / batchSize,
+            [&staleness, batchSize](const size_t& i)
+            {
+                if ((i % batchSize) == 0)
+                {
+                    Utility::CoarseClock::Refresh();
+                }
+                auto readingTime = Utility::CoarseClock::Now();
+                auto bucketTime = Utility::CoarseClock::Now();
+                bool isFresh = (bucketTime - readingTime) < staleness;
+                return static_cast<uint64_t>(isFresh);
+            });
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Cost of recording one flight recorder event.
+    // ---------------------------------------------------------------------
+
+    constexpr size_t FLIGHT_RECORDER_BENCHMARK_EVENTS = 10000000;
+
+    void BenchmarkFlightRecorder()
+    {
+        std::cout << "[INFO] flightrecorder: " << FLIGHT_RECORDER_BENCHMARK_EVENTS
+                  << " spans recorded on 1 thread\n";
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t i = 0; i < FLIGHT_RECORDER_BENCHMARK_EVENTS; i++)
+        {
+            FlightRecorder::Span_t span(FlightRecorder::Event_t::PARSE,
+                                        static_cast<uint32_t>(i));
+        }
+        auto elapsed = NanosecondsSince(startTime);
+
+        std::cout << std::left << std::setw(32) << "Span_t"
+                  << " " << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / FLIGHT_RECORDER_BENCHMARK_EVENTS)
+                  << " ns/event\n";
+
+        startTime = SteadyClock_t::now();
+        auto isDumped = FlightRecorder::DumpChromeTrace("/tmp/PerformanceBenchmarks.trace.json");
+        std::cout << std::left << std::setw(32) << "DumpChromeTrace"
+                  << " " << (NanosecondsSince(startTime) / 1000)
+                  << " us (" << FLIGHT_RECORDER_EVENTS_PER_THREAD << " events)"
+                  << (isDumped ? "" : " FAILED") << "\n";
+    }
+
+    // ---------------------------------------------------------------------
+    // Hardware counters per reading: parse and aggregate stages.
+    // ---------------------------------------------------------------------
+
+    constexpr size_t PERF_READING_COUNT  = 1000000;
+    constexpr size_t PERF_SENSOR_COUNT   = 64;
+
+    template <typename Function>
+    void CountPerReading(const std::string& variant, const PerfCounterGroup& group,
+                         Function&& function)
+    {
+        PerfCounterGroup::Sample_t start{};
+        PerfCounterGroup::Sample_t end{};
+
+        auto isCounted = group.Read(start);
+        auto startTime = SteadyClock_t::now();
+        for (size_t i = 0; i < PERF_READING_COUNT; i++)
+        {
+            function(i);
+        }
+        auto elapsed = NanosecondsSince(startTime);
+        isCounted = isCounted && group.Read(end);
+
+        std::cout << std::left << std::setw(24) << variant << " " << std::fixed << std::setprecision(2)
+                  << std::setw(8) << (static_cast<double>(elapsed) / PERF_READING_COUNT) << " ns";
+
+        if (isCounted)
+        {
+            auto perReading = [&start, &end](const PerfCounterGroup::Counter_t& counter)
+            {
+                return static_cast<double>(end[counter] - start[counter]) / PERF_READING_COUNT;
+            };
+
+            std::cout << " cycles=" << std::setw(8) << perReading(PerfCounterGroup::CYCLES)
+                      << " instructions=" << std::setw(8) << perReading(PerfCounterGroup::INSTRUCTIONS)
+                      << " cache_misses=" << std::setprecision(4) << std::setw(8) << perReading(PerfCounterGroup::CACHE_MISSES)
+                      << " branch_misses=" << std::setw(8) << perReading(PerfCounterGroup::BRANCH_MISSES);
+        }
+        std::cout << " (per reading)\n";
+    }
+
+    void BenchmarkPerf()
+    {
+        PerfCounterGroup group;
+
+        std::cout << "[INFO] perf: " << PERF_READING_COUNT << " readings, " << PERF_SENSOR_COUNT
+                  << " sensors, hardware counters "
+                  << (group.IsAvailable() ? "available" : "UNAVAILABLE (timings only)") << "\n";
+
+        std::vector<std::string> readings;
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> temperatures(-50.0, 50.0);
+        for (size_t i = 0; i < 1024; i++)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << temperatures(generator) << "\r\n";
+            readings.push_back(oss.str());
+        }
+
+        double sum = 0.0;
+        CountPerReading("parse", group, [&readings, &sum](const size_t& i)
+        {
+            std::array<double, NUMBER_OF_SENSOR_CHANNELS> values{};
+            Utility::ParseSensorReading(readings[i % readings.size()], values);
+            sum += values[static_cast<size_t>(SensorChannel_t::TEMPERATURE)];
+        });
+
+        SensorTable table(PERF_SENSOR_COUNT);
+        auto timeNow = Utility::CoarseClock::Refresh();
+        CountPerReading("aggregate", group, [&table, &timeNow](const size_t& i)
+        {
+            table.Update(i % PERF_SENSOR_COUNT, static_cast<double>(i & 0xFF), timeNow);
+        });
+
+        g_Sink.fetch_add(static_cast<uint64_t>(sum) & 1, std::memory_order_relaxed);
+    }
+
+    // ---------------------------------------------------------------------
+    // Incremental aggregation policies vs. sweeping every sensor.
+    // ---------------------------------------------------------------------
+
+    // A small site, and a large one whose display would sweep many more
+    // sensors than it has readings to show.
+    constexpr size_t AGGREGATION_SENSOR_COUNTS[]   = {64, 16384};
+    constexpr size_t AGGREGATION_READING_COUNT     = 2000000;
+    constexpr size_t AGGREGATION_DISPLAY_INTERVAL  = 1000; // Readings per display.
+
+    struct AggregationLoad_t
+    {
+        std::vector<uint32_t>                    m_Sensors;
+        std::vector<double>                      m_Temperatures;
+        std::vector<SteadyClock_t::time_point>   m_ReadingTimes;
+    };
+
+    AggregationLoad_t MakeAggregationLoad(const size_t& numberOfSensors)
+    {
+        // One reading per millisecond, thus 2000 s in all. The last eighth
+        // of the sensors fall silent after 100 s, and are stale from 700 s.
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> allSensors(0, static_cast<uint32_t>(numberOfSensors - 1));
+        std::uniform_int_distribution<uint32_t> talkativeSensors(
+            0, static_cast<uint32_t>(numberOfSensors - numberOfSensors / 8 - 1));
+        std::uniform_real_distribution<double> temperatures(-50.0, 50.0);
+
+        AggregationLoad_t load;
+        auto readingTime = SteadyClock_t::now();
+        for (size_t i = 0; i < AGGREGATION_READING_COUNT; i++)
+        {
+            load.m_Sensors.push_back((i < 100000) ? allSensors(generator) : talkativeSensors(generator));
+            load.m_Temperatures.push_back(temperatures(generator));
+            load.m_ReadingTimes.push_back(readingTime);
+            readingTime += std::chrono::milliseconds(1);
+        }
+        return load;
+    }
+
+    // What DisplayTemperatureData() did before: keep the latest reading of
+    // each sensor, and average the fresh ones upon every display.
+    class SweepMean
+    {
+    public:
+        explicit SweepMean(const size_t& numberOfSensors)
+            : m_Sensors(numberOfSensors)
+        {
+        }
+
+        void Update(const size_t& sensorNodeNumber, const double& temperature,
+                    const SteadyClock_t::time_point& readingTime)
+        {
+            m_Sensors[sensorNodeNumber] = {true, temperature, readingTime};
+        }
+
+        double Result(const SteadyClock_t::time_point& timeNow) const
+        {
+            double sum = 0.0;
+            size_t count = 0;
+            for (const auto& sensor : m_Sensors)
+            {
+                if (sensor.m_HasReading && Utility::IsFresh(sensor.m_ReadingTime, timeNow))
+                {
+                    sum += sensor.m_Temperature;
+                    ++count;
+                }
+            }
+            return (count > 0) ? (sum / static_cast<double>(count)) : 0.0;
+        }
+
+    private:
+        struct Sensor_t
+        {
+            bool                       m_HasReading{false};
+            double                     m_Temperature{0.0};
+            SteadyClock_t::time_point  m_ReadingTime{};
+        };
+
+        std::vector<Sensor_t>   m_Sensors;
+    };
+
+    // A customer's own policy, written naively; static dispatch must make
+    // it cost no more than the built-in ones.
+    struct CustomMeanAggregation_t
+    {
+        explicit CustomMeanAggregation_t(const size_t& numberOfSensors)
+        {
+        }
+
+        void Add(const size_t& sensorNodeNumber, const double& temperature)
+        {
+            m_Sum += temperature;
+            ++m_Count;
+        }
+
+        void Remove(const size_t& sensorNodeNumber, const double& temperature)
+        {
+            m_Sum -= temperature;
+            --m_Count;
+        }
+
+        Aggregate_t Result() const
+        {
+            Aggregate_t aggregate;
+            aggregate.m_Count = m_Count;
+            aggregate.m_Value = (m_Count > 0) ? (m_Sum / static_cast<double>(m_Count)) : 0.0;
+            return aggregate;
+        }
+
+        double   m_Sum{0.0};
+        size_t   m_Count{0};
+    };
+
+    // Returns the displayed value upon every AGGREGATION_DISPLAY_INTERVAL.
+    template <typename Update, typename Display>
+    std::vector<double> TimeAggregation(const std::string& variant, const AggregationLoad_t& load,
+                                        Update&& update, Display&& display,
+                                        const std::vector<double>& reference)
+    {
+        std::vector<double> displayed;
+        displayed.reserve(AGGREGATION_READING_COUNT / AGGREGATION_DISPLAY_INTERVAL);
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t i = 0; i < AGGREGATION_READING_COUNT; i++)
+        {
+            update(load.m_Sensors[i], load.m_Temperatures[i], load.m_ReadingTimes[i]);
+            if ((i % AGGREGATION_DISPLAY_INTERVAL) == AGGREGATION_DISPLAY_INTERVAL - 1)
+            {
+                displayed.push_back(display(load.m_ReadingTimes[i]));
+            }
+        }
+        auto elapsed = NanosecondsSince(startTime);
+
+        std::cout << std::left << std::setw(32) << variant
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / AGGREGATION_READING_COUNT) << " ns/reading";
+
+        if (!reference.empty())
+        {
+            double maximumError = 0.0;
+            for (size_t i = 0; i < displayed.size(); i++)
+            {
+                maximumError = std::max(maximumError, std::fabs(displayed[i] - reference[i]));
+            }
+            std::cout << ", max |error| vs sweep=" << std::scientific << std::setprecision(1)
+                      << maximumError;
+        }
+        std::cout << "\n";
+        return displayed;
+    }
+
+    template <typename Policy, std::size_t SENSOR_COUNT = DYNAMIC_SENSOR_COUNT>
+    std::vector<double> TimePolicy(const std::string& variant, const size_t& numberOfSensors,
+                                   const AggregationLoad_t& load, const std::vector<double>& reference)
+    {
+        IncrementalAggregator<Policy, SENSOR_COUNT> aggregator(numberOfSensors);
+        return TimeAggregation(variant, load,
+            [&aggregator](const size_t& sensor, const double& temperature,
+                          const SteadyClock_t::time_point& readingTime)
+            {
+                aggregator.Update(sensor, temperature, readingTime);
+            },
+            [&aggregator](const SteadyClock_t::time_point& timeNow)
+            {
+                aggregator.Expire(timeNow);
+                return aggregator.Result().m_Value;
+            },
+            reference);
+    }
+
+    void BenchmarkAggregation()
+    {
+        for (const auto& numberOfSensors : AGGREGATION_SENSOR_COUNTS)
+        {
+            std::cout << "[INFO] aggregation: " << AGGREGATION_READING_COUNT << " readings, "
+                      << numberOfSensors << " sensors, one display per "
+                      << AGGREGATION_DISPLAY_INTERVAL << " readings\n";
+
+            auto load = MakeAggregationLoad(numberOfSensors);
+
+            SweepMean sweep(numberOfSensors);
+            auto reference = TimeAggregation("sweep mean (before)", load,
+                [&sweep](const size_t& sensor, const double& temperature,
+                         const SteadyClock_t::time_point& readingTime)
+                {
+                    sweep.Update(sensor, temperature, readingTime);
+                },
+                [&sweep](const SteadyClock_t::time_point& timeNow)
+                {
+                    return sweep.Result(timeNow);
+                },
+                {});
+
+            // With all zones weighted alike, the weighted mean is the mean.
+            TimePolicy<MeanAggregation_t>("MeanAggregation_t", numberOfSensors, load, reference);
+            if (numberOfSensors == AGGREGATION_SENSOR_COUNTS[0])
+            {
+                // As the embedded deployment, at a fixed SENSOR_COUNT.
+                TimePolicy<MeanAggregation_t, AGGREGATION_SENSOR_COUNTS[0]>(
+                    "MeanAggregation_t (fixed count)", numberOfSensors, load, reference);
+            }
+            TimePolicy<CustomMeanAggregation_t>("CustomMeanAggregation_t", numberOfSensors, load, reference);
+            TimePolicy<WeightedMeanAggregation_t<>>("WeightedMeanAggregation_t<>", numberOfSensors, load, reference);
+            TimePolicy<TrimmedMeanAggregation_t<10>>("TrimmedMeanAggregation_t<10>", numberOfSensors, load, {});
+            TimePolicy<EnvelopeAggregation_t>("EnvelopeAggregation_t", numberOfSensors, load, {});
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Calibration: branching per reading, and blocks of readings gathered
+    // into separate coefficient arrays for SIMD, against the branchless
+    // single pass of Calibration::Apply().
+    // ---------------------------------------------------------------------
+    constexpr size_t CALIBRATION_SENSOR_COUNT  = 16384;
+    constexpr size_t CALIBRATION_READING_COUNT = 4000000;
+    constexpr size_t CALIBRATION_BLOCK_SIZE    = 16;
+    constexpr std::string_view CALIBRATION_BENCHMARK_PATH = "/tmp/PerformanceBenchmarks.calibration";
+
+    struct SensorCalibration_t
+    {
+        double   m_Gain;
+        double   m_Offset;
+        double   m_Minimum;
+        double   m_Maximum;
+    };
+
+    size_t CalibratePerReading(const std::vector<SensorCalibration_t>& calibrations,
+                               ReadingRecord_t* pRecords, const size_t& count)
+    {
+        size_t remaining = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto& calibration = calibrations[pRecords[i].m_SensorNodeNumber];
+            auto temperature = (pRecords[i].m_Value * calibration.m_Gain) + calibration.m_Offset;
+            if ((temperature >= calibration.m_Minimum) && (temperature <= calibration.m_Maximum))
+            {
+                pRecords[remaining] = pRecords[i];
+                pRecords[remaining].m_Value = temperature;
+                ++remaining;
+            }
+        }
+        return remaining;
+    }
+
+    struct CalibrationArrays_t
+    {
+        std::vector<double>   m_Gains;
+        std::vector<double>   m_Offsets;
+        std::vector<double>   m_Minimums;
+        std::vector<double>   m_Maximums;
+    };
+
+    size_t CalibrateInBlocks(const CalibrationArrays_t& arrays, ReadingRecord_t* pRecords, const size_t& count)
+    {
+        alignas(64) double temperatures[CALIBRATION_BLOCK_SIZE]{};
+        alignas(64) double gains[CALIBRATION_BLOCK_SIZE]{};
+        alignas(64) double offsets[CALIBRATION_BLOCK_SIZE]{};
+        alignas(64) double minimums[CALIBRATION_BLOCK_SIZE]{};
+        alignas(64) double maximums[CALIBRATION_BLOCK_SIZE]{};
+        alignas(64) uint8_t isInRange[CALIBRATION_BLOCK_SIZE]{};
+
+        size_t remaining = 0;
+        for (size_t first = 0; first < count; first += CALIBRATION_BLOCK_SIZE)
+        {
+            auto length = std::min(CALIBRATION_BLOCK_SIZE, count - first);
+            auto pBlock = pRecords + first;
+
+            for (size_t i = 0; i < length; i++)
+            {
+                auto sensorNodeNumber = pBlock[i].m_SensorNodeNumber;
+                temperatures[i] = pBlock[i].m_Value;
+                gains[i]        = arrays.m_Gains[sensorNodeNumber];
+                offsets[i]      = arrays.m_Offsets[sensorNodeNumber];
+                minimums[i]     = arrays.m_Minimums[sensorNodeNumber];
+                maximums[i]     = arrays.m_Maximums[sensorNodeNumber];
+            }
+
+            // Contiguous, branchless and of constant trip count; vectorized.
+            for (size_t i = 0; i < CALIBRATION_BLOCK_SIZE; i++)
+            {
+                temperatures[i] = (temperatures[i] * gains[i]) + offsets[i];
+                isInRange[i] = (temperatures[i] >= minimums[i]) & (temperatures[i] <= maximums[i]);
+            }
+
+            for (size_t i = 0; i < length; i++)
+            {
+                pRecords[remaining] = pBlock[i];
+                pRecords[remaining].m_Value = temperatures[i];
+                remaining += isInRange[i];
+            }
+        }
+        return remaining;
+    }
+
+    template <typename Calibrate>
+    void TimeCalibration(const std::string& variant, const std::vector<ReadingRecord_t>& load,
+                         Calibrate&& calibrate)
+    {
+        std::vector<ReadingRecord_t> batch(INGEST_BATCH_SIZE);
+        size_t remaining = 0;
+        double checksum = 0.0;
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t first = 0; first < load.size(); first += INGEST_BATCH_SIZE)
+        {
+            // As drained from an ingest ring.
+            std::copy(load.begin() + first, load.begin() + first + INGEST_BATCH_SIZE, batch.begin());
+            auto count = calibrate(batch.data(), INGEST_BATCH_SIZE);
+            remaining += count;
+            for (size_t i = 0; i < count; i++)
+            {
+                checksum += batch[i].m_Value;
+            }
+        }
+        auto elapsed = NanosecondsSince(startTime);
+
+        std::cout << std::left << std::setw(32) << variant
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / load.size()) << " ns/reading, "
+                  << remaining << " in range, checksum=" << std::setprecision(3) << checksum << "\n";
+    }
+
+    void BenchmarkCalibration()
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> sensors(0, CALIBRATION_SENSOR_COUNT - 1);
+        std::uniform_real_distribution<double> gains(0.95, 1.05);
+        std::uniform_real_distribution<double> offsets(-1.0, 1.0);
+
+        // Every sensor calibrated; every eighth with a narrower range.
+        std::vector<SensorCalibration_t> calibrations(CALIBRATION_SENSOR_COUNT);
+        CalibrationArrays_t arrays;
+        {
+            std::ofstream file{std::string(CALIBRATION_BENCHMARK_PATH), std::ios::trunc};
+            for (size_t i = 0; i < CALIBRATION_SENSOR_COUNT; i++)
+            {
+                auto narrow = ((i % 8) == 0);
+                calibrations[i] = {gains(generator), offsets(generator),
+                                   narrow ? -40.0 : CALIBRATION_DEFAULT_MINIMUM_TEMPERATURE,
+                                   narrow ?  40.0 : CALIBRATION_DEFAULT_MAXIMUM_TEMPERATURE};
+                file << i << std::setprecision(17) << ' ' << calibrations[i].m_Gain << ' '
+                     << calibrations[i].m_Offset << ' ' << calibrations[i].m_Minimum << ' '
+                     << calibrations[i].m_Maximum << '\n';
+
+                arrays.m_Gains.push_back(calibrations[i].m_Gain);
+                arrays.m_Offsets.push_back(calibrations[i].m_Offset);
+                arrays.m_Minimums.push_back(calibrations[i].m_Minimum);
+                arrays.m_Maximums.push_back(calibrations[i].m_Maximum);
+            }
+        }
+
+        Calibration calibration(CALIBRATION_SENSOR_COUNT);
+        if (!calibration.Load(CALIBRATION_BENCHMARK_PATH))
+        {
+            return;
+        }
+
+        std::uniform_real_distribution<double> temperatures(-50.0, 50.0);
+        std::vector<ReadingRecord_t> load(CALIBRATION_READING_COUNT);
+        auto readingTime = SteadyClock_t::now();
+        for (auto& record : load)
+        {
+            record = {sensors(generator), SensorChannel_t::TEMPERATURE, readingTime, temperatures(generator)};
+        }
+
+        std::cout << "[INFO] calibration: " << CALIBRATION_READING_COUNT << " readings, "
+                  << CALIBRATION_SENSOR_COUNT << " sensors, batches of " << INGEST_BATCH_SIZE << "\n";
+
+        TimeCalibration("none (copy and checksum only)", load,
+            [](ReadingRecord_t* pRecords, const size_t& count)
+            {
+                return count;
+            });
+
+        TimeCalibration("branching, per reading", load,
+            [&calibrations](ReadingRecord_t* pRecords, const size_t& count)
+            {
+                return CalibratePerReading(calibrations, pRecords, count);
+            });
+
+        TimeCalibration("SIMD blocks of 16", load,
+            [&arrays](ReadingRecord_t* pRecords, const size_t& count)
+            {
+                return CalibrateInBlocks(arrays, pRecords, count);
+            });
+
+        TimeCalibration("Calibration::Apply", load,
+            [&calibration](ReadingRecord_t* pRecords, const size_t& count)
+            {
+                return calibration.Apply(pRecords, count);
+            });
+    }
+
+    // ---------------------------------------------------------------------
+    // Anomaly detection: the cost per reading of AnomalyDetector::Detect(),
+    // against the 1000 ns per reading that ingesting 1M readings/s on one
+    // aggregation thread affords in all.
+    // ---------------------------------------------------------------------
+    constexpr size_t ANOMALY_SENSOR_COUNT  = 16384;
+    constexpr size_t ANOMALY_READING_COUNT = 4000000;
+    constexpr size_t ANOMALY_SPIKE_PERIOD  = 10000;
+
+    void BenchmarkAnomaly()
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> sensors(0, ANOMALY_SENSOR_COUNT - 1);
+        std::uniform_real_distribution<double> baselines(18.0, 24.0);
+        std::normal_distribution<double> noise(0.0, 0.3);
+
+        std::vector<double> baseline(ANOMALY_SENSOR_COUNT);
+        for (auto& temperature : baseline)
+        {
+            temperature = baselines(generator);
+        }
+
+        // 1M readings/s, one in every ANOMALY_SPIKE_PERIOD of them a spike.
+        std::vector<ReadingRecord_t> load(ANOMALY_READING_COUNT);
+        auto readingTime = SteadyClock_t::now();
+        for (size_t i = 0; i < load.size(); i++)
+        {
+            auto sensorNodeNumber = sensors(generator);
+            auto spike = ((i % ANOMALY_SPIKE_PERIOD) == 0) ? 20.0 : 0.0;
+            load[i] = {sensorNodeNumber, SensorChannel_t::TEMPERATURE, readingTime + std::chrono::microseconds(i),
+                       baseline[sensorNodeNumber] + noise(generator) + spike};
+        }
+
+        std::cout << "[INFO] anomaly: " << ANOMALY_READING_COUNT << " readings, "
+                  << ANOMALY_SENSOR_COUNT << " sensors, batches of " << INGEST_BATCH_SIZE << "\n";
+
+        AnomalyDetector detector(ANOMALY_SENSOR_COUNT);
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t first = 0; first < load.size(); first += INGEST_BATCH_SIZE)
+        {
+            detector.Detect(load.data() + first, INGEST_BATCH_SIZE);
+
+            // As the display tick would, were it this frequent.
+            if (((first / INGEST_BATCH_SIZE) % 64) == 0)
+            {
+                detector.Collect();
+            }
+        }
+        auto elapsed = NanosecondsSince(startTime);
+        auto history = detector.History().size();
+
+        std::cout << std::left << std::setw(32) << "AnomalyDetector::Detect"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / load.size()) << " ns/reading\n";
+        std::cout << std::left << std::setw(32) << "events"
+                  << " zscore=" << Metrics::Counter("anomaly.zscore").load()
+                  << " rate=" << Metrics::Counter("anomaly.rate").load()
+                  << " zone=" << Metrics::Counter("anomaly.zone").load()
+                  << " dropped=" << Metrics::Counter("anomaly.events.dropped").load()
+                  << " history=" << history << "\n";
+    }
+
+    // ---------------------------------------------------------------------
+    // Alert rules: the cost per reading to the ingest pipeline of flagging
+    // the inputs that it touches, and the cost of one evaluation with every
+    // input changed against one with none changed.
+    // ---------------------------------------------------------------------
+    constexpr size_t ALERT_SENSOR_COUNT  = 16384;
+    constexpr size_t ALERT_READING_COUNT = 4000000;
+    constexpr size_t ALERT_SENSOR_RULES  = 64;
+    constexpr size_t ALERT_EVALUATIONS   = 1000;
+
+    // Evaluate() is otherwise driven by the engine's own timer.
+    struct BenchmarkAlertRuleEngine : public AlertRuleEngine
+    {
+        using AlertRuleEngine::AlertRuleEngine;
+        using AlertRuleEngine::Evaluate;
+    };
+
+    void BenchmarkAlerts()
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> sensors(0, ALERT_SENSOR_COUNT - 1);
+        std::uniform_real_distribution<double> temperatures(18.0, 24.0);
+
+        // A rule upon each zone, upon staleness and upon a few sensors,
+        // two rules sharing each sensor.
+        std::vector<AlertRuleDefinition_t> definitions;
+        for (size_t zone = 0; zone < NUMBER_OF_SENSOR_ZONES; zone++)
+        {
+            auto input = "zone:" + std::to_string(zone);
+            definitions.push_back({"zone" + std::to_string(zone) + "_hot", input, true, 35.0,
+                                   Minutes_t(2), ALERT_DEFAULT_HYSTERESIS, input + " > 35 for 2m"});
+        }
+        definitions.push_back({"many_stale", "stale_percent", true, 10.0, {}, ALERT_DEFAULT_HYSTERESIS,
+                               "stale_percent > 10"});
+        for (size_t i = 0; i < ALERT_SENSOR_RULES; i++)
+        {
+            auto input = "sensor:" + std::to_string(i * 2);
+            definitions.push_back({"high" + std::to_string(i), input, true, 23.5, {},
+                                   ALERT_DEFAULT_HYSTERESIS, input + " > 23.5"});
+            definitions.push_back({"low" + std::to_string(i), input, false, 18.5, {},
+                                   ALERT_DEFAULT_HYSTERESIS, input + " < 18.5"});
+        }
+
+        std::vector<ReadingRecord_t> load(ALERT_READING_COUNT);
+        auto readingTime = SteadyClock_t::now();
+        for (size_t i = 0; i < load.size(); i++)
+        {
+            load[i] = {sensors(generator), SensorChannel_t::TEMPERATURE, readingTime, temperatures(generator)};
+        }
+
+        std::cout << "[INFO] alerts: " << ALERT_READING_COUNT << " readings, " << ALERT_SENSOR_COUNT
+                  << " sensors, " << definitions.size() << " rules, batches of " << INGEST_BATCH_SIZE << "\n";
+
+        asio::io_context ioContext;
+        PriorityScheduler scheduler(ioContext);
+        SensorTable table(ALERT_SENSOR_COUNT);
+        for (const auto& record : load)
+        {
+            table.Update(record.m_SensorNodeNumber, record.m_Value, record.m_ReadingTime);
+        }
+
+        BenchmarkAlertRuleEngine engine(ioContext, scheduler.get_executor(HandlerPriority_t::ALERT),
+                                        table, ALERT_SENSOR_COUNT, definitions);
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t first = 0; first < load.size(); first += INGEST_BATCH_SIZE)
+        {
+            engine.Apply(load.data() + first, INGEST_BATCH_SIZE);
+        }
+        auto elapsed = NanosecondsSince(startTime);
+
+        std::cout << std::left << std::setw(32) << "AlertRuleEngine::Apply"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / load.size()) << " ns/reading\n";
+
+        // Every input is flagged by the readings above; a zone is flagged
+        // by any of its sensors, thus by almost any batch.
+        uint64_t changed = 0;
+        for (size_t i = 0; i < ALERT_EVALUATIONS; i++)
+        {
+            engine.Apply(load.data() + (i % (load.size() / INGEST_BATCH_SIZE)) * INGEST_BATCH_SIZE, INGEST_BATCH_SIZE);
+            startTime = SteadyClock_t::now();
+            engine.Evaluate(readingTime);
+            changed += NanosecondsSince(startTime);
+        }
+
+        uint64_t unchanged = 0;
+        for (size_t i = 0; i < ALERT_EVALUATIONS; i++)
+        {
+            startTime = SteadyClock_t::now();
+            engine.Evaluate(readingTime);
+            unchanged += NanosecondsSince(startTime);
+        }
+
+        std::cout << std::left << std::setw(32) << "Evaluate, batch flagged"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(changed) / ALERT_EVALUATIONS / 1000.0) << " us/evaluation\n";
+        std::cout << std::left << std::setw(32) << "Evaluate, nothing flagged"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(unchanged) / ALERT_EVALUATIONS / 1000.0) << " us/evaluation\n";
+        std::cout << std::left << std::setw(32) << "rules"
+                  << " evaluations=" << Metrics::Counter("alerts.evaluations").load()
+                  << " raised=" << Metrics::Counter("alerts.raised").load()
+                  << " firing=" << Metrics::Gauge("alerts.firing").load() << "\n";
+    }
+
+    // ---------------------------------------------------------------------
+    // Multi-channel readings: the cost of parsing one, and of ingesting it
+    // through the pipeline, against a temperature-only reading. A reading
+    // of N channels is N records, each applied to its channel's column.
+    // ---------------------------------------------------------------------
+    constexpr size_t CHANNELS_SENSOR_COUNT  = 16384;
+    constexpr size_t CHANNELS_READING_COUNT = 2000000;
+
+    void TimeChannelIngest(const std::string& variant, const std::vector<std::string>& lines)
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> sensors(0, CHANNELS_SENSOR_COUNT - 1);
+
+        SensorTable table(CHANNELS_SENSOR_COUNT);
+        IngestPipeline pipeline(table, nullptr);
+        pipeline.Start();
+
+        auto& aggregated = Metrics::Counter("aggregate.records");
+        auto aggregatedBefore = aggregated.load();
+
+        std::array<double, NUMBER_OF_SENSOR_CHANNELS> values{};
+        std::array<ReadingRecord_t, NUMBER_OF_SENSOR_CHANNELS> records;
+        size_t pushed = 0;
+
+        auto startTime = SteadyClock_t::now();
+        for (size_t i = 0; i < CHANNELS_READING_COUNT; i++)
+        {
+            auto channels = Utility::ParseSensorReading(lines[i % lines.size()], values);
+            auto sensorNodeNumber = sensors(generator);
+            size_t count = 0;
+            for (size_t channel = 0; channel < NUMBER_OF_SENSOR_CHANNELS; channel++)
+            {
+                if (channels & (1U << channel))
+                {
+                    records[count++] = {sensorNodeNumber, static_cast<SensorChannel_t>(channel),
+                                        startTime, values[channel]};
+                }
+            }
+
+            // As the I/O threads would, never waiting upon a full ring.
+            while (pipeline.PushBatch(records.data(), count) < count)
+            {
+                std::this_thread::yield();
+            }
+            pushed += count;
+        }
+        while ((aggregated.load() - aggregatedBefore) < pushed)
+        {
+            std::this_thread::yield();
+        }
+        auto elapsed = NanosecondsSince(startTime);
+        pipeline.Stop();
+
+        std::cout << std::left << std::setw(32) << variant
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / CHANNELS_READING_COUNT) << " ns/reading, "
+                  << std::setw(8) << (static_cast<double>(elapsed) / pushed) << " ns/record\n";
+    }
+
+    void BenchmarkChannels()
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_real_distribution<double> temperatures(18.0, 24.0);
+        std::uniform_real_distribution<double> humidities(30.0, 60.0);
+        std::uniform_real_distribution<double> pressures(990.0, 1030.0);
+
+        std::vector<std::string> bare;
+        std::vector<std::string> full;
+        for (size_t i = 0; i < 1024; i++)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2) << temperatures(generator);
+            bare.push_back(oss.str() + "\n");
+            oss << " humidity=" << humidities(generator) << " pressure=" << pressures(generator) << "\n";
+            full.push_back("temperature=" + oss.str());
+        }
+
+        std::cout << "[INFO] channels: " << CHANNELS_READING_COUNT << " readings, "
+                  << CHANNELS_SENSOR_COUNT << " sensors, one producer thread\n";
+
+        for (const auto& [variant, lines] : {std::pair{"parse, temperature only", &bare},
+                                             std::pair{"parse, three channels", &full}})
+        {
+            std::array<double, NUMBER_OF_SENSOR_CHANNELS> values{};
+            uint64_t sink = 0;
+            auto startTime = SteadyClock_t::now();
+            for (size_t i = 0; i < CHANNELS_READING_COUNT; i++)
+            {
+                sink += Utility::ParseSensorReading((*lines)[i % lines->size()], values);
+            }
+            auto elapsed = NanosecondsSince(startTime);
+            g_Sink.fetch_add(sink & 1, std::memory_order_relaxed);
+
+            std::cout << std::left << std::setw(32) << variant
+                      << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                      << (static_cast<double>(elapsed) / CHANNELS_READING_COUNT) << " ns/reading\n";
+        }
+
+        TimeChannelIngest("ingest, temperature only", bare);
+        TimeChannelIngest("ingest, three channels", full);
+    }
+
+    // ---------------------------------------------------------------------
+    // Site heatmap: the one-off cost of indexing a grid of a million cells,
+    // the cost per reading to the ingest pipeline of flagging its sensor,
+    // and the cost of one update with every sensor changed, with a few
+    // changed and with none changed.
+    // ---------------------------------------------------------------------
+    constexpr size_t HEATMAP_SENSOR_COUNT  = 4096;
+    constexpr size_t HEATMAP_READING_COUNT = 4000000;
+    constexpr size_t HEATMAP_UPDATES       = 20;
+
+    // Update() is otherwise driven by the heatmap's own timer.
+    struct BenchmarkSiteHeatmap : public SiteHeatmap
+    {
+        using SiteHeatmap::SiteHeatmap;
+        using SiteHeatmap::Update;
+    };
+
+    void BenchmarkHeatmap()
+    {
+        std::mt19937 generator(20261017);
+        std::uniform_int_distribution<uint32_t> sensors(0, HEATMAP_SENSOR_COUNT - 1);
+        std::uniform_real_distribution<double> coordinates(0.0, 200.0);
+        std::uniform_real_distribution<double> temperatures(18.0, 24.0);
+
+        // Sensors scattered over a site of 200 x 200 metres.
+        std::vector<SensorPosition_t> layout;
+        for (uint32_t sensor = 0; sensor < HEATMAP_SENSOR_COUNT; sensor++)
+        {
+            layout.push_back({sensor, coordinates(generator), coordinates(generator)});
+        }
+
+        std::vector<ReadingRecord_t> load(HEATMAP_READING_COUNT);
+        auto readingTime = SteadyClock_t::now();
+        for (size_t i = 0; i < load.size(); i++)
+        {
+            load[i] = {sensors(generator), SensorChannel_t::TEMPERATURE, readingTime, temperatures(generator)};
+        }
+
+        std::cout << "[INFO] heatmap: " << HEATMAP_GRID_WIDTH << "x" << HEATMAP_GRID_HEIGHT << " cells, "
+                  << HEATMAP_SENSOR_COUNT << " sensors, " << HEATMAP_NEIGHBOURS << " neighbours\n";
+
+        asio::io_context ioContext;
+        WorkStealingPool pool(1, "Bench");
+        SensorTable table(HEATMAP_SENSOR_COUNT);
+
+        auto startTime = SteadyClock_t::now();
+        BenchmarkSiteHeatmap heatmap(ioContext, pool.get_executor(),
+                                     table, HEATMAP_SENSOR_COUNT, layout);
+        std::cout << std::left << std::setw(32) << "index, nearest neighbours"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(NanosecondsSince(startTime)) / 1000000.0) << " ms\n";
+
+        startTime = SteadyClock_t::now();
+        for (size_t first = 0; first < load.size(); first += INGEST_BATCH_SIZE)
+        {
+            heatmap.Apply(load.data() + first, INGEST_BATCH_SIZE);
+        }
+        auto elapsed = NanosecondsSince(startTime);
+        std::cout << std::left << std::setw(32) << "SiteHeatmap::Apply"
+                  << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(elapsed) / load.size()) << " ns/reading\n";
+
+        // Every sensor changes between updates, then but a batch of them,
+        // then none.
+        auto timeUpdates = [&](const char* variant, const size_t& readingsPerUpdate)
+        {
+            uint64_t total = 0;
+            size_t cells = 0;
+            size_t next = 0;
+            for (size_t i = 0; i < HEATMAP_UPDATES; i++)
+            {
+                for (size_t j = 0; j < readingsPerUpdate; j++, next = (next + 1) % load.size())
+                {
+                    auto record = load[next];
+                    if (readingsPerUpdate >= HEATMAP_SENSOR_COUNT)
+                    {
+                        record.m_SensorNodeNumber = static_cast<uint32_t>(j % HEATMAP_SENSOR_COUNT);
+                    }
+                    record.m_Value += static_cast<double>(i);
+                    table.Update(record.m_SensorNodeNumber, record.m_Value, record.m_ReadingTime);
+                    heatmap.Apply(&record, 1);
+                }
+
+                startTime = SteadyClock_t::now();
+                cells += heatmap.Update(readingTime);
+                total += NanosecondsSince(startTime);
+            }
+
+            std::cout << std::left << std::setw(32) << variant
+                      << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                      << (static_cast<double>(total) / HEATMAP_UPDATES / 1000000.0) << " ms/update, "
+                      << (cells / HEATMAP_UPDATES) << " cells/update\n";
+        };
+
+        timeUpdates("Update, every sensor changed", HEATMAP_SENSOR_COUNT);
+        timeUpdates("Update, 16 sensors changed", 16);
+        timeUpdates("Update, nothing changed", 0);
+
+        auto summary = heatmap.Summary();
+        std::cout << std::left << std::setw(32) << "grid"
+                  << " fresh=" << summary.m_NumberOfFreshCells
+                  << " coldest=" << std::setprecision(1) << summary.m_Coldest
+                  << " hottest=" << summary.m_Hottest << "\n";
+    }
+
+    // ---------------------------------------------------------------------
+    // Sensor discovery: how long commissioning takes to probe a range of
+    // ports on localhost, some with a listener standing in for a sensor
+    // node, and how that scales with the connects allowed in flight.
+    // ---------------------------------------------------------------------
+    constexpr uint16_t DISCOVERY_FIRST_PORT     = 40000;
+    constexpr uint16_t DISCOVERY_LISTENER_COUNT = 10000;
+    constexpr uint16_t DISCOVERY_PORT_COUNT     = 12000;
+
+    void BenchmarkDiscovery()
+    {
+        asio::io_context ioContext;
+        auto work = asio::make_work_guard(ioContext);
+        PriorityScheduler scheduler(ioContext);
+        std::thread runner([&ioContext]() { ioContext.run(); });
+
+        // Connects complete upon the listener's handshake, without any
+        // accept; ports in use elsewhere are simply not listened upon.
+        std::vector<std::unique_ptr<tcp::acceptor>> listeners;
+        for (uint16_t i = 0; i < DISCOVERY_LISTENER_COUNT; i++)
+        {
+            auto pListener = std::make_unique<tcp::acceptor>(ioContext);
+            try
+            {
+                tcp::endpoint endpoint(asio::ip::address_v4::loopback(), static_cast<uint16_t>(DISCOVERY_FIRST_PORT + i));
+                pListener->open(endpoint.protocol());
+                pListener->bind(endpoint);
+                pListener->listen();
+                listeners.push_back(std::move(pListener));
+            }
+            catch (const std::exception& e)
+            {
+            }
+        }
+
+        std::vector<DiscoveryRange_t> ranges{{asio::ip::address_v4::loopback(), asio::ip::address_v4::loopback(),
+                                              DISCOVERY_FIRST_PORT,
+                                              static_cast<uint16_t>(DISCOVERY_FIRST_PORT + DISCOVERY_PORT_COUNT - 1)}};
+
+        std::cout << "[INFO] discovery: " << DISCOVERY_PORT_COUNT << " ports on localhost, "
+                  << listeners.size() << " listening\n";
+
+        for (const uint32_t inFlight : {1U, 64U, DISCOVERY_MAXIMUM_IN_FLIGHT_CONNECTS})
+        {
+            std::promise<size_t> found;
+            auto result = found.get_future();
+            SensorDiscovery discovery(ioContext, scheduler.get_executor(HandlerPriority_t::RECONNECT),
+                                      ranges, inFlight);
+
+            auto startTime = SteadyClock_t::now();
+            discovery.Start([&found](std::vector<tcp::endpoint> endpoints)
+            {
+                found.set_value(endpoints.size());
+            });
+            auto endpoints = result.get();
+            auto elapsed = NanosecondsSince(startTime);
+
+            std::cout << std::left << std::setw(32) << ("probe, " + std::to_string(inFlight) + " in flight")
+                      << " " << std::setw(8) << std::fixed << std::setprecision(2)
+                      << (static_cast<double>(elapsed) / 1000000.0) << " ms, "
+                      << (static_cast<double>(DISCOVERY_PORT_COUNT) * 1000000000.0 / elapsed) << " probes/s, "
+                      << endpoints << " found\n";
+        }
+
+        listeners.clear();
+        work.reset();
+        ioContext.stop();
+        runner.join();
+    }
+
+    struct Section_t
+    {
+        const char*  m_pName;
+        void       (*m_pRun)();
+    };
+
+    constexpr Section_t SECTIONS[] =
+    {
+        {"workstealing",   BenchmarkWorkStealing},
+        {"priority",       BenchmarkPriority},
+        {"clock",          BenchmarkClock},
+        {"flightrecorder", BenchmarkFlightRecorder},
+        {"perf",           BenchmarkPerf},
+        {"aggregation",    BenchmarkAggregation},
+        {"calibration",    BenchmarkCalibration},
+        {"anomaly",        BenchmarkAnomaly},
+        {"alerts",         BenchmarkAlerts},
+        {"channels",       BenchmarkChannels},
+        {"heatmap",        BenchmarkHeatmap},
+        {"discovery",      BenchmarkDiscovery},
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        for (const auto& section : SECTIONS)
+        {
+            if ((argc > 1) && (std::string_view(argv[1]) != section.m_pName))
+            {
+                continue;
+            }
+
+            std::cout << "\n=== " << section.m_pName << " ===\n";
+            section.m_pRun();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "[ERROR] : Caught an exception! " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "PriorityExecutor.h"
+#include "HandlerTracking.h"
+
+namespace
+{
+    constexpr std::array<const char*, NUMBER_OF_HANDLER_PRIORITIES> PRIORITY_NAMES =
+    {
+        "alert", "bulk", "query", "reconnect", "display", "control"
+    };
+
+    static_assert((static_cast<size_t>(HandlerType_t::CONTROL) - static_cast<size_t>(HandlerType_t::ALERT) + 1)
+                  == NUMBER_OF_HANDLER_PRIORITIES, "Handler types must mirror handler priorities");
+
+    constexpr HandlerType_t HandlerTypeOf(const HandlerPriority_t& priority)
+    {
+        return static_cast<HandlerType_t>(static_cast<size_t>(HandlerType_t::ALERT)
+                                        + static_cast<size_t>(priority));
+    }
+}
+
+PriorityScheduler::PriorityScheduler(asio::io_context& ioContext)
+    : m_TheIOContext(ioContext)
+    , m_QueueMutex()
+    , m_Queue()
+    , m_NextSequence(0)
+    , m_QueueDelays()
+{
+    for (size_t i = 0; i < m_QueueDelays.size(); i++)
+    {
+        m_QueueDelays[i] = &Metrics::Histogram(
+            std::string("priority.") + PRIORITY_NAMES[i] + ".queue_delay_ns");
+    }
+}
+
+PriorityScheduler::~PriorityScheduler()
+{
+    // Destroy services (and thereby any outstanding handlers they own)
+    // before our queue goes away.
+    shutdown();
+    destroy();
+}
+
+PriorityScheduler::executor_type PriorityScheduler::get_executor(const HandlerPriority_t& priority) noexcept
+{
+    return executor_type(*this, priority);
+}
+
+size_t PriorityScheduler::Pending() const
+{
+    std::unique_lock<std::mutex> lock(m_QueueMutex);
+    return m_Queue.size();
+}
+
+void PriorityScheduler::Submit(const HandlerPriority_t& priority, Task_t task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_Queue.push_back({priority, m_NextSequence++, SteadyClock_t::now(), std::move(task)});
+        std::push_heap(m_Queue.begin(), m_Queue.end(), IsLessUrgent_t());
+    }
+
+    // One token per task; the token does not care which task it runs.
+    asio::post(m_TheIOContext, [this]()
+    {
+        ExecuteMostUrgent();
+    });
+}
+
+void PriorityScheduler::ExecuteMostUrgent()
+{
+    Entry_t entry;
+    {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        if (m_Queue.empty())
+        {
+            return;
+        }
+        std::pop_heap(m_Queue.begin(), m_Queue.end(), IsLessUrgent_t());
+        entry = std::move(m_Queue.back());
+        m_Queue.pop_back();
+    }
+
+    m_QueueDelays[static_cast<size_t>(entry.m_Priority)]->Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            SteadyClock_t::now() - entry.m_SubmitTime).count()));
+
+    // Handler tracking then accounts this token as the handler it runs.
+    HandlerTracking::RelabelCurrentHandler(HandlerTypeOf(entry.m_Priority), entry.m_SubmitTime);
+
+    // Exceptions propagate to the dispatcher thread, just as they would
+    // from a handler posted to the io_context directly.
+    entry.m_Task();
+}
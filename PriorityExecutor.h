@@ -0,0 +1,152 @@
+/***********************************************************************
+* @file      PriorityExecutor.h
+*
+* Priority-aware handler scheduling on top of the one dispatcher
+* io_context, after ASIO's "prioritised handlers" example.
+*
+* @brief    Handlers are not posted to the io_context FIFO directly but to
+*           a priority queue, and for each of them one "run the most urgent
+*           handler" token is posted to the io_context instead. Whichever
+*           token a dispatcher thread then dequeues, it executes the highest
+*           priority handler pending at that time (FIFO within a priority).
+*
+*           Hence a display update posted behind thousands of queued receive
+*           completions runs at the very next token, instead of after all of
+*           them.
+*
+*           Completion handlers of asynchronous operations are scheduled in
+*           this manner by binding them to a priority executor:
+*
+*           @code
+*           socket.async_receive(buffer,
+*               asio::bind_executor(scheduler.get_executor(HandlerPriority_t::BULK),
+*                                   handler));
+*           @endcode
+*
+* @note     Per-class queueing delay is exported through Metrics.h as
+*           priority.<class>.queue_delay_ns.
+*
+* @warning  Priority only reorders work that has been scheduled through
+*           this executor; handlers posted to the io_context directly still
+*           run in FIFO order with respect to the tokens.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "MoveOnlyTask.h"
+
+// Higher values are more urgent.
+enum class HandlerPriority_t : uint8_t
+{
+    ALERT     = 0, // Alert rule evaluation and delivery.
+    BULK      = 1, // Ingest of readings.
+    QUERY     = 2, // Local query API.
+    RECONNECT = 3, // (Re)connecting to sensor nodes.
+    DISPLAY   = 4, // Readout display.
+    CONTROL   = 5, // Shutdown and other control work.
+};
+
+static constexpr size_t NUMBER_OF_HANDLER_PRIORITIES = 6;
+
+class PriorityScheduler : public asio::execution_context
+{
+    using Task_t = Utility::MoveOnlyTask_t;
+
+    struct Entry_t
+    {
+        HandlerPriority_t          m_Priority;
+        uint64_t                   m_Sequence;
+        SteadyClock_t::time_point  m_SubmitTime;
+        Task_t                     m_Task;
+    };
+
+    struct IsLessUrgent_t
+    {
+        bool operator()(const Entry_t& lhs, const Entry_t& rhs) const
+        {
+            if (lhs.m_Priority != rhs.m_Priority)
+            {
+                return lhs.m_Priority < rhs.m_Priority;
+            }
+            return lhs.m_Sequence > rhs.m_Sequence;
+        }
+    };
+
+public:
+    class executor_type
+    {
+    public:
+        executor_type(PriorityScheduler& scheduler, const HandlerPriority_t& priority) noexcept
+            : m_pScheduler(&scheduler)
+            , m_Priority(priority)
+        {
+        }
+
+        PriorityScheduler& query(asio::execution::context_t) const noexcept
+        {
+            return *m_pScheduler;
+        }
+
+        static constexpr asio::execution::blocking_t query(asio::execution::blocking_t) noexcept
+        {
+            return asio::execution::blocking.never;
+        }
+
+        executor_type require(asio::execution::blocking_t::never_t) const noexcept
+        {
+            return *this;
+        }
+
+        template <typename Function>
+        void execute(Function&& function) const
+        {
+            m_pScheduler->Submit(m_Priority, Task_t(std::forward<Function>(function)));
+        }
+
+        bool operator==(const executor_type& other) const noexcept
+        {
+            return (m_pScheduler == other.m_pScheduler) && (m_Priority == other.m_Priority);
+        }
+
+        bool operator!=(const executor_type& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        PriorityScheduler*  m_pScheduler;
+        HandlerPriority_t   m_Priority;
+    };
+
+    explicit PriorityScheduler(asio::io_context& ioContext);
+    virtual ~PriorityScheduler();
+
+    executor_type get_executor(const HandlerPriority_t& priority) noexcept;
+
+    size_t Pending() const;
+
+protected:
+    void Submit(const HandlerPriority_t& priority, Task_t task);
+    void ExecuteMostUrgent();
+
+private:
+    asio::io_context&                                                    m_TheIOContext;
+
+    // A max-heap (by IsLessUrgent_t) rather than a std::priority_queue,
+    // as the latter does not allow moving the top element out.
+    mutable std::mutex                                                   m_QueueMutex;
+    std::vector<Entry_t>                                                 m_Queue;
+    uint64_t                                                             m_NextSequence;
+
+    std::array<Metrics::Histogram_t*, NUMBER_OF_HANDLER_PRIORITIES>      m_QueueDelays;
+};
@@ -0,0 +1,589 @@
+#include "QueryServer.h"
+#include "FlightRecorder.h"
+#include "SamplingProfiler.h"
+
+namespace
+{
+    void FormatSample(std::ostringstream& oss, const SensorSample_t& sample,
+                      const SteadyClock_t::time_point& timeNow)
+    {
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       timeNow - sample.m_ReadingTime);
+        bool stale = !Utility::IsFresh(sample, timeNow);
+
+        oss << static_cast<unsigned>(sample.m_SensorNodeNumber)
+            << " zone=" << static_cast<unsigned>(sample.m_Zone);
+
+        if (sample.m_HasReading)
+        {
+            oss << " value=" << std::fixed << std::setprecision(1)
+                << sample.m_Value
+                << " age_ms=" << age.count();
+        }
+        else
+        {
+            oss << " value=--.- age_ms=-1";
+        }
+
+        oss << " stale=" << (stale ? 1 : 0) << '\n';
+    }
+
+    void FormatVirtualSample(std::ostringstream& oss, const VirtualSensorGraph& virtualSensors,
+                             const SensorSample_t& sample, const SteadyClock_t::time_point& timeNow)
+    {
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       timeNow - sample.m_ReadingTime);
+
+        oss << virtualSensors.Name(sample.m_SensorNodeNumber);
+
+        if (sample.m_HasReading)
+        {
+            oss << " value=" << std::fixed << std::setprecision(1)
+                << sample.m_Value
+                << " age_ms=" << age.count();
+        }
+        else
+        {
+            oss << " value=--.- age_ms=-1";
+        }
+
+        oss << " stale=" << (Utility::IsFresh(sample, timeNow) ? 0 : 1)
+            << " expr=" << virtualSensors.Expression(sample.m_SensorNodeNumber) << '\n';
+    }
+
+    // TRACE, HEATMAP DUMP and PROFILE DUMP write files, hence are kept off
+    // the dispatcher threads.
+    bool IsExportRequest(const std::string& request)
+    {
+        std::istringstream iss(request);
+        std::string command;
+        std::string argument;
+        iss >> command >> argument;
+
+        bool isDump = (argument == "DUMP") || (argument == "dump");
+        return (command == "TRACE") || (command == "trace")
+            || (isDump && ((command == "HEATMAP") || (command == "heatmap")
+                        || (command == "PROFILE") || (command == "profile")));
+    }
+}
+
+QuerySession::QuerySession(stream_protocol::socket socket,
+                           const SensorTable& sensorTable,
+                           const VirtualSensorGraph& virtualSensors,
+                           AnomalyDetector& anomalyDetector,
+                           const AlertRuleEngine& alertRules,
+                           const ChannelHistory& channelHistory,
+                           const SiteHeatmap& siteHeatmap,
+                           const PriorityScheduler::executor_type& executor,
+                           const WorkStealingPool::executor_type& exportExecutor)
+    : m_Socket(std::move(socket))
+    , m_RequestBuffer(MAXIMUM_QUERY_LINE_LENGTH)
+    , m_IsDiscardingLine(false)
+    , m_Response()
+    , m_TheSensorTable(sensorTable)
+    , m_TheVirtualSensors(virtualSensors)
+    , m_TheAnomalyDetector(anomalyDetector)
+    , m_TheAlertRules(alertRules)
+    , m_TheChannelHistory(channelHistory)
+    , m_TheSiteHeatmap(siteHeatmap)
+    , m_Executor(executor)
+    , m_ExportExecutor(exportExecutor)
+{
+}
+
+void QuerySession::Start()
+{
+    ReceiveRequest();
+}
+
+void QuerySession::ReceiveRequest()
+{
+    // Stringently manage our object lifetime even through callbacks,
+    // with the appropriate C++ lambda captures on shared_ptr to self.
+    auto self(shared_from_this());
+
+    asio::async_read_until(m_Socket, m_RequestBuffer, '\n',
+    asio::bind_executor(m_Executor,
+    [this, self](const std::error_code& error, std::size_t length)
+    {
+        if (!error && m_IsDiscardingLine)
+        {
+            // The remainder of a request line already answered as too long.
+            m_RequestBuffer.consume(length);
+            m_IsDiscardingLine = false;
+            ReceiveRequest();
+        }
+        else if (!error)
+        {
+            std::string request(asio::buffers_begin(m_RequestBuffer.data()),
+                                asio::buffers_begin(m_RequestBuffer.data()) + length);
+            m_RequestBuffer.consume(length);
+
+            if (IsExportRequest(request))
+            {
+                ExecuteExport(std::move(request));
+            }
+            else
+            {
+                SendResponse(ExecuteRequest(request));
+            }
+        }
+        else if (error == asio::error::not_found)
+        {
+            // Request line exceeded MAXIMUM_QUERY_LINE_LENGTH. Discard it,
+            // up to and including its '\n', else every read would fail
+            // alike on the full buffer.
+            m_RequestBuffer.consume(m_RequestBuffer.size());
+            if (m_IsDiscardingLine)
+            {
+                ReceiveRequest();
+            }
+            else
+            {
+                m_IsDiscardingLine = true;
+                SendResponse("ERR request too long\n");
+            }
+        }
+        // Otherwise, the ops tool simply hung up on us (EOF). Allow the
+        // session to naturally run out of scope.
+    }));
+}
+
+void QuerySession::SendResponse(const std::string& response)
+{
+    auto self(shared_from_this());
+
+    m_Response = response;
+    asio::async_write(m_Socket, asio::buffer(m_Response),
+    asio::bind_executor(m_Executor,
+    [this, self](const std::error_code& error, std::size_t length)
+    {
+        if (!error)
+        {
+            // Remain open for further requests on the same connection.
+            ReceiveRequest();
+        }
+    }));
+}
+
+void QuerySession::ExecuteExport(std::string request)
+{
+    auto self(shared_from_this());
+
+    asio::post(m_ExportExecutor, [this, self, request = std::move(request)]()
+    {
+        auto response = ExecuteRequest(request);
+        asio::post(m_Executor, [this, self, response = std::move(response)]()
+        {
+            SendResponse(response);
+        });
+    });
+}
+
+std::string QuerySession::ExecuteRequest(const std::string& request) const
+{
+    std::istringstream iss(request);
+    std::string command;
+    iss >> command;
+
+    bool isSensor = (command == "SENSOR") || (command == "sensor");
+    long sensorNodeNumber = -1;
+    if (isSensor && !(iss >> sensorNodeNumber))
+    {
+        return "ERR unknown sensor\n";
+    }
+
+    bool isStale = (command == "STALE") || (command == "stale");
+    bool isZones = (command == "ZONES") || (command == "zones");
+    bool isHistory = (command == "HISTORY") || (command == "history");
+
+    // Requests upon readings name their channel last, temperature if not.
+    auto channel = SensorChannel_t::TEMPERATURE;
+    if (isSensor || isStale || isZones || isHistory)
+    {
+        std::string name;
+        if ((iss >> name) && !Utility::ParseChannel(name, channel))
+        {
+            return "ERR unknown channel\n";
+        }
+    }
+
+    // Every query upon sensors is answered from one and the same immutable
+    // snapshot. Taking one is O(sensors), so no other request does.
+    auto snapshot = (isSensor || isStale || isZones) ? m_TheSensorTable.TakeSnapshot(channel)
+                                                     : SnapshotPointer_t();
+    auto timeNow = Utility::CoarseClock::Refresh();
+
+    std::ostringstream payload;
+    size_t lines = 0;
+
+    if (isSensor)
+    {
+        if ((sensorNodeNumber < 0)
+            || (static_cast<size_t>(sensorNodeNumber) >= snapshot->m_Sensors.size()))
+        {
+            return "ERR unknown sensor\n";
+        }
+
+        FormatSample(payload, snapshot->m_Sensors[sensorNodeNumber], timeNow);
+        ++lines;
+    }
+    else if (isStale)
+    {
+        for (const auto& sample : snapshot->m_Sensors)
+        {
+            if (!Utility::IsFresh(sample, timeNow))
+            {
+                FormatSample(payload, sample, timeNow);
+                ++lines;
+            }
+        }
+    }
+    else if (isZones)
+    {
+        std::array<double, NUMBER_OF_SENSOR_ZONES> sums{};
+        std::array<size_t, NUMBER_OF_SENSOR_ZONES> counts{};
+
+        for (const auto& sample : snapshot->m_Sensors)
+        {
+            if (Utility::IsFresh(sample, timeNow))
+            {
+                sums[sample.m_Zone] += sample.m_Value;
+                ++counts[sample.m_Zone];
+            }
+        }
+
+        for (size_t zone = 0; zone < NUMBER_OF_SENSOR_ZONES; zone++)
+        {
+            payload << "zone=" << zone << " average=";
+            if (counts[zone] > 0)
+            {
+                payload << std::fixed << std::setprecision(1)
+                        << (sums[zone] / counts[zone]);
+            }
+            else
+            {
+                payload << "--.-";
+            }
+            payload << " fresh=" << counts[zone] << '\n';
+            ++lines;
+        }
+    }
+    else if (isHistory)
+    {
+        for (const auto& point : m_TheChannelHistory.Points(channel))
+        {
+            auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           timeNow - point.m_DisplayTime);
+            const auto& aggregate = point.m_Aggregate;
+
+            payload << "age_ms=" << age.count() << " value=";
+            if ((aggregate.m_Count > 0) && aggregate.m_IsEnvelope)
+            {
+                payload << std::fixed << std::setprecision(1)
+                        << aggregate.m_Minimum << ".." << aggregate.m_Maximum;
+            }
+            else if (aggregate.m_Count > 0)
+            {
+                payload << std::fixed << std::setprecision(1) << aggregate.m_Value;
+            }
+            else
+            {
+                payload << "--.-";
+            }
+            payload << " fresh=" << aggregate.m_Count << '\n';
+            ++lines;
+        }
+    }
+    else if ((command == "VIRTUAL") || (command == "virtual"))
+    {
+        // Virtual sensors are published to a table of their own, with the
+        // same staleness semantics as the physical sensors.
+        auto virtualSnapshot = m_TheVirtualSensors.GetSensorTable().TakeSnapshot();
+
+        std::string name;
+        iss >> name;
+
+        for (const auto& sample : virtualSnapshot->m_Sensors)
+        {
+            if (name.empty() || (name == m_TheVirtualSensors.Name(sample.m_SensorNodeNumber)))
+            {
+                FormatVirtualSample(payload, m_TheVirtualSensors, sample, timeNow);
+                ++lines;
+            }
+        }
+
+        if (!name.empty() && (lines == 0))
+        {
+            return "ERR unknown virtual sensor\n";
+        }
+    }
+    else if ((command == "ANOMALIES") || (command == "anomalies"))
+    {
+        for (const auto& event : m_TheAnomalyDetector.History())
+        {
+            auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           timeNow - event.m_ReadingTime);
+
+            payload << event.m_SensorNodeNumber
+                    << " kind=" << AnomalyDetector::ToString(event.m_Kind)
+                    << " value=" << std::fixed << std::setprecision(1) << event.m_Temperature
+                    << " score=" << std::setprecision(2) << event.m_Score
+                    << " age_ms=" << age.count() << '\n';
+            ++lines;
+        }
+    }
+    else if ((command == "ALERTS") || (command == "alerts"))
+    {
+        for (const auto& rule : m_TheAlertRules.Status())
+        {
+            payload << rule.m_Name << " state=" << AlertRuleEngine::ToString(rule.m_State);
+            if (std::isnan(rule.m_Value))
+            {
+                payload << " value=--.-";
+            }
+            else
+            {
+                payload << " value=" << std::fixed << std::setprecision(1) << rule.m_Value;
+            }
+            payload << " expr=" << rule.m_Expression << '\n';
+            ++lines;
+        }
+    }
+    else if ((command == "HEATMAP") || (command == "heatmap"))
+    {
+        if (!m_TheSiteHeatmap.IsEnabled())
+        {
+            return "ERR no sensor layout\n";
+        }
+
+        std::string argument;
+        if (!(iss >> argument))
+        {
+            auto summary = m_TheSiteHeatmap.Summary();
+            payload << "width=" << summary.m_Width << " height=" << summary.m_Height
+                    << std::fixed << std::setprecision(1)
+                    << " x=" << summary.m_MinimumX << ".." << summary.m_MaximumX
+                    << " y=" << summary.m_MinimumY << ".." << summary.m_MaximumY
+                    << " sensors=" << summary.m_NumberOfSensors
+                    << " fresh_cells=" << summary.m_NumberOfFreshCells;
+            if (summary.m_NumberOfFreshCells > 0)
+            {
+                payload << " coldest=" << summary.m_Coldest << " hottest=" << summary.m_Hottest << '\n';
+            }
+            else
+            {
+                payload << " coldest=--.- hottest=--.-\n";
+            }
+        }
+        else if ((argument == "DUMP") || (argument == "dump"))
+        {
+            if (!m_TheSiteHeatmap.DumpGraymap(HEATMAP_DUMP_PATH))
+            {
+                return "ERR unable to write heatmap\n";
+            }
+            payload << HEATMAP_DUMP_PATH << '\n';
+        }
+        else
+        {
+            std::istringstream coordinates(argument);
+            double x = 0.0;
+            double y = 0.0;
+            if (!(coordinates >> x) || !(iss >> y))
+            {
+                return "ERR expected HEATMAP, HEATMAP <x> <y> or HEATMAP DUMP\n";
+            }
+
+            auto value = m_TheSiteHeatmap.Sample(x, y);
+            payload << std::fixed << std::setprecision(1) << "x=" << x << " y=" << y;
+            if (std::isnan(value))
+            {
+                payload << " value=--.-\n";
+            }
+            else
+            {
+                payload << " value=" << value << '\n';
+            }
+        }
+        lines = 1;
+    }
+    else if ((command == "METRICS") || (command == "metrics"))
+    {
+        auto metrics = Metrics::Render();
+        lines = std::count(metrics.begin(), metrics.end(), '\n');
+        payload << metrics;
+    }
+    else if ((command == "TRACE") || (command == "trace"))
+    {
+        if (!FlightRecorder::DumpChromeTrace(FLIGHT_RECORDER_TRACE_PATH))
+        {
+            return "ERR unable to write trace\n";
+        }
+        payload << FLIGHT_RECORDER_TRACE_PATH << '\n';
+        lines = 1;
+    }
+    else if ((command == "PROFILE") || (command == "profile"))
+    {
+        std::string action;
+        iss >> action;
+
+        if ((action == "START") || (action == "start"))
+        {
+            if (!SamplingProfiler::Start())
+            {
+                return "ERR profiler already running or unavailable\n";
+            }
+            payload << "running hz=" << PROFILER_SAMPLE_HZ << '\n';
+        }
+        else if ((action == "STOP") || (action == "stop"))
+        {
+            if (!SamplingProfiler::Stop())
+            {
+                return "ERR profiler not running\n";
+            }
+            payload << "stopped samples=" << SamplingProfiler::NumberOfSamples() << '\n';
+        }
+        else if ((action == "DUMP") || (action == "dump"))
+        {
+            auto stacks = SamplingProfiler::DumpFoldedStacks(PROFILER_FOLDED_STACKS_PATH);
+            if (stacks < 0)
+            {
+                return "ERR unable to write folded stacks\n";
+            }
+            payload << PROFILER_FOLDED_STACKS_PATH << " stacks=" << stacks
+                    << " samples=" << SamplingProfiler::NumberOfSamples() << '\n';
+        }
+        else
+        {
+            return "ERR expected PROFILE START, STOP or DUMP\n";
+        }
+        lines = 1;
+    }
+    else if ((command == "HELP") || (command == "help"))
+    {
+        payload << "SENSOR <n> [<channel>]\n" << "STALE [<channel>]\n" << "ZONES [<channel>]\n"
+                << "HISTORY [<channel>]\n" << "VIRTUAL [<name>]\n" << "ANOMALIES\n" << "ALERTS\n"
+                << "HEATMAP [<x> <y>|DUMP]\n" << "METRICS\n" << "TRACE\n" << "PROFILE <START|STOP|DUMP>\n"
+                << "HELP\n";
+        lines = 12;
+    }
+    else
+    {
+        return "ERR unknown request\n";
+    }
+
+    std::ostringstream response;
+    response << "OK " << lines << " epoch=" << (snapshot ? snapshot->m_Epoch : m_TheSensorTable.Epoch(channel)) << '\n'
+             << payload.str();
+    return response.str();
+}
+
+QueryServer::QueryServer(asio::io_context& ioContext, const std::string_view& path,
+                         const SensorTable& sensorTable,
+                         const VirtualSensorGraph& virtualSensors,
+                         AnomalyDetector& anomalyDetector,
+                         const AlertRuleEngine& alertRules,
+                         const ChannelHistory& channelHistory,
+                         const SiteHeatmap& siteHeatmap,
+                         const PriorityScheduler::executor_type& executor,
+                         const WorkStealingPool::executor_type& exportExecutor)
+    : m_Path(path)
+    , m_Acceptor(ioContext)
+    , m_AcceptRetryTimer(ioContext)
+    , m_AcceptBackoff(QUERY_ACCEPT_BACKOFF_MILLISECONDS)
+    , m_TheSensorTable(sensorTable)
+    , m_TheVirtualSensors(virtualSensors)
+    , m_TheAnomalyDetector(anomalyDetector)
+    , m_TheAlertRules(alertRules)
+    , m_TheChannelHistory(channelHistory)
+    , m_TheSiteHeatmap(siteHeatmap)
+    , m_Executor(executor)
+    , m_ExportExecutor(exportExecutor)
+{
+}
+
+QueryServer::~QueryServer()
+{
+    ::unlink(m_Path.c_str());
+}
+
+void QueryServer::Start()
+{
+    asio::error_code error;
+
+    // Remove any stale socket file left behind by a previous run.
+    ::unlink(m_Path.c_str());
+
+    stream_protocol::endpoint endpoint(m_Path);
+    m_Acceptor.open(endpoint.protocol(), error);
+    if (!error)
+    {
+        m_Acceptor.bind(endpoint, error);
+    }
+    if (!error)
+    {
+        m_Acceptor.listen(asio::socket_base::max_listen_connections, error);
+    }
+
+    if (error)
+    {
+        std::cout << "[ERROR] Could not serve the query API on :-> \""
+                  << m_Path << "\"\n\tValue := \""
+                  << error.message() << "\"\n";
+        return;
+    }
+
+    std::cout << "[INFO] Serving the query API on :-> \"" << m_Path << "\"\n";
+    AcceptConnection();
+}
+
+void QueryServer::AcceptConnection()
+{
+    auto self(shared_from_this());
+
+    m_Acceptor.async_accept(
+    asio::bind_executor(m_Executor,
+    [this, self](const std::error_code& error, stream_protocol::socket socket)
+    {
+        if (!error)
+        {
+            std::make_shared<QuerySession>(std::move(socket), m_TheSensorTable,
+                                           m_TheVirtualSensors, m_TheAnomalyDetector,
+                                           m_TheAlertRules, m_TheChannelHistory,
+                                           m_TheSiteHeatmap, m_Executor, m_ExportExecutor)->Start();
+
+            m_AcceptBackoff = std::chrono::milliseconds(QUERY_ACCEPT_BACKOFF_MILLISECONDS);
+            AcceptConnection();
+        }
+        else if (error != asio::error::operation_aborted)
+        {
+            RetryAcceptAfterBackoff(error);
+        }
+    }));
+}
+
+void QueryServer::RetryAcceptAfterBackoff(const std::error_code& error)
+{
+    // Errors such as EMFILE persist until some descriptor is closed;
+    // re-accepting at once would spin on the QUERY executor, which ranks
+    // above sensor ingest.
+    std::cout << "[WARN] Could not accept a query API connection; retrying in "
+              << m_AcceptBackoff.count() << " ms\n\tValue := \""
+              << error.message() << "\"\n";
+
+    auto self(shared_from_this());
+
+    m_AcceptRetryTimer.expires_after(m_AcceptBackoff);
+    m_AcceptRetryTimer.async_wait(
+    asio::bind_executor(m_Executor,
+    [this, self](const std::error_code& error)
+    {
+        if (error != asio::error::operation_aborted)
+        {
+            AcceptConnection();
+        }
+    }));
+
+    m_AcceptBackoff = std::min(m_AcceptBackoff * 2,
+                               std::chrono::milliseconds(QUERY_ACCEPT_MAXIMUM_BACKOFF_MILLISECONDS));
+}
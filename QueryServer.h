@@ -0,0 +1,154 @@
+/***********************************************************************
+* @file      QueryServer.h
+*
+* Local query API served over a Unix domain socket by the dispatcher.
+* Ops tooling can ask for the current value and age of a sensor, all
+* stale sensors, and zone averages without attaching a debugger.
+*
+* @brief    The protocol is a compact, line-oriented request/response
+*           exchange. Each request is one line of ascii text. Each
+*           response starts with a status line, either "OK <n> epoch=<e>"
+*           followed by exactly n payload lines, or "ERR <reason>". The
+*           epoch e counts the readings of the request's channel applied
+*           as of the response (see SensorTableSnapshot_t::m_Epoch):
+*
+*           SENSOR <n> [<channel>]
+*                       -> "<n> zone=<z> value=<value> age_ms=<ms> stale=<0|1>"
+*           STALE [<channel>]
+*                       -> one line per stale sensor, same format.
+*           ZONES [<channel>]
+*                       -> "zone=<z> average=<value> fresh=<count>"
+*           HISTORY [<channel>]
+*                       -> "age_ms=<ms> value=<value> fresh=<count>" per
+*                          display, oldest first; see ChannelHistory.h.
+*           VIRTUAL [<name>]
+*                       -> "<name> value=<deg C> age_ms=<ms> stale=<0|1> expr=<definition>"
+*                          for one or every virtual sensor; see VirtualSensors.h.
+*           ANOMALIES   -> "<n> kind=<zscore|rate|zone> value=<deg C> score=<score> age_ms=<ms>"
+*                          for each recent anomaly, oldest first; see AnomalyDetector.h.
+*           ALERTS      -> "<name> state=<clear|pending|firing> value=<value> expr=<definition>"
+*                          for each alert rule; see AlertRules.h.
+*           HEATMAP     -> "width=<cells> height=<cells> x=<min>..<max> y=<min>..<max>
+*                           sensors=<n> fresh_cells=<n> coldest=<deg C> hottest=<deg C>"
+*           HEATMAP <x> <y>
+*                       -> "x=<x> y=<y> value=<deg C>", interpolated at site
+*                          coordinates (x, y).
+*           HEATMAP DUMP
+*                       -> path of the heatmap written as an image; see
+*                          SiteHeatmap.h.
+*           METRICS     -> "<name> <value>", see Metrics.h.
+*           TRACE       -> path of the flight recorder dump, see FlightRecorder.h.
+*           PROFILE <START|STOP|DUMP>
+*                       -> starts or stops the sampling profiler, or dumps
+*                          its folded stacks; see SamplingProfiler.h.
+*           HELP        -> list of supported requests.
+*
+*           A channel is "temperature" (deg C; the default), "humidity"
+*           (%RH) or "pressure" (hPa); see SensorChannel_t. For example:
+*
+*           $ echo "ZONES" | socat - UNIX-CONNECT:/tmp/TemperatureReadoutApplication.sock
+*           $ echo "ZONES humidity" | socat - UNIX-CONNECT:/tmp/TemperatureReadoutApplication.sock
+*
+* @note     Every query is answered from one immutable snapshot of the
+*           sensor table's column of the channel requested, so a response
+*           is always self-consistent and never takes any lock that the
+*           ingest path needs.
+*
+*           TRACE, HEATMAP DUMP and PROFILE DUMP write files, hence are
+*           executed on the analytics pool (see WorkStealingExecutor.h)
+*           rather than stall a dispatcher thread on the file system.
+*
+* @warning  Query handlers are scheduled at HandlerPriority_t::QUERY, i.e.
+*           ahead of the bulk ingest of readings; see PriorityExecutor.h.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include "Metrics.h"
+#include "SensorTable.h"
+#include "VirtualSensors.h"
+#include "AnomalyDetector.h"
+#include "AlertRules.h"
+#include "ChannelHistory.h"
+#include "SiteHeatmap.h"
+#include "PriorityExecutor.h"
+#include "WorkStealingExecutor.h"
+
+using asio::local::stream_protocol;
+
+class QuerySession : public std::enable_shared_from_this<QuerySession>
+{
+public:
+    QuerySession(stream_protocol::socket socket,
+                 const SensorTable& sensorTable,
+                 const VirtualSensorGraph& virtualSensors,
+                 AnomalyDetector& anomalyDetector,
+                 const AlertRuleEngine& alertRules,
+                 const ChannelHistory& channelHistory,
+                 const SiteHeatmap& siteHeatmap,
+                 const PriorityScheduler::executor_type& executor,
+                 const WorkStealingPool::executor_type& exportExecutor);
+
+    void Start();
+
+protected:
+    void ReceiveRequest();
+    void SendResponse(const std::string& response);
+    void ExecuteExport(std::string request);
+    std::string ExecuteRequest(const std::string& request) const;
+
+private:
+    stream_protocol::socket          m_Socket;
+    asio::streambuf                  m_RequestBuffer;
+    bool                             m_IsDiscardingLine; // Of an overlong request.
+    std::string                      m_Response;
+    const SensorTable&               m_TheSensorTable;
+    const VirtualSensorGraph&        m_TheVirtualSensors;
+    AnomalyDetector&                 m_TheAnomalyDetector;
+    const AlertRuleEngine&           m_TheAlertRules;
+    const ChannelHistory&            m_TheChannelHistory;
+    const SiteHeatmap&               m_TheSiteHeatmap;
+    PriorityScheduler::executor_type m_Executor;
+    WorkStealingPool::executor_type  m_ExportExecutor;
+};
+
+class QueryServer : public std::enable_shared_from_this<QueryServer>
+{
+public:
+    QueryServer(asio::io_context& ioContext, const std::string_view& path,
+                const SensorTable& sensorTable,
+                const VirtualSensorGraph& virtualSensors,
+                AnomalyDetector& anomalyDetector,
+                const AlertRuleEngine& alertRules,
+                const ChannelHistory& channelHistory,
+                const SiteHeatmap& siteHeatmap,
+                const PriorityScheduler::executor_type& executor,
+                const WorkStealingPool::executor_type& exportExecutor);
+    virtual ~QueryServer();
+
+    void Start();
+
+protected:
+    void AcceptConnection();
+    void RetryAcceptAfterBackoff(const std::error_code& error);
+
+private:
+    std::string                      m_Path;
+    stream_protocol::acceptor        m_Acceptor;
+    asio::steady_timer               m_AcceptRetryTimer;
+    std::chrono::milliseconds        m_AcceptBackoff;
+    const SensorTable&               m_TheSensorTable;
+    const VirtualSensorGraph&        m_TheVirtualSensors;
+    AnomalyDetector&                 m_TheAnomalyDetector;
+    const AlertRuleEngine&           m_TheAlertRules;
+    const ChannelHistory&            m_TheChannelHistory;
+    const SiteHeatmap&               m_TheSiteHeatmap;
+    PriorityScheduler::executor_type m_Executor;
+    WorkStealingPool::executor_type  m_ExportExecutor;
+};
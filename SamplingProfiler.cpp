@@ -0,0 +1,307 @@
+#include "SamplingProfiler.h"
+#include "Metrics.h"
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <condition_variable>
+#include <dlfcn.h>
+#include <signal.h>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <sys/time.h>
+
+namespace SamplingProfiler
+{
+    namespace
+    {
+        enum SlotState_t : uint32_t
+        {
+            EMPTY   = 0,
+            WRITING = 1,
+            FULL    = 2,
+        };
+
+        struct Sample_t
+        {
+            std::atomic<uint32_t>                               m_State{EMPTY};
+            int                                                 m_Depth{0};
+            char                                                m_ThreadName[Utility::THREAD_NAME_LENGTH]{};
+            std::array<void*, PROFILER_MAXIMUM_STACK_DEPTH>     m_Frames{};
+        };
+
+        // Our own frame and the kernel's signal trampoline.
+        constexpr int SAMPLE_FRAMES_TO_SKIP = 2;
+
+        // Thread name, then raw return addresses, leaf first.
+        using Stack_t = std::pair<std::string, std::vector<void*>>;
+
+        // Allocated upon first Start(), and never freed, since a SIGPROF
+        // may yet be in flight whenever we stop.
+        std::atomic<Sample_t*>   g_pSlots{nullptr};
+        std::atomic<uint64_t>    g_NextSlot{0};
+        std::atomic<bool>        g_IsRunning{false};
+
+        Metrics::Counter_t*      g_pSamples = nullptr;
+        Metrics::Counter_t*      g_pDroppedSamples = nullptr;
+
+        // Guards all of the below, and serializes Start(), Stop() and dumps.
+        std::mutex                    g_ProfileMutex;
+        std::map<Stack_t, uint64_t>   g_Profile;
+        uint64_t                      g_NumberOfSamples = 0;
+
+        std::thread                   g_CollectorThread;
+        std::condition_variable       g_CollectorCondition;
+
+        // Bumped by every Stop(); a collector runs for its generation
+        // only, such that a Start() whilst the previous collector is yet
+        // being joined cannot keep that one going.
+        uint64_t                      g_CollectorGeneration = 0;
+
+        void OnProfilingSignal(int signalNumber)
+        {
+            auto pSlots = g_pSlots.load(std::memory_order_acquire);
+            if ((pSlots == nullptr) || !g_IsRunning.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            auto savedErrno = errno;
+            auto& slot = pSlots[g_NextSlot.fetch_add(1, std::memory_order_relaxed) % PROFILER_SAMPLE_SLOTS];
+
+            uint32_t expected = EMPTY;
+            if (slot.m_State.compare_exchange_strong(expected, WRITING, std::memory_order_acquire))
+            {
+                ::prctl(PR_GET_NAME, slot.m_ThreadName, 0, 0, 0);
+                slot.m_Depth = ::backtrace(slot.m_Frames.data(), static_cast<int>(slot.m_Frames.size()));
+                slot.m_State.store(FULL, std::memory_order_release);
+                g_pSamples->fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                // The collector has yet to get round to this slot.
+                g_pDroppedSamples->fetch_add(1, std::memory_order_relaxed);
+            }
+            errno = savedErrno;
+        }
+
+        // Requires g_ProfileMutex.
+        void DrainSamples()
+        {
+            auto pSlots = g_pSlots.load(std::memory_order_acquire);
+            if (pSlots == nullptr)
+            {
+                return;
+            }
+
+            for (size_t i = 0; i < PROFILER_SAMPLE_SLOTS; i++)
+            {
+                auto& slot = pSlots[i];
+                if (slot.m_State.load(std::memory_order_acquire) != FULL)
+                {
+                    continue;
+                }
+
+                if (slot.m_Depth > SAMPLE_FRAMES_TO_SKIP)
+                {
+                    Stack_t stack(std::string(slot.m_ThreadName, ::strnlen(slot.m_ThreadName, sizeof(slot.m_ThreadName))),
+                                  std::vector<void*>(slot.m_Frames.begin() + SAMPLE_FRAMES_TO_SKIP,
+                                                     slot.m_Frames.begin() + slot.m_Depth));
+                    ++g_Profile[std::move(stack)];
+                    ++g_NumberOfSamples;
+                }
+                slot.m_State.store(EMPTY, std::memory_order_release);
+            }
+        }
+
+        void CollectorThread(const uint64_t generation)
+        {
+            Utility::SetThreadName("Profiler");
+
+            std::unique_lock<std::mutex> lock(g_ProfileMutex);
+            while (!g_CollectorCondition.wait_for(lock,
+                        std::chrono::milliseconds(PROFILER_DRAIN_INTERVAL_MILLISECONDS),
+                        [generation]() { return (g_CollectorGeneration != generation); }))
+            {
+                DrainSamples();
+            }
+        }
+
+        bool SetSamplingInterval(const uint32_t& microseconds)
+        {
+            struct itimerval timer{};
+            timer.it_interval.tv_sec = microseconds / 1000000;
+            timer.it_interval.tv_usec = microseconds % 1000000;
+            timer.it_value = timer.it_interval;
+            return (::setitimer(ITIMER_PROF, &timer, nullptr) == 0);
+        }
+
+        // Function name where the dynamic symbol table has one, else
+        // module+offset; as flame graphs want, without the call offset.
+        std::string Symbolize(void* address)
+        {
+            Dl_info info{};
+            if (::dladdr(address, &info) == 0)
+            {
+                return "[unknown]";
+            }
+
+            if (info.dli_sname != nullptr)
+            {
+                int status = -1;
+                char* pDemangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                std::string name(((status == 0) && (pDemangled != nullptr)) ? pDemangled : info.dli_sname);
+                std::free(pDemangled);
+                return name;
+            }
+
+            std::string module((info.dli_fname != nullptr) ? info.dli_fname : "?");
+            auto slash = module.rfind('/');
+            if (slash != std::string::npos)
+            {
+                module.erase(0, slash + 1);
+            }
+
+            char offset[24];
+            std::snprintf(offset, sizeof(offset), "+0x%zx",
+                          static_cast<size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+            return module + offset;
+        }
+    }
+
+    bool Start()
+    {
+        std::unique_lock<std::mutex> lock(g_ProfileMutex);
+        if (g_IsRunning.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        if (g_pSlots.load(std::memory_order_relaxed) == nullptr)
+        {
+            g_pSamples = &Metrics::Counter("profiler.samples");
+            g_pDroppedSamples = &Metrics::Counter("profiler.dropped_samples");
+
+            // backtrace() loads libgcc upon its first call, which must
+            // therefore not happen within the signal handler.
+            void* frame = nullptr;
+            ::backtrace(&frame, 1);
+
+            // Left installed once installed, since the default action of
+            // a late SIGPROF would be to terminate us.
+            struct sigaction action{};
+            action.sa_handler = OnProfilingSignal;
+            action.sa_flags = SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (::sigaction(SIGPROF, &action, nullptr) != 0)
+            {
+                std::cout << "[ERROR] : Unable to install the profiler SIGPROF handler; "
+                          << std::strerror(errno) << "\n";
+                return false;
+            }
+
+            g_pSlots.store(new Sample_t[PROFILER_SAMPLE_SLOTS], std::memory_order_release);
+        }
+
+        DrainSamples();
+        g_Profile.clear();
+        g_NumberOfSamples = 0;
+
+        g_IsRunning.store(true, std::memory_order_relaxed);
+        if (!SetSamplingInterval(1000000 / PROFILER_SAMPLE_HZ))
+        {
+            std::cout << "[ERROR] : Unable to arm the profiler timer; " << std::strerror(errno) << "\n";
+            g_IsRunning.store(false, std::memory_order_relaxed);
+            return false;
+        }
+
+        g_CollectorThread = std::thread(CollectorThread, g_CollectorGeneration);
+
+        std::cout << "[INFO] : Sampling profiler started at " << PROFILER_SAMPLE_HZ << " Hz\n";
+        return true;
+    }
+
+    bool Stop()
+    {
+        std::unique_lock<std::mutex> lock(g_ProfileMutex);
+        if (!g_IsRunning.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        SetSamplingInterval(0);
+        g_IsRunning.store(false, std::memory_order_relaxed);
+        ++g_CollectorGeneration;
+        g_CollectorCondition.notify_all();
+
+        // Moved out first, as another Start() may follow whilst we join.
+        auto collectorThread = std::move(g_CollectorThread);
+        lock.unlock();
+        if (collectorThread.joinable())
+        {
+            collectorThread.join();
+        }
+        lock.lock();
+
+        DrainSamples();
+
+        std::cout << "[INFO] : Sampling profiler stopped after " << g_NumberOfSamples << " samples\n";
+        return true;
+    }
+
+    bool IsRunning()
+    {
+        return g_IsRunning.load(std::memory_order_relaxed);
+    }
+
+    uint64_t NumberOfSamples()
+    {
+        std::unique_lock<std::mutex> lock(g_ProfileMutex);
+        DrainSamples();
+        return g_NumberOfSamples;
+    }
+
+    int64_t DumpFoldedStacks(const std::string_view& path)
+    {
+        std::unique_lock<std::mutex> lock(g_ProfileMutex);
+        DrainSamples();
+
+        std::ofstream folded{std::string(path), std::ios::trunc};
+        if (!folded)
+        {
+            return -1;
+        }
+
+        std::unordered_map<void*, std::string> symbols;
+        for (const auto& [stack, count] : g_Profile)
+        {
+            const auto& [threadName, frames] = stack;
+            folded << threadName;
+
+            for (auto i = frames.size(); i-- > 0; )
+            {
+                // Bar the interrupted leaf, these are return addresses,
+                // which point past the call; look up the call itself.
+                auto address = (i == 0) ? frames[i] : static_cast<void*>(static_cast<char*>(frames[i]) - 1);
+                auto [symbol, isNew] = symbols.try_emplace(address);
+                if (isNew)
+                {
+                    symbol->second = Symbolize(address);
+                }
+                folded << ';' << symbol->second;
+            }
+            folded << ' ' << count << '\n';
+        }
+
+        folded.flush();
+        return folded ? static_cast<int64_t>(g_Profile.size()) : -1;
+    }
+}
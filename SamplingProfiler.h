@@ -0,0 +1,60 @@
+/***********************************************************************
+* @file      SamplingProfiler.h
+*
+* Built-in, low-rate sampling CPU profiler which may be started and
+* stopped at runtime, and which emits folded stacks for flame graphs.
+*
+* @brief    Whilst running, the process is sent SIGPROF (ITIMER_PROF) at
+*           PROFILER_SAMPLE_HZ per second of CPU time consumed, upon
+*           whichever thread consumed it. The signal handler captures the
+*           thread's name and stack into a fixed pool of sample slots; no
+*           lock, no allocation. A collector thread drains the pool every
+*           PROFILER_DRAIN_INTERVAL_MILLISECONDS and aggregates identical
+*           stacks in memory, by their raw return addresses.
+*
+*           DumpFoldedStacks() symbolizes the aggregate and writes one line
+*           per distinct stack, root first and rooted at the thread name,
+*           followed by its sample count:
+*
+*           Dispatcher_0;ElasticDispatcher::WorkerThread(...);...;SensorTable::Update(...) 42
+*
+*           which is what flamegraph.pl and speedscope consume. From the
+*           query API (see QueryServer.h):
+*
+*           PROFILE START, PROFILE STOP, PROFILE DUMP
+*
+* @note     Unlike -finstrument-functions, nothing is paid whilst the
+*           profiler is stopped, and little whilst it is running: at 99 Hz
+*           one backtrace() per ~10 ms of CPU time.
+*
+* @warning  Symbols require -rdynamic (see meson.build); functions with
+*           internal linkage appear as module+offset. SIGPROF is reserved
+*           for the profiler once it has first been started. Samples that
+*           find the pool full are dropped; see profiler.dropped_samples.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "CommonDefinitions.h"
+
+namespace SamplingProfiler
+{
+    // Both return false if the profiler was already in the requested state.
+    // Starting discards the previous profile.
+    bool Start();
+    bool Stop();
+
+    bool IsRunning();
+
+    // Samples aggregated into the current profile thus far.
+    uint64_t NumberOfSamples();
+
+    // Writes the aggregate thus far, whether or not still running, and
+    // returns the number of distinct stacks written, or -1 upon failure.
+    int64_t DumpFoldedStacks(const std::string_view& path);
+}
@@ -0,0 +1,282 @@
+#include "SensorDiscovery.h"
+
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <algorithm>
+
+namespace
+{
+    // "<first>[-<last>]"; a single value is a range of one.
+    bool SplitRange(const std::string& text, std::string& first, std::string& last)
+    {
+        auto dash = text.find('-');
+        first = text.substr(0, dash);
+        last = (dash == std::string::npos) ? first : text.substr(dash + 1);
+        return !first.empty() && !last.empty();
+    }
+
+    bool ParseHost(const std::string& text, asio::ip::address_v4& host)
+    {
+        asio::error_code error;
+        host = asio::ip::make_address_v4(text, error);
+        return !error;
+    }
+
+    bool ParsePort(const std::string& text, uint16_t& port)
+    {
+        auto [pEnd, error] = std::from_chars(text.data(), text.data() + text.size(), port);
+        return (error == std::errc()) && (pEnd == text.data() + text.size()) && (port > 0);
+    }
+
+    // Nothing listening, or nothing there: the expected outcomes of a
+    // probe that finds no sensor node.
+    bool IsUnanswered(const std::error_code& error)
+    {
+        return (error == asio::error::connection_refused)
+            || (error == asio::error::operation_aborted)
+            || (error == asio::error::timed_out)
+            || (error == asio::error::host_unreachable)
+            || (error == asio::error::network_unreachable);
+    }
+}
+
+std::vector<DiscoveryRange_t> SensorDiscovery::LoadRanges(const std::string_view& path)
+{
+    std::vector<DiscoveryRange_t> ranges;
+
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        return ranges;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        auto text = line.substr(0, line.find('#'));
+        if (text.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        std::istringstream iss(text);
+        std::string hosts;
+        std::string ports;
+        std::string trailing;
+        std::string first;
+        std::string last;
+        DiscoveryRange_t range{};
+        bool isValid = (iss >> hosts >> ports) && !(iss >> trailing)
+                    && SplitRange(hosts, first, last)
+                    && ParseHost(first, range.m_FirstHost) && ParseHost(last, range.m_LastHost)
+                    && SplitRange(ports, first, last)
+                    && ParsePort(first, range.m_FirstPort) && ParsePort(last, range.m_LastPort)
+                    && (range.m_FirstHost <= range.m_LastHost) && (range.m_FirstPort <= range.m_LastPort);
+        if (!isValid)
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber
+                      << ": Expected \"<host>[-<host>] <port>[-<port>]\"; skipped.\n";
+            continue;
+        }
+
+        ranges.push_back(range);
+    }
+
+    std::cout << "[INFO] Loaded " << ranges.size() << " discovery ranges from " << path << "\n";
+    return ranges;
+}
+
+bool SensorDiscovery::WriteEndpoints(const std::string_view& path, const std::vector<tcp::endpoint>& endpoints)
+{
+    std::ofstream file{std::string(path), std::ios::trunc};
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "# <sensor> <host>:<port>\n";
+    for (size_t i = 0; i < endpoints.size(); i++)
+    {
+        file << i << " " << endpoints[i] << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+SensorDiscovery::SensorDiscovery(asio::io_context& ioContext,
+                                 const PriorityScheduler::executor_type& executor,
+                                 const std::vector<DiscoveryRange_t>& ranges,
+                                 const uint32_t& maximumInFlight,
+                                 const std::chrono::milliseconds& timeout)
+    : m_Ranges(ranges)
+    , m_Timeout(timeout)
+    , m_Strand(executor)
+    , m_Probes()
+    , m_RangeIndex(0)
+    , m_NextHost(0)
+    , m_NextPort(0)
+    , m_NumberInFlight(0)
+    , m_Endpoints()
+    , m_CompletionHandler()
+    , m_Probed(Metrics::Counter("discovery.probes"))
+    , m_Found(Metrics::Counter("discovery.found"))
+    , m_Timeouts(Metrics::Counter("discovery.timeouts"))
+{
+    auto numberOfProbes = std::min<uint64_t>(std::max<uint32_t>(maximumInFlight, 1), NumberOfCandidates());
+    for (uint64_t i = 0; i < numberOfProbes; i++)
+    {
+        m_Probes.push_back(std::make_unique<Probe_t>(ioContext));
+    }
+}
+
+SensorDiscovery::~SensorDiscovery()
+{
+}
+
+void SensorDiscovery::Start(CompletionHandler_t completionHandler)
+{
+    m_CompletionHandler = std::move(completionHandler);
+
+    std::cout << "[INFO] Probing " << NumberOfCandidates() << " endpoints for sensor nodes, "
+              << m_Probes.size() << " at a time\n";
+
+    asio::post(m_Strand, [this]()
+    {
+        if (m_Probes.empty())
+        {
+            Finish();
+            return;
+        }
+
+        m_NumberInFlight = m_Probes.size();
+        for (auto& pProbe : m_Probes)
+        {
+            ProbeNext(*pProbe);
+        }
+    });
+}
+
+uint64_t SensorDiscovery::NumberOfCandidates() const
+{
+    uint64_t candidates = 0;
+    for (const auto& range : m_Ranges)
+    {
+        candidates += (uint64_t{range.m_LastHost.to_uint()} - range.m_FirstHost.to_uint() + 1)
+                    * (uint64_t{range.m_LastPort} - range.m_FirstPort + 1);
+    }
+    return candidates;
+}
+
+bool SensorDiscovery::NextCandidate(tcp::endpoint& endpoint)
+{
+    // Port by port, and every host for each port in turn, such that
+    // consecutive probes are spread across hosts.
+    while (m_RangeIndex < m_Ranges.size())
+    {
+        const auto& range = m_Ranges[m_RangeIndex];
+        if (uint64_t{range.m_FirstPort} + m_NextPort > range.m_LastPort)
+        {
+            ++m_RangeIndex;
+            m_NextHost = 0;
+            m_NextPort = 0;
+            continue;
+        }
+
+        auto host = uint64_t{range.m_FirstHost.to_uint()} + m_NextHost;
+        if (host > range.m_LastHost.to_uint())
+        {
+            m_NextHost = 0;
+            ++m_NextPort;
+            continue;
+        }
+
+        endpoint = tcp::endpoint(asio::ip::address_v4(static_cast<uint32_t>(host)),
+                                 static_cast<uint16_t>(range.m_FirstPort + m_NextPort));
+        ++m_NextHost;
+        return true;
+    }
+    return false;
+}
+
+void SensorDiscovery::ProbeNext(Probe_t& probe)
+{
+    if (!NextCandidate(probe.m_Endpoint))
+    {
+        if (--m_NumberInFlight == 0)
+        {
+            Finish();
+        }
+        return;
+    }
+
+    m_Probed.fetch_add(1, std::memory_order_relaxed);
+    auto generation = ++probe.m_Generation;
+
+    // The socket is opened by the connect itself.
+    probe.m_Socket.async_connect(probe.m_Endpoint, asio::bind_executor(m_Strand,
+    [this, &probe](const std::error_code& error)
+    {
+        HandleConnect(probe, error);
+    }));
+
+    probe.m_TimeoutTimer.expires_after(m_Timeout);
+    probe.m_TimeoutTimer.async_wait(asio::bind_executor(m_Strand,
+    [this, &probe, generation](const std::error_code& error)
+    {
+        // The connect may have completed, and the probe moved on, whilst
+        // this expiry was queued.
+        if ((error == asio::error::operation_aborted) || (generation != probe.m_Generation))
+        {
+            return;
+        }
+
+        // Completes the connect with operation_aborted.
+        m_Timeouts.fetch_add(1, std::memory_order_relaxed);
+        probe.m_Socket.close();
+    }));
+}
+
+void SensorDiscovery::HandleConnect(Probe_t& probe, const std::error_code& error)
+{
+    probe.m_TimeoutTimer.cancel();
+
+    // A connect to a port of this very host within its ephemeral port
+    // range, with nothing listening, may connect the socket to itself.
+    asio::error_code localError;
+    auto localEndpoint = probe.m_Socket.local_endpoint(localError);
+
+    if (!error && !localError && (localEndpoint != probe.m_Endpoint))
+    {
+        m_Found.fetch_add(1, std::memory_order_relaxed);
+        m_Endpoints.push_back(probe.m_Endpoint);
+    }
+    else if (error && !IsUnanswered(error))
+    {
+        // E.g. out of file descriptors; the endpoint may well be a sensor
+        // node, so say so.
+        std::cout << "[WARN] Unable to probe " << probe.m_Endpoint << ": " << error.message() << "\n";
+    }
+
+    // The session manager connects anew.
+    probe.m_Socket.close();
+
+    ProbeNext(probe);
+}
+
+void SensorDiscovery::Finish()
+{
+    // Overlapping ranges probe some endpoints more than once.
+    std::sort(m_Endpoints.begin(), m_Endpoints.end());
+    m_Endpoints.erase(std::unique(m_Endpoints.begin(), m_Endpoints.end()), m_Endpoints.end());
+
+    std::cout << "[INFO] Discovered " << m_Endpoints.size() << " sensor nodes among "
+              << NumberOfCandidates() << " endpoints probed\n";
+
+    if (m_CompletionHandler)
+    {
+        m_CompletionHandler(std::move(m_Endpoints));
+    }
+}
@@ -0,0 +1,134 @@
+/***********************************************************************
+* @file      SensorDiscovery.h
+*
+* Commissioning of large sites: rather than deriving each sensor node's
+* endpoint from its number, probe ranges of hosts and ports for sensor
+* nodes, and number whichever answer.
+*
+* @brief    Ranges are given one per line in DISCOVERY_RANGES_PATH, hosts
+*           and ports each either single or an inclusive range:
+*
+*           # <host>[-<host>] <port>[-<port>]
+*           127.0.0.1             5000-5999
+*           10.0.1.1-10.0.1.254   5000
+*
+*           Every candidate endpoint is probed with a TCP connect, at most
+*           DISCOVERY_MAXIMUM_IN_FLIGHT_CONNECTS at once, each abandoned
+*           after DISCOVERY_CONNECT_TIMEOUT_MILLISECONDS. An endpoint that
+*           accepts the connect is a sensor node; the probe's connection is
+*           then closed, and the session manager connects anew.
+*
+*           Candidates are enumerated lazily, so that ranges of any size
+*           cost memory only for the probes in flight and the endpoints
+*           found. A probe that completes, by whatever outcome, starts the
+*           next candidate at once rather than waiting on its peers.
+*
+*           The endpoints found are sorted by host, then port, such that
+*           sensor numbers are stable from one discovery to the next so
+*           long as the same nodes answer; they are written, one per line
+*           with their sensor numbers, to DISCOVERED_SENSORS_PATH so that
+*           calibration and sensor layouts may be keyed to them.
+*
+* @note     Probes run on a strand of their own at
+*           HandlerPriority_t::RECONNECT (see PriorityExecutor.h).
+*
+*           Metrics: discovery.probes, discovery.found,
+*           discovery.timeouts.
+*
+* @warning  Probing is indistinguishable from a port scan to network
+*           security monitoring; only probe ranges the site owns.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 18, 2026
+***********************************************************************/
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "PriorityExecutor.h"
+
+struct DiscoveryRange_t
+{
+    asio::ip::address_v4       m_FirstHost;
+    asio::ip::address_v4       m_LastHost;
+    uint16_t                   m_FirstPort;
+    uint16_t                   m_LastPort;
+};
+
+class SensorDiscovery
+{
+    struct Probe_t
+    {
+        explicit Probe_t(asio::io_context& ioContext)
+            : m_Socket(ioContext)
+            , m_TimeoutTimer(ioContext)
+            , m_Endpoint()
+            , m_Generation(0)
+        {
+        }
+
+        tcp::socket                m_Socket;
+        asio::steady_timer         m_TimeoutTimer;
+        tcp::endpoint              m_Endpoint;
+        uint64_t                   m_Generation; // Tells a stale timeout from the current.
+    };
+
+    using Strand_t = asio::strand<PriorityScheduler::executor_type>;
+
+public:
+    // Called (on a dispatcher thread) once every candidate has been probed,
+    // with the endpoints found, sorted.
+    using CompletionHandler_t = std::function<void(std::vector<tcp::endpoint> endpoints)>;
+
+    // Malformed lines, and ranges running backwards, are reported and
+    // skipped. A missing file simply names no ranges.
+    static std::vector<DiscoveryRange_t> LoadRanges(const std::string_view& path);
+
+    // One line, "<sensor> <host>:<port>", per sensor.
+    static bool WriteEndpoints(const std::string_view& path, const std::vector<tcp::endpoint>& endpoints);
+
+    SensorDiscovery(asio::io_context& ioContext, const PriorityScheduler::executor_type& executor,
+                    const std::vector<DiscoveryRange_t>& ranges,
+                    const uint32_t& maximumInFlight = DISCOVERY_MAXIMUM_IN_FLIGHT_CONNECTS,
+                    const std::chrono::milliseconds& timeout = std::chrono::milliseconds(DISCOVERY_CONNECT_TIMEOUT_MILLISECONDS));
+    virtual ~SensorDiscovery();
+
+    SensorDiscovery(const SensorDiscovery&) = delete;
+    SensorDiscovery& operator=(const SensorDiscovery&) = delete;
+
+    void Start(CompletionHandler_t completionHandler);
+
+    // Candidate endpoints in all ranges, duplicates included.
+    uint64_t NumberOfCandidates() const;
+
+protected:
+    // Require the strand.
+    bool NextCandidate(tcp::endpoint& endpoint);
+    void ProbeNext(Probe_t& probe);
+    void HandleConnect(Probe_t& probe, const std::error_code& error);
+    void Finish();
+
+private:
+    std::vector<DiscoveryRange_t>              m_Ranges;
+    std::chrono::milliseconds                  m_Timeout;
+    Strand_t                                   m_Strand;
+    std::vector<std::unique_ptr<Probe_t>>      m_Probes;
+
+    // The next candidate: its range, and host and port within it.
+    size_t                                     m_RangeIndex;
+    uint32_t                                   m_NextHost;
+    uint32_t                                   m_NextPort;
+
+    size_t                                     m_NumberInFlight;
+    std::vector<tcp::endpoint>                 m_Endpoints;
+    CompletionHandler_t                        m_CompletionHandler;
+
+    Metrics::Counter_t&                        m_Probed;
+    Metrics::Counter_t&                        m_Found;
+    Metrics::Counter_t&                        m_Timeouts;
+};
@@ -0,0 +1,212 @@
+/***********************************************************************
+* @file      SensorSnapshot.h
+*
+* Immutable, epoch-stamped snapshots of the sensor table. Readers that
+* are not part of the ingest path (the ops query API, exporters, the 
+* display, etc.) only ever observe a complete snapshot, which they can 
+* hold onto for as long as they wish without ever contending with the
+* dispatcher threads that are busy ingesting temperature readings.
+*
+* @brief
+*
+* @note     Snapshots are taken from the SensorTable (see SensorTable.h).
+*
+* @warning  Never mutate a snapshot once taken. Hence we only ever hand
+*           out pointers-to-const.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <charconv>
+#include "CommonDefinitions.h"
+
+struct SensorSample_t
+{
+    uint32_t                   m_SensorNodeNumber{0};
+    uint8_t                    m_Zone{0};
+    bool                       m_HasReading{false};
+    double                     m_Value{0.0}; // In the unit of the snapshot's channel.
+    SteadyClock_t::time_point  m_ReadingTime{};
+};
+
+struct SensorTableSnapshot_t
+{
+    SensorChannel_t                m_Channel{SensorChannel_t::TEMPERATURE};
+
+    // Number of updates of that channel that this snapshot reflects.
+    uint64_t                       m_Epoch{0};
+    
+    // False only if writers kept racing us past our retry budget; each
+    // sample is then still individually consistent.
+    bool                           m_IsConsistent{true};
+    std::vector<SensorSample_t>    m_Sensors{};
+};
+
+using SnapshotPointer_t = std::shared_ptr<const SensorTableSnapshot_t>;
+
+namespace Utility
+{
+    // Sensor zones are, for now, assigned round-robin by sensor node
+    // number. For instance, with 2 zones, even nodes are zone 0 and odd
+    // nodes are zone 1.
+    constexpr uint8_t ZoneOf(const size_t& sensorNodeNumber)
+    {
+        return static_cast<uint8_t>(sensorNodeNumber % NUMBER_OF_SENSOR_ZONES);
+    }
+
+    // A reading taken at readingTime is no older than
+    // STALE_READING_DURATION_MINUTES as of timeNow.
+    constexpr bool IsFresh(const SteadyClock_t::time_point& readingTime,
+                           const SteadyClock_t::time_point& timeNow)
+    {
+        return (timeNow - readingTime) < Minutes_t(STALE_READING_DURATION_MINUTES);
+    }
+
+    inline bool IsFresh(const SensorSample_t& sample, const SteadyClock_t::time_point& timeNow)
+    {
+        return sample.m_HasReading && IsFresh(sample.m_ReadingTime, timeNow);
+    }
+
+    // "<prefix><n>", e.g. "sensor:12"; false if not of that form.
+    inline bool ParseIndex(const std::string_view& input, const std::string_view& prefix, size_t& index)
+    {
+        if (input.substr(0, prefix.size()) != prefix)
+        {
+            return false;
+        }
+        auto digits = input.substr(prefix.size());
+        auto [pEnd, error] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+        return (error == std::errc()) && (pEnd == digits.data() + digits.size()) && !digits.empty();
+    }
+
+    constexpr std::array<std::string_view, NUMBER_OF_SENSOR_CHANNELS> SENSOR_CHANNEL_NAMES =
+    {
+        "temperature", "humidity", "pressure"
+    };
+
+    constexpr std::array<std::string_view, NUMBER_OF_SENSOR_CHANNELS> SENSOR_CHANNEL_UNITS =
+    {
+        "°C", "%RH", "hPa"
+    };
+
+    constexpr std::string_view ChannelName(const SensorChannel_t& channel)
+    {
+        return SENSOR_CHANNEL_NAMES[static_cast<size_t>(channel)];
+    }
+
+    constexpr std::string_view ChannelUnit(const SensorChannel_t& channel)
+    {
+        return SENSOR_CHANNEL_UNITS[static_cast<size_t>(channel)];
+    }
+
+    // False if name is no channel's.
+    inline bool ParseChannel(const std::string_view& name, SensorChannel_t& channel)
+    {
+        for (size_t i = 0; i < SENSOR_CHANNEL_NAMES.size(); i++)
+        {
+            if (name == SENSOR_CHANNEL_NAMES[i])
+            {
+                channel = static_cast<SensorChannel_t>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Should a fast sensor have coalesced several lines into one receive,
+    // the last complete line is the latest reading; whatever follows the
+    // last '\n' is a line yet to be completed, and is ignored. Returns it
+    // trimmed of surrounding whitespace; empty if there is none.
+    inline std::string_view LatestLine(std::string_view text)
+    {
+        const auto end = text.rfind('\n');
+        if (end == std::string_view::npos)
+        {
+            return {};
+        }
+        text = text.substr(0, end);
+
+        // Trim surrounding whitespace, carriage returns and line feeds.
+        const auto last = text.find_last_not_of(" \t\r\n");
+        if (last == std::string_view::npos)
+        {
+            return {};
+        }
+        text = text.substr(0, last + 1);
+
+        const auto newline = text.find_last_of('\n');
+        if (newline != std::string_view::npos)
+        {
+            text = text.substr(newline + 1);
+        }
+
+        const auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+        {
+            return {};
+        }
+        return text.substr(first);
+    }
+
+    // One bit per SensorChannel_t.
+    using ChannelMask_t = uint8_t;
+
+    static_assert(NUMBER_OF_SENSOR_CHANNELS <= 8, "ChannelMask_t holds one bit per channel");
+
+    // Parse the latest line of a multi-channel node, e.g.
+    //
+    //   temperature=21.5 humidity=40.2 pressure=1013.2
+    //
+    // into values, indexed by channel. A bare number is a temperature.
+    // Returns the channels present; none if the sensor sent us gibberish.
+    inline ChannelMask_t ParseSensorReading(std::string_view text,
+                                            std::array<double, NUMBER_OF_SENSOR_CHANNELS>& values)
+    {
+        text = LatestLine(text);
+        if (text.empty())
+        {
+            return 0;
+        }
+
+        if (text.find('=') == std::string_view::npos)
+        {
+            auto& value = values[static_cast<size_t>(SensorChannel_t::TEMPERATURE)];
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            return ((ec == std::errc()) && (ptr == text.data() + text.size()))
+                 ? static_cast<ChannelMask_t>(1U << static_cast<size_t>(SensorChannel_t::TEMPERATURE))
+                 : 0;
+        }
+
+        ChannelMask_t channels = 0;
+        while (!text.empty())
+        {
+            auto end = text.find_first_of(" \t");
+            auto field = text.substr(0, end);
+            text = (end == std::string_view::npos) ? std::string_view{}
+                                                   : text.substr(text.find_first_not_of(" \t", end));
+
+            auto equals = field.find('=');
+            auto channel = SensorChannel_t::TEMPERATURE;
+            if ((equals == std::string_view::npos) || !ParseChannel(field.substr(0, equals), channel))
+            {
+                return 0;
+            }
+
+            auto number = field.substr(equals + 1);
+            auto& value = values[static_cast<size_t>(channel)];
+            auto [pEnd, error] = std::from_chars(number.data(), number.data() + number.size(), value);
+            if (number.empty() || (error != std::errc()) || (pEnd != number.data() + number.size()))
+            {
+                return 0;
+            }
+            channels |= static_cast<ChannelMask_t>(1U << static_cast<size_t>(channel));
+        }
+        return channels;
+    }
+}
@@ -0,0 +1,196 @@
+#include "SensorTable.h"
+
+SensorTable::Column_t::Column_t(const size_t& capacity)
+    : m_pRecords(std::make_unique<std::atomic<SensorRecord_t*>[]>(capacity))
+    , m_UpdatesBegun(0)
+    , m_UpdatesCompleted(0)
+{
+    for (size_t i = 0; i < capacity; i++)
+    {
+        // No reading as yet, i.e. stale.
+        m_pRecords[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SensorTable::SensorTable(const size_t& capacity)
+    : m_Capacity(capacity)
+    , m_pColumns()
+    , m_pZones(std::make_unique<uint8_t[]>(capacity))
+    , m_TheEpochDomain()
+    , m_InconsistentSnapshots(0)
+{
+    for (auto& pColumn : m_pColumns)
+    {
+        pColumn.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Every site reports temperature.
+    MakeColumn(SensorChannel_t::TEMPERATURE);
+
+    for (size_t i = 0; i < m_Capacity; i++)
+    {
+        m_pZones[i] = Utility::ZoneOf(i);
+    }
+}
+
+SensorTable::~SensorTable()
+{
+    for (auto& pColumn : m_pColumns)
+    {
+        std::unique_ptr<Column_t> pOwned(pColumn.exchange(nullptr));
+        if (pOwned)
+        {
+            for (size_t i = 0; i < m_Capacity; i++)
+            {
+                delete pOwned->m_pRecords[i].exchange(nullptr);
+            }
+        }
+    }
+}
+
+size_t SensorTable::Size() const
+{
+    return m_Capacity;
+}
+
+bool SensorTable::HasChannel(const SensorChannel_t& channel) const
+{
+    return ColumnOf(channel) != nullptr;
+}
+
+const SensorTable::Column_t* SensorTable::ColumnOf(const SensorChannel_t& channel) const
+{
+    return m_pColumns[static_cast<size_t>(channel)].load(std::memory_order_acquire);
+}
+
+SensorTable::Column_t& SensorTable::MakeColumn(const SensorChannel_t& channel)
+{
+    auto& pColumn = m_pColumns[static_cast<size_t>(channel)];
+    auto pExisting = pColumn.load(std::memory_order_acquire);
+    if (pExisting != nullptr)
+    {
+        return *pExisting;
+    }
+
+    // Writers racing upon a channel's first reading each build a column;
+    // but one is published. Columns are never retired thereafter.
+    auto pNew = std::make_unique<Column_t>(m_Capacity);
+    if (pColumn.compare_exchange_strong(pExisting, pNew.get(), std::memory_order_acq_rel))
+    {
+        return *pNew.release();
+    }
+    return *pExisting;
+}
+
+void SensorTable::Update(const size_t& sensorNodeNumber, const double& value,
+                         const SteadyClock_t::time_point& readingTime,
+                         const SensorChannel_t& channel)
+{
+    auto& column = MakeColumn(channel);
+
+    // Read-Copy-Update. Records are immutable once published.
+    auto pRecord = new SensorRecord_t{value, readingTime};
+
+    // Writer side of the sequence check (see TakeSnapshot()).
+    column.m_UpdatesBegun.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto pOldRecord = column.m_pRecords[sensorNodeNumber].exchange(pRecord, std::memory_order_seq_cst);
+
+    column.m_UpdatesCompleted.fetch_add(1, std::memory_order_release);
+
+    // Some reader may yet be copying the old record; defer its deletion
+    // until no such reader is left.
+    if (pOldRecord != nullptr)
+    {
+        m_TheEpochDomain.Retire(pOldRecord);
+    }
+}
+
+void SensorTable::ReadRecord(const Column_t* pColumn, const size_t& sensorNodeNumber,
+                             SensorSample_t& sample) const
+{
+    // Caller must have pinned the epoch domain.
+    auto pRecord = (pColumn != nullptr) ? pColumn->m_pRecords[sensorNodeNumber].load(std::memory_order_acquire)
+                                        : nullptr;
+
+    sample.m_SensorNodeNumber = static_cast<uint32_t>(sensorNodeNumber);
+    sample.m_Zone = m_pZones[sensorNodeNumber];
+    sample.m_HasReading = (pRecord != nullptr);
+
+    if (pRecord != nullptr)
+    {
+        sample.m_Value = pRecord->m_Value;
+        sample.m_ReadingTime = pRecord->m_ReadingTime;
+    }
+}
+
+SensorSample_t SensorTable::Read(const size_t& sensorNodeNumber, const SensorChannel_t& channel) const
+{
+    SensorSample_t sample;
+
+    Utility::EpochDomain::ReadGuard_t guard(m_TheEpochDomain);
+    ReadRecord(ColumnOf(channel), sensorNodeNumber, sample);
+
+    return sample;
+}
+
+SnapshotPointer_t SensorTable::TakeSnapshot(const SensorChannel_t& channel) const
+{
+    auto snapshot = std::make_shared<SensorTableSnapshot_t>();
+    snapshot->m_Channel = channel;
+    snapshot->m_Sensors.resize(m_Capacity);
+
+    auto pColumn = ColumnOf(channel);
+    if (pColumn == nullptr)
+    {
+        // Not a single reading of the channel, hence trivially consistent.
+        for (size_t i = 0; i < m_Capacity; i++)
+        {
+            ReadRecord(nullptr, i, snapshot->m_Sensors[i]);
+        }
+        return snapshot;
+    }
+
+    for (size_t attempt = 0; attempt < MAXIMUM_SNAPSHOT_RETRIES; attempt++)
+    {
+        auto completedBefore = pColumn->m_UpdatesCompleted.load(std::memory_order_acquire);
+
+        {
+            Utility::EpochDomain::ReadGuard_t guard(m_TheEpochDomain);
+            for (size_t i = 0; i < m_Capacity; i++)
+            {
+                ReadRecord(pColumn, i, snapshot->m_Sensors[i]);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto begunAfter = pColumn->m_UpdatesBegun.load(std::memory_order_relaxed);
+
+        // No update was in flight nor began whilst we were collecting,
+        // hence the snapshot reflects one single point in time.
+        if (begunAfter == completedBefore)
+        {
+            snapshot->m_Epoch = completedBefore;
+            snapshot->m_IsConsistent = true;
+            return snapshot;
+        }
+    }
+
+    m_InconsistentSnapshots.fetch_add(1, std::memory_order_relaxed);
+
+    snapshot->m_Epoch = pColumn->m_UpdatesCompleted.load(std::memory_order_acquire);
+    snapshot->m_IsConsistent = false;
+    return snapshot;
+}
+
+uint64_t SensorTable::Epoch(const SensorChannel_t& channel) const
+{
+    auto pColumn = ColumnOf(channel);
+    return (pColumn != nullptr) ? pColumn->m_UpdatesCompleted.load(std::memory_order_acquire) : 0;
+}
+
+uint64_t SensorTable::InconsistentSnapshotCount() const
+{
+    return m_InconsistentSnapshots.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,110 @@
+/***********************************************************************
+* @file      SensorTable.h
+*
+* The sensor table holds the latest reading of every sensor node. It is
+* written concurrently by the dispatcher threads and read concurrently
+* by the display, the query API and any exporters, with neither side
+* ever taking a lock.
+*
+* @brief    RCU (Read-Copy-Update) on a per-sensor granularity: each sensor
+*           entry is an atomic pointer to an immutable record. A writer
+*           allocates a fresh record, atomically exchanges it in, and
+*           retires the old record to the epoch reclamation domain.
+*           Readers pin the domain, copy the records they need, and unpin.
+*
+*           Cross-sensor consistency of snapshots is obtained with a
+*           multi-writer sequence check: a snapshot is consistent if no
+*           update began whilst we were collecting it. Readers retry a
+*           bounded number of times so that they too never block.
+*
+*           Storage is columnar: each channel (temperature, humidity,
+*           pressure; see SensorChannel_t) has a dense column of records,
+*           and sequence counters, of its own. Temperature's column always
+*           exists; any other is allocated upon the channel's first reading,
+*           so that a temperature-only site pays for one column only, and
+*           a snapshot of one channel is never retried for another's updates.
+*
+* @note     See EpochReclamation.h for the reclamation scheme.
+*
+* @warning
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include "SensorSnapshot.h"
+#include "EpochReclamation.h"
+
+class SensorTable
+{
+    // Beyond this, writers are outpacing us so much that a per-sample
+    // consistent snapshot is the best that we can non-blockingly offer.
+    static constexpr size_t MAXIMUM_SNAPSHOT_RETRIES = 8;
+
+    struct SensorRecord_t
+    {
+        double                     m_Value;
+        SteadyClock_t::time_point  m_ReadingTime;
+    };
+
+    struct Column_t
+    {
+        explicit Column_t(const size_t& capacity);
+
+        std::unique_ptr<std::atomic<SensorRecord_t*>[]> m_pRecords;
+
+        alignas(64) std::atomic<uint64_t>              m_UpdatesBegun;
+        alignas(64) std::atomic<uint64_t>              m_UpdatesCompleted;
+    };
+
+public:
+    explicit SensorTable(const size_t& capacity);
+    virtual ~SensorTable();
+
+    SensorTable(const SensorTable&) = delete;
+    SensorTable& operator=(const SensorTable&) = delete;
+
+    size_t Size() const;
+
+    // Whether any reading of the channel has been applied as yet.
+    bool HasChannel(const SensorChannel_t& channel) const;
+
+    // Lock-free; safe to call concurrently from any dispatcher thread.
+    void Update(const size_t& sensorNodeNumber, const double& value,
+                const SteadyClock_t::time_point& readingTime,
+                const SensorChannel_t& channel = SensorChannel_t::TEMPERATURE);
+
+    // Never blocks; safe to call concurrently from any reader thread.
+    // Sensors have no reading of a channel not in use.
+    SensorSample_t Read(const size_t& sensorNodeNumber,
+                        const SensorChannel_t& channel = SensorChannel_t::TEMPERATURE) const;
+    SnapshotPointer_t TakeSnapshot(const SensorChannel_t& channel = SensorChannel_t::TEMPERATURE) const;
+
+    // Updates of the channel completed as yet, i.e. the epoch that a
+    // snapshot taken now would carry; O(1).
+    uint64_t Epoch(const SensorChannel_t& channel = SensorChannel_t::TEMPERATURE) const;
+
+    uint64_t InconsistentSnapshotCount() const;
+
+private:
+    // Null if the channel is not in use as yet.
+    const Column_t* ColumnOf(const SensorChannel_t& channel) const;
+    Column_t& MakeColumn(const SensorChannel_t& channel);
+
+    void ReadRecord(const Column_t* pColumn, const size_t& sensorNodeNumber,
+                    SensorSample_t& sample) const;
+
+    size_t                                                        m_Capacity;
+    std::array<std::atomic<Column_t*>, NUMBER_OF_SENSOR_CHANNELS> m_pColumns;
+    std::unique_ptr<uint8_t[]>                                    m_pZones;
+
+    // Readers pin the domain, hence it being mutable.
+    mutable Utility::EpochDomain                                  m_TheEpochDomain;
+
+    mutable std::atomic<uint64_t>                                 m_InconsistentSnapshots;
+};
@@ -1,11 +1,17 @@
 #include "SessionManager.h"
+#include "TokenBucket.h"
+#include "FlightRecorder.h"
+#include "PerfCounters.h"
 
 namespace Common
 {
     asio::io_context                     g_DispatcherIOContext;
     std::optional<ExecutorWorkGuard_t>   g_DispatcherWork;
     //std::optional<ExecutorWorkGuard_t> g_DispatcherWork(g_DispatcherIOContext.get_executor());
-    ThreadPack_t                         g_DispatcherWorkerThreads;
+    std::optional<ElasticDispatcher>     g_DispatcherWorkerThreads;
+    std::optional<PriorityScheduler>     g_DispatcherPriorities;
+    std::optional<WorkStealingPool>      g_AnalyticsWorkPool;
+    std::optional<HandlerWatchdog>       g_DispatcherWatchdog;
 
     void SetupIOContext()
     {
@@ -23,29 +29,42 @@ namespace Common
                      asio::require(g_DispatcherIOContext.get_executor(),
                      asio::execution::outstanding_work.tracked)
                      );
+
+        g_DispatcherPriorities.emplace(g_DispatcherIOContext);
+
+        g_DispatcherWorkerThreads.emplace(g_DispatcherIOContext,
+                                          MINIMUM_DISPATCHER_THREADS,
+                                          MAXIMUM_DISPATCHER_THREADS);
+
+        // Unlike io_context, the work-stealing pool threads simply sleep
+        // when out of work, until they are explicitly stopped.
+        g_AnalyticsWorkPool.emplace(ANALYTICS_THREAD_POOL_SIZE, "Analytics");
+
+        g_DispatcherWatchdog.emplace(
+            std::chrono::milliseconds(WATCHDOG_HANDLER_BUDGET_MILLISECONDS),
+            std::chrono::milliseconds(WATCHDOG_CHECK_INTERVAL_MILLISECONDS));
     }
 
     void RunWorkerThreads()
     {
-        for (std::size_t i = 0; i < DISPATCHER_THREAD_POOL_SIZE; ++i)
-        {
-            // Create the std::thread that will wait for ALL 'work' 
-            // (past, present and future) to be scheduled from the 
-            // potentially many asynchronous socket instances.
-            g_DispatcherWorkerThreads[i] = std::move(std::thread(DispatcherWorkerThread));
-        }
+        // Create the std::thread(s) that will wait for ALL 'work' 
+        // (past, present and future) to be scheduled from the 
+        // potentially many asynchronous socket instances. More are
+        // created (and retired) as the load dictates.
+        g_DispatcherWorkerThreads->Start();
+        g_DispatcherWatchdog->Start();
     }
 
     void JoinWorkerThreads()
     {
         try
         {
-            for (auto& thread : g_DispatcherWorkerThreads)
+            g_DispatcherWorkerThreads->Join();
+            g_DispatcherWatchdog->Stop();
+
+            if (g_AnalyticsWorkPool)
             {
-                if (thread.joinable())
-                {
-                    thread.join();
-                }
+                g_AnalyticsWorkPool->Join();
             }
         }
         catch (const std::exception& e)
@@ -98,54 +117,120 @@ namespace Common
         // nor depend upon any of its side-effects observed at any time.
         //
         g_DispatcherIOContext.stop();
+
+        // Whatever analytics work is already queued is completed first.
+        if (g_AnalyticsWorkPool)
+        {
+            g_AnalyticsWorkPool->Stop();
+        }
     }
 }
 
-// Customer Requirement:
-//
-// "Each node has a static IP, listens on a port, accepts a connection,
-// and then sends the latest temperature reading, in deg C, on one line
-// of ascii text."
-using TcpData_t = std::array<char, MAXIMUM_TCP_DATA_LENGTH>;
-
-struct SensorNode_t
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ReportReadFailure(
+    const size_t& sensorNodeNumber, const std::error_code& error) const
 {
-    SensorNode_t()
-        : m_Host(SENSOR_NODE_STATIC_IP) // Same test laptop, same LAN, same IP=localhost.
-        , m_Port()
-        , m_ConnectionSocket(Common::g_DispatcherIOContext)
-        , m_TcpData()
-        , m_CurrentReadingTime()
-    {
-    }
-        
-    virtual ~SensorNode_t()
-    {
-    }
-    
-    std::string                m_Host; // TCP host.
-    std::string                m_Port; // TCP port number.
-    tcp::socket                m_ConnectionSocket;
-    TcpData_t                  m_TcpData;
-    std::string                m_CurrentTemperatureReading;
-    SystemClock_t::time_point  m_CurrentReadingTime;
-};
+    std::ostringstream oss;
 
-using SensorPack_t = std::array<SensorNode_t, NUMBER_OF_SENSOR_NODES>;
+    oss << "Code: " << error.value() << '\n';
+    oss << "\t\tCategory: " << error.category().name() << '\n';
+    oss << "\t\tMessage: " << error.message() << '\n';
 
-// Also value-initialize all sensor node abstractions.
-static SensorPack_t g_TheCustomerSensors{};
+    std::cout << "[ERROR] Failure in reading from TCP socket connection:\n\t" 
+              << m_TheCustomerSensors[sensorNodeNumber].m_Host 
+              << ":" 
+              << m_TheCustomerSensors[sensorNodeNumber].m_Port 
+              << "\n\tValue := \"" 
+              << oss.str() << "\"\n";
+}
 
-SessionManager::SessionManager()
-    : m_NumberOfConnectedSockets(0)
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::BasicSessionManager(
+    const size_t& numberOfSensors)
+    : m_TheCustomerSensors(MakeSensorPack(numberOfSensors))
+    , m_NumberOfConnectedSockets(0)
     , m_TheDisplayMutex()
     , m_LastReadoutTime()
+    , m_TheSensorTable(NumberOfSensors())
+    , m_AggregationMutex()
+    , m_TheAggregators()
+    , m_TheChannelHistory()
+    , m_TheVirtualSensors(NumberOfSensors(), VirtualSensorGraph::LoadDefinitions(VIRTUAL_SENSORS_PATH))
+    , m_TheAnomalyDetector(NumberOfSensors())
+    , m_TheAlertRules(Common::g_DispatcherIOContext,
+                      Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::ALERT),
+                      m_TheSensorTable, NumberOfSensors(), AlertRuleEngine::LoadDefinitions(ALERT_RULES_PATH))
+    , m_TheSiteHeatmap(Common::g_DispatcherIOContext,
+                       Common::g_AnalyticsWorkPool->get_executor(),
+                       m_TheSensorTable, NumberOfSensors(),
+                       SiteHeatmap::LoadLayout(SENSOR_LAYOUT_PATH, NumberOfSensors()))
+    , m_TheCalibration(NumberOfSensors())
+    , m_TheIngestPipeline(m_TheSensorTable, [this]()
+      {
+          ScheduleDisplay();
+      },
+      [this](const SensorChannel_t& channel, const ReadingRecord_t* pRecords, const size_t& count)
+      {
+          {
+              std::unique_lock<std::mutex> lock(m_AggregationMutex);
+              auto& pAggregator = m_TheAggregators[static_cast<size_t>(channel)];
+              if (!pAggregator)
+              {
+                  pAggregator = std::make_unique<Aggregator_t>(NumberOfSensors());
+              }
+              for (size_t i = 0; i < count; i++)
+              {
+                  pAggregator->Update(pRecords[i].m_SensorNodeNumber, pRecords[i].m_Value,
+                                      pRecords[i].m_ReadingTime);
+              }
+          }
+
+          // Anomalies, alerts, the heatmap and virtual sensors are of
+          // temperature only.
+          if (channel == SensorChannel_t::TEMPERATURE)
+          {
+              m_TheAnomalyDetector.Detect(pRecords, count);
+              m_TheAlertRules.Apply(pRecords, count);
+              m_TheSiteHeatmap.Apply(pRecords, count);
+              m_TheVirtualSensors.Apply(pRecords, count);
+          }
+      },
+      &m_TheCalibration)
+    , m_TheOverloadController(Common::g_DispatcherIOContext, NumberOfSensors(),
+      [this]()
+      {
+          return m_TheIngestPipeline.TakeMaximumLag();
+      },
+      [this](bool isOverloaded)
+      {
+          m_TheIngestPipeline.SetConflating(isOverloaded);
+      })
+    , m_ReadyMutex()
+    , m_ReadySensors()
+    , m_SweepBatchSizes(Metrics::Histogram("ingest.sweep.batch_size"))
+    , m_IsDisplayPending(false)
+    , m_ReadingsCoalesced(Metrics::Counter("ingest.records.coalesced"))
+    , m_ReadsThrottled(Metrics::Counter("ingest.reads.throttled"))
+    , m_FloodingSensors(Metrics::Gauge("ingest.flooding_sensors"))
 {
+    if (IS_FIXED_SIZE && (numberOfSensors != SENSOR_COUNT))
+    {
+        std::cout << "[WARN] This build is specialised for " << SENSOR_COUNT
+                  << " sensor nodes; ignoring the requested " << numberOfSensors << ".\n";
+    }
+
+    // Every site reports temperature.
+    m_TheAggregators[static_cast<size_t>(SensorChannel_t::TEMPERATURE)] =
+        std::make_unique<Aggregator_t>(NumberOfSensors());
+
+    // Uncalibrated readings are used as they are, bar the range check.
+    m_TheCalibration.Load(CALIBRATION_PATH);
+
     // Initialize variable values for all sensor node abstractions.
-    for (size_t i = 0; i < g_TheCustomerSensors.size(); i++) 
+    for (size_t i = 0; i < m_TheCustomerSensors.size(); i++) 
     {
         // Use a different port for each sensor node.
-        g_TheCustomerSensors[i].m_Port = std::to_string(EPHEMERAL_PORT_NUMBER_BASE_VALUE + i);
+        m_TheCustomerSensors[i].m_Port = std::to_string(EPHEMERAL_PORT_NUMBER_BASE_VALUE + i);
         
         // All operations to occur on ALL the socket connections will
         // occur asynchronously but in the same worker thread context 
@@ -154,16 +239,13 @@ SessionManager::SessionManager()
         
         // Note that since tcp::socket is not default constructible nor 
         // assignable, we already explicitly constructed 
-        // g_TheCustomerSensors[i].m_ConnectionSocket as required in the
+        // m_TheCustomerSensors[i].m_ConnectionSocket as required in the
         // SensorNode_t default constructor.
         
-        // No temperature reading as yet.
-        g_TheCustomerSensors[i].m_TcpData = {}; // Initialize to zeros.
-        g_TheCustomerSensors[i].m_CurrentTemperatureReading = "";
-        
-        // Since no readings exist as yet, default all readings to stale.
-        g_TheCustomerSensors[i].m_CurrentReadingTime = SystemClock_t::now()
-                - Minutes_t(STALE_READING_DURATION_MINUTES + 1);
+        // No temperature reading as yet. Note that the sensor table
+        // already considers sensors without any reading to be stale.
+        std::fill(m_TheCustomerSensors[i].m_TcpData.begin(),
+                  m_TheCustomerSensors[i].m_TcpData.end(), 0); // Initialize to zeros.
     }
     
     // Initial display.
@@ -177,29 +259,148 @@ SessionManager::SessionManager()
         // shall display “--.- °C”."
         std::cout << "\t\t--.- °C" << "\n";
         
-        m_LastReadoutTime = SystemClock_t::now();
+        m_LastReadoutTime = SteadyClock_t::now();
     }
 }
 
-SessionManager::~SessionManager()
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::BasicSessionManager(
+    const std::vector<tcp::endpoint>& endpoints)
+    : BasicSessionManager(endpoints.size())
+{
+    // Fixed-size builds leave any sensors beyond the endpoints where they
+    // were.
+    auto numberOfEndpoints = std::min(endpoints.size(), m_TheCustomerSensors.size());
+    for (size_t i = 0; i < numberOfEndpoints; i++)
+    {
+        m_TheCustomerSensors[i].m_Host = endpoints[i].address().to_string();
+        m_TheCustomerSensors[i].m_Port = std::to_string(endpoints[i].port());
+    }
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::~BasicSessionManager()
 {
 }
 
-void SessionManager::Start()
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::Start()
 {        
+    // The aggregation stage must be ready before the first reading arrives.
+    m_TheIngestPipeline.Start();
+    m_TheOverloadController.Start();
+    m_TheAlertRules.Start();
+    m_TheSiteHeatmap.Start();
+
     // Attempt to connect to ALL the temperature sensor nodes.
-    for (size_t i = 0; i < g_TheCustomerSensors.size(); i++) 
+    for (size_t i = 0; i < m_TheCustomerSensors.size(); i++) 
     {
         StartConnect(i);
     }
 }
 
-void SessionManager::StartConnect(const uint8_t& sensorNodeNumber)
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::Stop()
+{
+    m_TheSiteHeatmap.Stop();
+    m_TheAlertRules.Stop();
+    m_TheOverloadController.Stop();
+    m_TheIngestPipeline.Stop();
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+const SensorTable& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetSensorTable() const
+{
+    return m_TheSensorTable;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+const VirtualSensorGraph& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetVirtualSensors() const
+{
+    return m_TheVirtualSensors;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+AnomalyDetector& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetAnomalyDetector()
+{
+    return m_TheAnomalyDetector;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+const AlertRuleEngine& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetAlertRules() const
+{
+    return m_TheAlertRules;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+const SiteHeatmap& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetSiteHeatmap() const
+{
+    return m_TheSiteHeatmap;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+const ChannelHistory& BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::GetChannelHistory() const
+{
+    return m_TheChannelHistory;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+bool BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ReloadCalibration()
+{
+    return m_TheCalibration.Load(CALIBRATION_PATH);
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+size_t BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::NumberOfSensors() const
+{
+    return m_TheCustomerSensors.size();
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+size_t BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::FootprintBytes() const
+{
+    // The sensor nodes and their receive buffers, and the temperature
+    // aggregator; the sensor table and ingest pipeline are sized alike in
+    // either build, and the aggregators of other channels come with their
+    // first readings.
+    auto footprint = sizeof(*this) + sizeof(Aggregator_t);
+    if constexpr (!IS_FIXED_SIZE)
+    {
+        footprint += m_TheCustomerSensors.capacity() * sizeof(Node_t);
+    }
+
+    if constexpr (std::is_same_v<typename BufferPolicy::Storage_t, std::vector<char>>)
+    {
+        for (const auto& sensor : m_TheCustomerSensors)
+        {
+            footprint += sensor.m_TcpData.capacity();
+        }
+    }
+    return footprint;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+auto BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::MakeSensorPack(
+    const size_t& numberOfSensors) -> SensorPack_t
+{
+    if constexpr (IS_FIXED_SIZE)
+    {
+        return SensorPack_t{};
+    }
+    else
+    {
+        return SensorPack_t(numberOfSensors);
+    }
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::StartConnect(
+    const size_t& sensorNodeNumber)
 {   
     tcp::resolver resolver1(Common::g_DispatcherIOContext);
     tcp::resolver::query query1(tcp::v4(), 
-                                g_TheCustomerSensors[sensorNodeNumber].m_Host.c_str(), 
-                                g_TheCustomerSensors[sensorNodeNumber].m_Port.c_str());
+                                m_TheCustomerSensors[sensorNodeNumber].m_Host.c_str(), 
+                                m_TheCustomerSensors[sensorNodeNumber].m_Port.c_str());
     tcp::resolver::iterator destination1 = resolver1.resolve(query1);
 
     if (destination1 != asio::ip::tcp::resolver::iterator()) 
@@ -209,22 +410,23 @@ void SessionManager::StartConnect(const uint8_t& sensorNodeNumber)
     else
     {
         std::cout << "[ERROR] Could not resolve IP address query :-> " 
-                  << "\"" << g_TheCustomerSensors[sensorNodeNumber].m_Host.c_str()
-                  << ":"  << g_TheCustomerSensors[sensorNodeNumber].m_Port.c_str() << "\""
+                  << "\"" << m_TheCustomerSensors[sensorNodeNumber].m_Host.c_str()
+                  << ":"  << m_TheCustomerSensors[sensorNodeNumber].m_Port.c_str() << "\""
                   << std::endl;     
     }
 }
 
-void SessionManager::AsyncConnect(const uint8_t& sensorNodeNumber, 
-                                  tcp::resolver::iterator& it)
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::AsyncConnect(
+    const size_t& sensorNodeNumber, tcp::resolver::iterator& it)
 {
     using namespace std::placeholders;
 
     // Stringently manage our object lifetime even through callbacks, 
     // with the appropriate C++ lambda captures on shared_ptr to self.
-    auto self(shared_from_this());
+    auto self(this->shared_from_this());
     
-    if (!g_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.is_open())
+    if (!m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.is_open())
     {
         tcp::endpoint endpoint1;
 
@@ -233,16 +435,19 @@ void SessionManager::AsyncConnect(const uint8_t& sensorNodeNumber,
             endpoint1 = *it;
             std::cout << "[DEBUG] Connecting to TCP endpoint :-> " 
                       << endpoint1 << std::endl;
-                      
-            g_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.async_connect(endpoint1,
-                             std::bind(&SessionManager::HandleConnect,
-                                       this, _1, sensorNodeNumber, it));
+
+            m_TheCustomerSensors[sensorNodeNumber].m_ConnectStartTicks = FlightRecorder::ReadTicks();
+            m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.async_connect(endpoint1,
+                             asio::bind_executor(
+                                 Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::RECONNECT),
+                                 std::bind(&BasicSessionManager::HandleConnect,
+                                           this, _1, sensorNodeNumber, it)));
         }
         else
         {
             std::cout << "[WARN] Giving up on connecting to:\n\t\"" 
-                      << g_TheCustomerSensors[sensorNodeNumber].m_Host << ":" 
-                      << g_TheCustomerSensors[sensorNodeNumber].m_Port 
+                      << m_TheCustomerSensors[sensorNodeNumber].m_Host << ":" 
+                      << m_TheCustomerSensors[sensorNodeNumber].m_Port 
                       << "\"\n\tValue := \"" 
                       << "Exhausted resolved endpoints list!" << "\"\n";
 
@@ -252,13 +457,18 @@ void SessionManager::AsyncConnect(const uint8_t& sensorNodeNumber,
     }   
 }
 
-void SessionManager::HandleConnect(const std::error_code& error, 
-                                   const uint8_t& sensorNodeNumber,
-                                   tcp::resolver::iterator& endpointIter)
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::HandleConnect(
+    const std::error_code& error, const size_t& sensorNodeNumber,
+    tcp::resolver::iterator& endpointIter)
 {
     // Stringently manage our object lifetime even through callbacks, 
     // with the appropriate C++ lambda captures on shared_ptr to self.
-    auto self(shared_from_this());
+    auto self(this->shared_from_this());
+
+    FlightRecorder::Record(FlightRecorder::Event_t::CONNECT,
+                           m_TheCustomerSensors[sensorNodeNumber].m_ConnectStartTicks,
+                           sensorNodeNumber);
     
     if (!error)
     {
@@ -266,7 +476,7 @@ void SessionManager::HandleConnect(const std::error_code& error,
         // at the start of the asynchronous operation. If for some reason
         // the socket was closed in the interim, then retry the next 
         // available endpoint for the same sensor. 
-        if (!g_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.is_open())
+        if (!m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.is_open())
         {
             std::cout << "[ERROR] Failure in connecting to TCP socket:\n\t" 
                       << endpointIter->endpoint() 
@@ -282,8 +492,8 @@ void SessionManager::HandleConnect(const std::error_code& error,
             std::cout << "[TRACE] Successfully connected to \"" 
                       << endpointIter->endpoint() << "\"\n";
                       
-            ++m_NumberOfConnectedSockets;
-            if (NUMBER_OF_SENSOR_NODES == m_NumberOfConnectedSockets)
+            // Dispatcher threads may connect several sockets concurrently.
+            if (NumberOfSensors() == ++m_NumberOfConnectedSockets)
             {
                 std::cout << "[TRACE] ALL temperature sensor nodes have been successfully connected to." 
                           << std::endl;
@@ -292,9 +502,15 @@ void SessionManager::HandleConnect(const std::error_code& error,
             // Proceed to reading temperature readings and exercising the
             // business logic to display to the user per the customer 
             // requirements:
-            
+            if constexpr (INGEST_SWEEP_READABLE_SOCKETS)
+            {
+                // Sweeps read whichever sockets are readable without ever
+                // blocking the dispatcher thread.
+                m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.non_blocking(true);
+            }
+
             // Attempt to asynchronously read this sensor.
-            ReceiveTemperatureData(sensorNodeNumber);
+            ReadNext(sensorNodeNumber);
         }
     }
     else
@@ -312,65 +528,75 @@ void SessionManager::HandleConnect(const std::error_code& error,
                   
         // We need to close the socket used in the previous connection
         // attempt before re-attempting to start a new one.
-        g_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.close();
+        m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.close();
 
         // Try the next available endpoint for the same sensor.
         AsyncConnect(sensorNodeNumber, ++endpointIter);
     }
 }
 
-void SessionManager::ReceiveTemperatureData(const uint8_t& sensorNodeNumber)
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ReceiveTemperatureData(
+    const size_t& sensorNodeNumber)
 {
     // Stringently manage our object lifetime even through callbacks, 
     // with the appropriate C++ lambda captures on shared_ptr to self.
-    auto self(shared_from_this());
+    auto self(this->shared_from_this());
     
     // Note that though asio::ip::tcp::socket is NOT thread safe,
     // we are guaranteed safe operation as we are receiving asynchronously
     // and sequentially per sensor node socket.
     
     // Use an ad-hoc lambda completion handler for asynchronous operation.
-    // & (implicitly capture the used automatic variables by reference).
-    g_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.async_receive(
-         asio::buffer(g_TheCustomerSensors[sensorNodeNumber].m_TcpData),
-    [&](const std::error_code& error, std::size_t length)
+    // Capture the sensor node number by value; the referenced argument
+    // does not outlive this call, whereas the completion handler does.
+    // Readings are bulk work; display, control, reconnect and query
+    // handlers all jump ahead of them.
+    m_TheCustomerSensors[sensorNodeNumber].m_ConnectionSocket.async_receive(
+         ReceiveBuffer(sensorNodeNumber),
+    asio::bind_executor(Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::BULK),
+    [this, self, sensorNodeNumber](const std::error_code& error, std::size_t length)
     {
+        FlightRecorder::Span_t span(FlightRecorder::Event_t::RECEIVE);
+        PerfScope_t perfScope(PerfStage_t::RECEIVE, 0);
+
         if (!error)
         {
             // Debug prints...
-            //std::cout.write(g_TheCustomerSensors[sensorNodeNumber].m_TcpData.data(), length);
+            //std::cout.write(m_TheCustomerSensors[sensorNodeNumber].m_TcpData.data(), length);
             //std::cout << "\n\n";
             
-            // This is the sensor temperature reading that we received.
-            g_TheCustomerSensors[sensorNodeNumber].m_CurrentTemperatureReading
-              = std::string(g_TheCustomerSensors[sensorNodeNumber].m_TcpData.data(),
-                            length);
-            
-            // Note the time at which we received that sensor reading.
-            g_TheCustomerSensors[sensorNodeNumber].m_CurrentReadingTime = SystemClock_t::now();
-
-            // Escape the asynchronous context, and schedule/enter the
-            // readout display method on the worker thread context so that
-            // we can safely lock the display mutex before attempting to
-            // display. Without this precaution, we might deadlock.
-            asio::post(Common::g_DispatcherIOContext, 
-                       std::bind(&SessionManager::DisplayTemperatureData,
-                       this));
+            // This is the latest sensor temperature reading that we
+            // received, any earlier ones still buffered being superseded.
+            auto reading = DrainToLatest(sensorNodeNumber, length);
+            std::array<double, NUMBER_OF_SENSOR_CHANNELS> values{};
+
+            if (auto channels = ProcessReading(sensorNodeNumber, reading, values))
+            {
+                // Note the time at which we received that sensor reading,
+                // and hand it off to the aggregation stage, one record per
+                // channel. We are thus free to re-arm the socket read
+                // without further ado.
+                std::array<ReadingRecord_t, NUMBER_OF_SENSOR_CHANNELS> records;
+                auto timeNow = Utility::CoarseClock::Refresh();
+                size_t count = 0;
+                for (size_t channel = 0; channel < NUMBER_OF_SENSOR_CHANNELS; channel++)
+                {
+                    if (channels & (1U << channel))
+                    {
+                        records[count++] = {static_cast<uint32_t>(sensorNodeNumber),
+                                            static_cast<SensorChannel_t>(channel), timeNow, values[channel]};
+                    }
+                }
+
+                span.SetArgument(1);
+                perfScope.SetReadings(1);
+                m_TheIngestPipeline.PushBatch(records.data(), count);
+            }
         }
         else
         {
-            std::ostringstream oss;
-
-            oss << "Code: " << error.value() << '\n';
-            oss << "\t\tCategory: " << error.category().name() << '\n';
-            oss << "\t\tMessage: " << error.message() << '\n';
-
-            std::cout << "[ERROR] Failure in reading from TCP socket connection:\n\t" 
-                      << g_TheCustomerSensors[sensorNodeNumber].m_Host 
-                      << ":" 
-                      << g_TheCustomerSensors[sensorNodeNumber].m_Port 
-                      << "\n\tValue := \"" 
-                      << oss.str() << "\"\n";
+            ReportReadFailure(sensorNodeNumber, error);
         }
         
         // Customer Requirement:
@@ -389,16 +615,407 @@ void SessionManager::ReceiveTemperatureData(const uint8_t& sensorNodeNumber)
         // Here then goes: 
         
         // ... Do not forget to set up asynchronous read handler again.
+        RearmReceive(sensorNodeNumber);
+    }));
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::AwaitReadable(
+    const size_t& sensorNodeNumber)
+{
+    auto self(this->shared_from_this());
+
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+
+    // A zero-byte readiness wait; the sweep does the actual reading.
+    sensor.m_ConnectionSocket.async_wait(tcp::socket::wait_read,
+    asio::bind_executor(Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::BULK),
+    [this, self, sensorNodeNumber](const std::error_code& error)
+    {
+        SweepReadableSensors(sensorNodeNumber, error);
+    }));
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::SweepReadableSensors(
+    const size_t& sensorNodeNumber, const std::error_code& error)
+{
+    if (error == asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    if (error)
+    {
+        ReportReadFailure(sensorNodeNumber, error);
+
+        // Throttle the retries, just as with the per-socket receives.
+        RearmReceive(sensorNodeNumber);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_ReadyMutex);
+        m_ReadySensors.push_back(static_cast<uint32_t>(sensorNodeNumber));
+    }
+
+    // Sweep whatever is ready, ours or not, a batch at a time. Should
+    // another dispatcher thread have already taken ours, there is nothing
+    // left to do; sweeps on several threads proceed in parallel.
+    static thread_local std::vector<uint32_t> ts_Sensors;
+    while (TakeReadySensors(ts_Sensors))
+    {
+        SweepSensors(ts_Sensors);
+    }
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+bool BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::TakeReadySensors(
+    std::vector<uint32_t>& sensors)
+{
+    std::unique_lock<std::mutex> lock(m_ReadyMutex);
+
+    auto count = std::min(m_ReadySensors.size(), SENSORS_PER_SWEEP);
+    sensors.assign(m_ReadySensors.begin(), m_ReadySensors.begin() + count);
+    m_ReadySensors.erase(m_ReadySensors.begin(), m_ReadySensors.begin() + count);
+    return count > 0;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::SweepSensors(
+    const std::vector<uint32_t>& sensors)
+{
+    FlightRecorder::Span_t span(FlightRecorder::Event_t::RECEIVE);
+    PerfScope_t perfScope(PerfStage_t::RECEIVE, 0);
+
+    // The outcome of each sensor's read, acted upon once the batch has
+    // been pushed; were a sensor re-armed before, its next readings might
+    // overtake these.
+    struct Outcome_t
+    {
+        std::chrono::steady_clock::duration  m_Pause;
+        std::error_code                      m_Error;
+    };
+
+    static thread_local SweepBatch_t ts_Batch;
+    static thread_local std::vector<Outcome_t> ts_Outcomes;
+    auto& batch = ts_Batch;
+    auto& outcomes = ts_Outcomes;
+    outcomes.assign(sensors.size(), Outcome_t{});
+
+    size_t count = 0;
+    size_t readings = 0;
+
+    // One clock read for the whole batch.
+    auto timeNow = Utility::CoarseClock::Refresh();
+
+    for (size_t k = 0; k < sensors.size(); k++)
+    {
+        auto i = sensors[k];
+        auto& sensor = m_TheCustomerSensors[i];
+        auto& outcome = outcomes[k];
+
+        if (!AdmitRead(i, timeNow))
+        {
+            outcome.m_Pause = sensor.m_RateLimit.TimeUntilAvailable(timeNow);
+            continue;
+        }
+
+        asio::error_code receiveError;
+        auto length = sensor.m_ConnectionSocket.read_some(ReceiveBuffer(i), receiveError);
+        if (receiveError == asio::error::would_block)
+        {
+            continue;
+        }
+        if (receiveError)
+        {
+            // Throttle the retries, just as with the per-socket receives.
+            outcome.m_Error = receiveError;
+            if (!AdmitRead(i, timeNow))
+            {
+                outcome.m_Pause = sensor.m_RateLimit.TimeUntilAvailable(timeNow);
+            }
+            continue;
+        }
+
+        auto reading = DrainToLatest(i, length);
+        std::array<double, NUMBER_OF_SENSOR_CHANNELS> values{};
+
+        if (auto channels = ProcessReading(i, reading, values))
+        {
+            for (size_t channel = 0; channel < NUMBER_OF_SENSOR_CHANNELS; channel++)
+            {
+                if (channels & (1U << channel))
+                {
+                    batch[count++] = {i, static_cast<SensorChannel_t>(channel), timeNow, values[channel]};
+                }
+            }
+            ++readings;
+        }
+    }
+
+    if (count > 0)
+    {
+        m_TheIngestPipeline.PushBatch(batch.data(), count);
+    }
+    span.SetArgument(static_cast<uint32_t>(readings));
+    perfScope.SetReadings(static_cast<uint32_t>(readings));
+    m_SweepBatchSizes.Record(readings);
+
+    for (size_t k = 0; k < sensors.size(); k++)
+    {
+        if (outcomes[k].m_Error)
+        {
+            ReportReadFailure(sensors[k], outcomes[k].m_Error);
+        }
+        ResumeReadsAfter(sensors[k], outcomes[k].m_Pause);
+    }
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+Utility::ChannelMask_t BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ProcessReading(
+    const size_t& sensorNodeNumber, const std::string_view& reading,
+    std::array<double, NUMBER_OF_SENSOR_CHANNELS>& values)
+{
+    m_TheOverloadController.RecordReceive(sensorNodeNumber);
+
+    if (reading.empty())
+    {
+        // Only part of a line as yet.
+        return 0;
+    }
+
+    // Only the latest of several readings in one chunk is used.
+    auto lines = std::count(reading.begin(), reading.end(), '\n');
+    if (lines > 1)
+    {
+        m_ReadingsCoalesced.fetch_add(static_cast<uint64_t>(lines - 1),
+                                      std::memory_order_relaxed);
+    }
+
+    FlightRecorder::Span_t span(FlightRecorder::Event_t::PARSE, sensorNodeNumber);
+    PerfScope_t perfScope(PerfStage_t::PARSE);
+
+    auto channels = Utility::ParseSensorReading(reading, values);
+    if (channels == 0)
+    {
+        std::cout << "[WARN] Discarding unparsable reading from sensor node :-> "
+                  << static_cast<unsigned>(sensorNodeNumber) << "\n";
+    }
+    return channels;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+asio::mutable_buffer BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ReceiveBuffer(
+    const size_t& sensorNodeNumber)
+{
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+    auto pData = sensor.m_TcpData.data();
+
+    // The partial line carried over from the previous receive is moved to
+    // the front, to be completed by what is received next.
+    if (sensor.m_PartialBegin > 0)
+    {
+        std::memmove(pData, pData + sensor.m_PartialBegin, sensor.m_PartialLength);
+        sensor.m_PartialBegin = 0;
+    }
+
+    return asio::buffer(pData + sensor.m_PartialLength, sensor.m_TcpData.size() - sensor.m_PartialLength);
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+std::string_view BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::DrainToLatest(
+    const size_t& sensorNodeNumber, const std::size_t& length)
+{
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+    auto pData = sensor.m_TcpData.data();
+
+    // What was received follows the partial line carried over; see
+    // ReceiveBuffer().
+    auto size = sensor.m_PartialLength + length;
+
+    // Latest value wins: whatever else the node has already sent is read
+    // (without blocking) and only its last complete line will be used.
+    // Before each such read, the lines superseded are shed from the front
+    // of the buffer, bar the latest complete one, should the read not
+    // complete another.
+    size_t drained = 0;
+    asio::error_code error;
+
+    while ((drained < SENSOR_MAXIMUM_DRAIN_BYTES)
+        && (sensor.m_ConnectionSocket.available(error) > 0) && !error)
+    {
+        std::string_view text(pData, size);
+        auto lastNewline = text.rfind('\n');
+        size_t superseded = 0;
+
+        if ((lastNewline != std::string_view::npos) && (lastNewline > 0))
+        {
+            auto previousNewline = text.rfind('\n', lastNewline - 1);
+            if (previousNewline != std::string_view::npos)
+            {
+                superseded = previousNewline + 1;
+                m_ReadingsCoalesced.fetch_add(
+                    static_cast<uint64_t>(std::count(text.begin(), text.begin() + superseded, '\n')),
+                    std::memory_order_relaxed);
+            }
+        }
+
+        size -= superseded;
+        std::memmove(pData, pData + superseded, size);
+
+        if (size >= sensor.m_TcpData.size() / 2)
+        {
+            // Little room left; the rest awaits the next receive.
+            break;
+        }
+
+        auto received = sensor.m_ConnectionSocket.read_some(
+                            asio::buffer(pData + size, sensor.m_TcpData.size() - size), error);
+        if (error || (received == 0))
+        {
+            // Make do with what we have; the next receive reports any error.
+            break;
+        }
+
+        size += received;
+        drained += received;
+    }
+
+    // Whatever follows the last '\n' is carried over to the next receive.
+    // A "line" that long without a '\n' is gibberish, and is dropped.
+    std::string_view text(pData, size);
+    auto lastNewline = text.rfind('\n');
+    auto complete = (lastNewline != std::string_view::npos) ? (lastNewline + 1) : 0;
+
+    sensor.m_PartialBegin = complete;
+    sensor.m_PartialLength = size - complete;
+    if (sensor.m_PartialLength >= sensor.m_TcpData.size() / 2)
+    {
+        sensor.m_PartialLength = 0;
+    }
+
+    return text.substr(0, complete);
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+bool BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::AdmitRead(
+    const size_t& sensorNodeNumber, const std::chrono::steady_clock::time_point& timeNow)
+{
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+
+    // A node sending faster than its token bucket allows is flagged as
+    // flooding and its next read is deferred until it has earned a token.
+    bool isFlooding = !sensor.m_RateLimit.TryConsume(timeNow);
+    if (isFlooding)
+    {
+        m_ReadsThrottled.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (isFlooding != sensor.m_IsFlooding)
+    {
+        sensor.m_IsFlooding = isFlooding;
+        m_FloodingSensors.fetch_add(isFlooding ? 1 : -1, std::memory_order_relaxed);
+    }
+
+    return !isFlooding;
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::RearmReceive(
+    const size_t& sensorNodeNumber)
+{
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+    auto timeNow = Utility::CoarseClock::Now();
+    std::chrono::steady_clock::duration pause{};
+
+    if (!AdmitRead(sensorNodeNumber, timeNow))
+    {
+        pause = sensor.m_RateLimit.TimeUntilAvailable(timeNow);
+    }
+
+    ResumeReadsAfter(sensorNodeNumber, pause);
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ResumeReadsAfter(
+    const size_t& sensorNodeNumber, std::chrono::steady_clock::duration pause)
+{
+    auto& sensor = m_TheCustomerSensors[sensorNodeNumber];
+
+    // Whilst overloaded, also leave the noisiest sensors' readings in
+    // their socket buffers for a while; TCP flow control pushes back on
+    // them and only their latest reading is used once we resume.
+    if (m_TheOverloadController.ShouldPauseReads(sensorNodeNumber))
+    {
+        pause = std::max<std::chrono::steady_clock::duration>(pause,
+                    std::chrono::milliseconds(OVERLOAD_READ_PAUSE_MILLISECONDS));
+    }
+
+    if (pause == std::chrono::steady_clock::duration::zero())
+    {
+        ReadNext(sensorNodeNumber);
+        return;
+    }
+
+    auto self(this->shared_from_this());
+
+    auto& timer = sensor.m_ResumeTimer;
+    timer.expires_after(pause);
+    timer.async_wait(
+    asio::bind_executor(Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::BULK),
+    [this, self, sensorNodeNumber](const std::error_code& error)
+    {
+        if (error != asio::error::operation_aborted)
+        {
+            ReadNext(sensorNodeNumber);
+        }
+    }));
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ReadNext(
+    const size_t& sensorNodeNumber)
+{
+    if constexpr (INGEST_SWEEP_READABLE_SOCKETS)
+    {
+        AwaitReadable(sensorNodeNumber);
+    }
+    else
+    {
         ReceiveTemperatureData(sensorNodeNumber);
-    });
+    }
 }
 
-void SessionManager::DisplayTemperatureData()
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::ScheduleDisplay()
+{
+    // One queued display suffices; it will show the latest readings.
+    if (m_IsDisplayPending.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    // Escape the aggregation thread context, and schedule/enter the
+    // readout display method on the worker thread context so that
+    // we can safely lock the display mutex before attempting to
+    // display. Without this precaution, we might deadlock. Do so
+    // ahead of any receive completions that may be queued up.
+    asio::post(Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::DISPLAY),
+               std::bind(&BasicSessionManager::DisplayTemperatureData,
+               this));
+}
+
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+void BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>::DisplayTemperatureData()
 {
     // Stringently manage our object lifetime even through callbacks, 
     // with the appropriate C++ lambda captures on shared_ptr to self. 
-    auto self(shared_from_this());
+    auto self(this->shared_from_this());
     
+    // Any readings applied from here on warrant another display.
+    m_IsDisplayPending.store(false, std::memory_order_release);
+
     // Always protect the display abstraction via mutual exclusion.
     std::unique_lock<std::mutex> lock(m_TheDisplayMutex);
 
@@ -406,46 +1023,81 @@ void SessionManager::DisplayTemperatureData()
     //
     // "1. The readout shall be as close to real time as possible but 
     // shall not change faster than once per second."
-    auto timeNow = SystemClock_t::now();
+    //
+    // Whilst overloaded, the display refreshes less often still.
+    //
+    // One clock read per display tick, on the monotonic clock, so that an
+    // NTP step can neither hold the display back nor make readings stale.
+    auto timeNow = Utility::CoarseClock::Refresh();
+    auto displayInterval = m_TheOverloadController.IsOverloaded()
+                         ? OVERLOAD_DISPLAY_INTERVAL_SECONDS
+                         : MINIMUM_DISPLAY_INTERVAL_SECONDS;
 
     if ((timeNow - m_LastReadoutTime) 
-         >= Seconds_t(MINIMUM_DISPLAY_INTERVAL_SECONDS))
+         >= Seconds_t(displayInterval))
     {
-        // Customer Requirement:
-        //
-        // "2. The displayed temperature shall be the average temperature
-        // computed from the latest readings from each node."
-        double averageTemperature = 0.0;
-        auto count = 0;
-        
-        for (size_t i = 0; i < g_TheCustomerSensors.size(); i++) 
+        FlightRecorder::Span_t span(FlightRecorder::Event_t::PUBLISH);
+
+        // Maintained reading by reading by the ingest pipeline; only the
+        // readings going stale are visited here. See AggregationPolicies.h.
+        // Temperature always; any other channel once it is in use.
+        std::array<std::optional<Aggregate_t>, NUMBER_OF_SENSOR_CHANNELS> aggregates;
         {
-            // Customer Requirement:
-            //
-            // "3. In case of intermittent communications, temperature readings older
-            // than 10 minutes shall be considered stale and excluded from the 
-            // displayed temperature."
-            if ((timeNow - g_TheCustomerSensors[i].m_CurrentReadingTime) 
-                < std::chrono::minutes(STALE_READING_DURATION_MINUTES))
+            std::unique_lock<std::mutex> lock(m_AggregationMutex);
+            for (size_t channel = 0; channel < NUMBER_OF_SENSOR_CHANNELS; channel++)
             {
-                if (!g_TheCustomerSensors[i].m_CurrentTemperatureReading.empty())
+                if (auto& pAggregator = m_TheAggregators[channel])
                 {
-                    averageTemperature = averageTemperature + 
-                      std::stod(g_TheCustomerSensors[i].m_CurrentTemperatureReading);
-                    ++count;
+                    pAggregator->Expire(timeNow);
+                    aggregates[channel] = pAggregator->Result();
                 }
             }
         }
+        m_TheVirtualSensors.Expire(timeNow);
+        m_TheAnomalyDetector.Collect();
+
+        std::cout << "\t\t";
+        for (size_t channel = 0; channel < NUMBER_OF_SENSOR_CHANNELS; channel++)
+        {
+            if (!aggregates[channel])
+            {
+                continue;
+            }
+
+            const auto& aggregate = *aggregates[channel];
+            auto unit = Utility::ChannelUnit(static_cast<SensorChannel_t>(channel));
+            if (channel > 0)
+            {
+                std::cout << "  ";
+            }
+
+            if ((aggregate.m_Count > 0) && aggregate.m_IsEnvelope)
+            {
+                std::cout << std::fixed << std::setprecision(1)
+                          << aggregate.m_Minimum << " .. " << aggregate.m_Maximum << " " << unit;
+            }
+            else if (aggregate.m_Count > 0)
+            {
+                std::cout << std::fixed << std::setprecision(1)
+                          << aggregate.m_Value << " " << unit;
+            }
+            else
+            {
+                // Customer Requirement:
+                //
+                // "4. If no temperature readings are available, ... , the readout 
+                // shall display “--.- °C”."
+                std::cout << "--.- " << unit;
+            }
+
+            m_TheChannelHistory.Record(static_cast<SensorChannel_t>(channel), timeNow, aggregate);
+        }
+        std::cout << "\n";
         
-        // Customer Requirement:
-        //
-        // "2. The displayed temperature shall be the average temperature
-        // computed from the latest readings from each node."
-        averageTemperature = averageTemperature / count ;
-        
-        std::cout << "\t\t" << std::fixed << std::setprecision(1)
-                  << averageTemperature << " °C" << "\n";
-        
-        m_LastReadoutTime = SystemClock_t::now();
+        const auto& aggregate = *aggregates[static_cast<size_t>(SensorChannel_t::TEMPERATURE)];
+        span.SetArgument(static_cast<uint32_t>(aggregate.m_Count));
+        m_LastReadoutTime = timeNow;
     }
 }
+
+template class BasicSessionManager<SESSION_SENSOR_COUNT, SessionAggregation_t, SessionBuffer_t>;
@@ -28,13 +28,31 @@
 
 #include <mutex>
 #include <array>
+#include <deque>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
 #include <thread>
 #include <optional>
 #include "CommonDefinitions.h"
+#include "SensorTable.h"
+#include "IngestPipeline.h"
+#include "OverloadController.h"
+#include "ElasticDispatcher.h"
+#include "PriorityExecutor.h"
+#include "WorkStealingExecutor.h"
+#include "HandlerWatchdog.h"
+#include "SessionPolicies.h"
+#include "TokenBucket.h"
+#include "VirtualSensors.h"
+#include "Calibration.h"
+#include "AnomalyDetector.h"
+#include "AlertRules.h"
+#include "SiteHeatmap.h"
+#include "ChannelHistory.h"
 
 namespace Common
 {
-    using ThreadPack_t        = std::array<std::thread, DISPATCHER_THREAD_POOL_SIZE>;
     //using ExecutorWorkGuard_t = asio::executor_work_guard<asio::io_context::executor_type>;
     
     // any_io_executor is a type-erasing executor wrapper. 
@@ -55,82 +73,212 @@ namespace Common
 
     extern asio::io_context                     g_DispatcherIOContext;
     extern std::optional<ExecutorWorkGuard_t>   g_DispatcherWork;
-    extern ThreadPack_t                         g_DispatcherWorkerThreads;
+    extern std::optional<ElasticDispatcher>     g_DispatcherWorkerThreads;
+
+    // Schedules handlers on g_DispatcherIOContext by HandlerPriority_t
+    // rather than in FIFO order; see PriorityExecutor.h.
+    extern std::optional<PriorityScheduler>     g_DispatcherPriorities;
+    
+    // Follow-on analytics, compression and export work; see
+    // WorkStealingExecutor.h.
+    extern std::optional<WorkStealingPool>      g_AnalyticsWorkPool;
+
+    // Reports dispatcher handlers which block beyond their budget; see
+    // HandlerWatchdog.h.
+    extern std::optional<HandlerWatchdog>       g_DispatcherWatchdog;
 
     void SetupIOContext();
     void RunWorkerThreads();
     void JoinWorkerThreads();
     void DestroyWorkerThreads();
+}
 
-    // By default 'auto' has external linkage therefore restrict it
-    // with 'const' to ensure that multiple symbol definition error is 
-    // not encountered during linking. 
-    const auto DispatcherWorkerThread = []()
+// Customer Requirement:
+//
+// "Each node has a static IP, listens on a port, accepts a connection,
+// and then sends the latest temperature reading, in deg C, on one line
+// of ascii text."
+//
+// Newer nodes send humidity and pressure on the same line; see
+// Utility::ParseSensorReading().
+template <typename BufferPolicy>
+struct SensorNode_t
+{
+    SensorNode_t()
+        : m_Host(SENSOR_NODE_STATIC_IP) // Same test laptop, same LAN, same IP=localhost.
+        , m_Port()
+        , m_ConnectionSocket(Common::g_DispatcherIOContext)
+        , m_TcpData(BufferPolicy::Make())
+        , m_PartialBegin(0)
+        , m_PartialLength(0)
+        , m_ResumeTimer(Common::g_DispatcherIOContext)
+        , m_RateLimit(static_cast<double>(SENSOR_READS_PER_DISPLAY_INTERVAL) / MINIMUM_DISPLAY_INTERVAL_SECONDS,
+                      SENSOR_READS_PER_DISPLAY_INTERVAL)
+        , m_IsFlooding(false)
+        , m_ConnectStartTicks(0)
     {
-        // To aid debugging by means of strace, ps, valgrind, gdb, and
-        // variants, name our created threads. 
-        std::string namePrefix("WorkerThread_");
-        std::string nameSuffix(3, '*');
-        Utility::RandLibStringGenerator generator;
-        std::generate(nameSuffix.begin(), nameSuffix.end(), generator);
-        std::string uniqueName = namePrefix + nameSuffix;
-
-        char myThreadName[Utility::RECOMMENDED_BUFFER_SIZE];
-        Utility::SetThreadName(uniqueName.c_str());
-        Utility::GetThreadName(myThreadName, sizeof(myThreadName));
-        std::cout << "[INFO] : Parent just created a thread. \
-               ThreadName = " << myThreadName << "\n";
-
-        // TBD Nuertey Odzeyem; were I truly compiling on an Embedded
-        // system, I would have optimized these C++ exceptions completely
-        // out of the source code.
-        try
-        {
-            // Though blocked here, note that it does NOT imply that we 
-            // are still being scheduled by the processor or perpetually
-            // polling the processor. In fact we would have been taken 
-            // out of the kernel scheduling queues completely and rather
-            // placed into the kernel waiting queues. Hence the processor
-            // is 100% free of us to devote its time to other tasks. 
-            // Polling is grossly inefficient and ought to be obsoleted.
-
-            // Only when some event or trigger asynchronously arrives and
-            // is subsequently transformed into the synchronous post() 
-            // within this worker thread's context, will we be scheduled
-            // to run by the processor/kernel scheduler to actually 
-            // process that event however we wish.
-            g_DispatcherIOContext.run();
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "[ERROR] : Caught an exception! " << e.what() << "\n";
-        }
-
-        std::cout << "[WARN] : Exiting Dispatcher Worker Thread "
-                  << myThreadName << "\n";
-    };
-}
+    }
+        
+    virtual ~SensorNode_t()
+    {
+    }
+    
+    std::string                          m_Host; // TCP host.
+    std::string                          m_Port; // TCP port number.
+    tcp::socket                          m_ConnectionSocket;
+    typename BufferPolicy::Storage_t     m_TcpData;
+    std::size_t                          m_PartialBegin;  // Of a line yet to be completed,
+    std::size_t                          m_PartialLength; // within m_TcpData.
+    asio::steady_timer                   m_ResumeTimer; // Paused reads resume on expiry.
+    Utility::TokenBucket                 m_RateLimit;
+    bool                                 m_IsFlooding;
+    uint64_t                             m_ConnectStartTicks; // Flight recorder.
+};
 
-class SessionManager : public std::enable_shared_from_this<SessionManager>
+// Specialised at compile time on the number of sensor nodes, how their
+// readings are aggregated for display and how their receive buffers are
+// stored; see SessionPolicies.h. Fixed, known (embedded) deployments get
+// their sensor nodes and latest readings in std::arrays; large sites size
+// them at runtime.
+template <std::size_t SENSOR_COUNT, IncrementalAggregation AggregationPolicy, typename BufferPolicy>
+class BasicSessionManager
+    : public std::enable_shared_from_this<BasicSessionManager<SENSOR_COUNT, AggregationPolicy, BufferPolicy>>
 {
     static constexpr short EPHEMERAL_PORT_NUMBER_BASE_VALUE = 5000;
+
+    static constexpr bool IS_FIXED_SIZE = (SENSOR_COUNT != DYNAMIC_SENSOR_COUNT);
+
+    using Node_t = SensorNode_t<BufferPolicy>;
+    using SensorPack_t = std::conditional_t<IS_FIXED_SIZE,
+                                            std::array<Node_t, SENSOR_COUNT>,
+                                            std::vector<Node_t>>;
+
+    // A sweep reads at most this many readable sensors, such that its
+    // batch never exceeds INGEST_BATCH_SIZE records, thus fits the ring.
+    static constexpr size_t SENSORS_PER_SWEEP = std::max<size_t>(INGEST_BATCH_SIZE / NUMBER_OF_SENSOR_CHANNELS, 1);
+    using SweepBatch_t = std::array<ReadingRecord_t, SENSORS_PER_SWEEP * NUMBER_OF_SENSOR_CHANNELS>;
+
+    // Allocated upon the channel's first reading, bar temperature's.
+    using Aggregator_t = IncrementalAggregator<AggregationPolicy, SENSOR_COUNT>;
+    using Aggregators_t = std::array<std::unique_ptr<Aggregator_t>, NUMBER_OF_SENSOR_CHANNELS>;
     
 public:
-    SessionManager();
-    virtual ~SessionManager();
+    // Fixed-size session managers ignore numberOfSensors, bar a warning
+    // should it disagree with SENSOR_COUNT.
+    explicit BasicSessionManager(const size_t& numberOfSensors = IS_FIXED_SIZE ? SENSOR_COUNT : NUMBER_OF_SENSOR_NODES);
+
+    // Sensor i at endpoints[i], e.g. as discovered (see SensorDiscovery.h),
+    // rather than at port EPHEMERAL_PORT_NUMBER_BASE_VALUE + i of
+    // SENSOR_NODE_STATIC_IP.
+    explicit BasicSessionManager(const std::vector<tcp::endpoint>& endpoints);
+    virtual ~BasicSessionManager();
 
     void Start();
+    void Stop();
+
+    // Readers outside of the ingest path (e.g. the query API) observe
+    // the sensor table only through its lock-free snapshots.
+    const SensorTable& GetSensorTable() const;
+    const VirtualSensorGraph& GetVirtualSensors() const;
+    AnomalyDetector& GetAnomalyDetector();
+    const AlertRuleEngine& GetAlertRules() const;
+    const SiteHeatmap& GetSiteHeatmap() const;
+    const ChannelHistory& GetChannelHistory() const;
+
+    // Re-reads CALIBRATION_PATH without pausing ingest; see Calibration.h.
+    bool ReloadCalibration();
+
+    size_t NumberOfSensors() const;
+
+    // RAM held by the session manager and its sensor nodes, bar that of
+    // the sensor table, ingest rings and sockets' kernel buffers.
+    size_t FootprintBytes() const;
 
 protected:
-    void StartConnect(const uint8_t& sensorNodeNumber);
-    void AsyncConnect(const uint8_t& sensorNodeNumber, tcp::resolver::iterator& it);
-    void HandleConnect(const std::error_code& error, const uint8_t& sensorNodeNumber,
+    static SensorPack_t MakeSensorPack(const size_t& numberOfSensors);
+
+    void StartConnect(const size_t& sensorNodeNumber);
+    void AsyncConnect(const size_t& sensorNodeNumber, tcp::resolver::iterator& it);
+    void HandleConnect(const std::error_code& error, const size_t& sensorNodeNumber,
                        tcp::resolver::iterator& endpointIter);
-    void ReceiveTemperatureData(const uint8_t& sensorNodeNumber);
+    void ReceiveTemperatureData(const size_t& sensorNodeNumber);
+    void AwaitReadable(const size_t& sensorNodeNumber);
+    void SweepReadableSensors(const size_t& sensorNodeNumber, const std::error_code& error);
+    bool TakeReadySensors(std::vector<uint32_t>& sensors);
+    void SweepSensors(const std::vector<uint32_t>& sensors);
+    asio::mutable_buffer ReceiveBuffer(const size_t& sensorNodeNumber);
+    std::string_view DrainToLatest(const size_t& sensorNodeNumber, const std::size_t& length);
+    Utility::ChannelMask_t ProcessReading(const size_t& sensorNodeNumber, const std::string_view& reading,
+                                          std::array<double, NUMBER_OF_SENSOR_CHANNELS>& values);
+    bool AdmitRead(const size_t& sensorNodeNumber,
+                   const std::chrono::steady_clock::time_point& timeNow);
+    void RearmReceive(const size_t& sensorNodeNumber);
+    void ResumeReadsAfter(const size_t& sensorNodeNumber,
+                          std::chrono::steady_clock::duration pause);
+    void ReadNext(const size_t& sensorNodeNumber);
+    void ReportReadFailure(const size_t& sensorNodeNumber, const std::error_code& error) const;
+    void ScheduleDisplay();
     void DisplayTemperatureData();
 
 private:
-    uint8_t                     m_NumberOfConnectedSockets;
+    SensorPack_t                m_TheCustomerSensors;
+    std::atomic<size_t>         m_NumberOfConnectedSockets;
     std::mutex                  m_TheDisplayMutex;
-    SystemClock_t::time_point   m_LastReadoutTime;
+    SteadyClock_t::time_point   m_LastReadoutTime;
+    SensorTable                 m_TheSensorTable;
+
+    // Fed by the ingest pipeline, read by the display; one per channel
+    // in use.
+    std::mutex                  m_AggregationMutex;
+    Aggregators_t               m_TheAggregators;
+    ChannelHistory              m_TheChannelHistory;
+
+    // Also fed by the ingest pipeline; see VirtualSensors.h.
+    VirtualSensorGraph          m_TheVirtualSensors;
+    AnomalyDetector             m_TheAnomalyDetector;
+
+    // Flagged by the ingest pipeline, evaluated (or, the heatmap,
+    // updated) on the analytics pool.
+    AlertRuleEngine             m_TheAlertRules;
+    SiteHeatmap                 m_TheSiteHeatmap;
+
+    // Applied by the ingest pipeline to every reading before the above.
+    Calibration                 m_TheCalibration;
+
+    IngestPipeline              m_TheIngestPipeline;
+    OverloadController          m_TheOverloadController;
+
+    // Sensors whose sockets have signalled readability, oldest first. A
+    // sensor is listed once at most, its readiness wait being re-armed
+    // only once swept; whichever sweep takes it from here has it to
+    // itself, its socket, buffer and token bucket included.
+    std::mutex                  m_ReadyMutex;
+    std::deque<uint32_t>        m_ReadySensors;
+    Metrics::Histogram_t&       m_SweepBatchSizes;
+
+    // At most one display post is ever queued up.
+    std::atomic<bool>           m_IsDisplayPending;
+
+    // Readings received in the same chunk as a later reading from the
+    // same sensor are superseded, hence shed.
+    Metrics::Counter_t&         m_ReadingsCoalesced;
+    Metrics::Counter_t&         m_ReadsThrottled;
+    Metrics::Gauge_t&           m_FloodingSensors;
 };
+
+// The deployment is chosen at build time (see meson.build), and only
+// its session manager is instantiated, in SessionManager.cpp. Any other
+// IncrementalAggregation policy may be substituted for the mean, e.g.
+// WeightedMeanAggregation_t<>, TrimmedMeanAggregation_t<10> or
+// EnvelopeAggregation_t; see AggregationPolicies.h.
+#if defined(EMBEDDED_DEPLOYMENT)
+static constexpr std::size_t SESSION_SENSOR_COUNT = NUMBER_OF_SENSOR_NODES;
+using SessionAggregation_t = MeanAggregation_t;
+using SessionBuffer_t      = InlineReceiveBuffer_t<EMBEDDED_RECEIVE_BUFFER_LENGTH>;
+#else
+static constexpr std::size_t SESSION_SENSOR_COUNT = DYNAMIC_SENSOR_COUNT;
+using SessionAggregation_t = MeanAggregation_t;
+using SessionBuffer_t      = HeapReceiveBuffer_t;
+#endif
+
+using SessionManager = BasicSessionManager<SESSION_SENSOR_COUNT, SessionAggregation_t, SessionBuffer_t>;
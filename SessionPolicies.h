@@ -0,0 +1,57 @@
+/***********************************************************************
+* @file      SessionPolicies.h
+*
+* Compile-time policies from which BasicSessionManager (SessionManager.h)
+* is specialised: the number of sensors, how their receive buffers are
+* stored, and how their readings are aggregated for display.
+*
+* @brief    Sensor count - a fixed SENSOR_COUNT (fixed, known embedded
+*                          deployments) keeps sensor nodes, and the latest
+*                          reading of each, in std::arrays;
+*                          DYNAMIC_SENSOR_COUNT (large sites) sizes them
+*                          at runtime instead.
+*
+*           Buffers      - InlineReceiveBuffer_t<LENGTH> embeds a std::array
+*                          in each sensor node; HeapReceiveBuffer_t
+*                          allocates MAXIMUM_TCP_DATA_LENGTH per node.
+*
+*           Aggregation  - any IncrementalAggregation policy; see
+*                          AggregationPolicies.h. With a fixed SENSOR_COUNT,
+*                          MeanAggregation_t is swept, unrolled at compile
+*                          time, upon display instead.
+*
+* @note
+*
+* @warning  A fixed SENSOR_COUNT must not exceed the sensor table's size.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "AggregationPolicies.h"
+
+template <std::size_t LENGTH>
+struct InlineReceiveBuffer_t
+{
+    using Storage_t = std::array<char, LENGTH>;
+
+    static Storage_t Make()
+    {
+        return Storage_t{};
+    }
+};
+
+struct HeapReceiveBuffer_t
+{
+    using Storage_t = std::vector<char>;
+
+    static Storage_t Make()
+    {
+        return Storage_t(MAXIMUM_TCP_DATA_LENGTH);
+    }
+};
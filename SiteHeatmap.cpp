@@ -0,0 +1,601 @@
+#include "SiteHeatmap.h"
+#include "CoarseClock.h"
+
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace
+{
+    // The kernels of an update: one pass per neighbour rank over a run of
+    // cells, then one dividing the sums. Each is branchless and over
+    // contiguous arrays, bar the gathers of sensors' values, such that the
+    // compiler vectorises it; hence free functions, as GCC heeds
+    // __restrict only upon parameters.
+    template <typename Slot_t>
+    void AccumulateNeighbours(const Slot_t* __restrict pNeighbours, const float* __restrict pWeights,
+                              const float* __restrict pWeighted, const float* __restrict pFresh,
+                              float* __restrict pSums, float* __restrict pTotals, const uint32_t& count)
+    {
+        for (uint32_t cell = 0; cell < count; cell++)
+        {
+            pSums[cell] += pWeights[cell] * pWeighted[pNeighbours[cell]];
+            pTotals[cell] += pWeights[cell] * pFresh[pNeighbours[cell]];
+        }
+    }
+
+    // Without a fresh neighbour, both sums are 0, and 0/0 is NaN.
+    void DivideSums(const float* __restrict pSums, const float* __restrict pTotals,
+                    float* __restrict pGrid, const uint32_t& count)
+    {
+        for (uint32_t cell = 0; cell < count; cell++)
+        {
+            pGrid[cell] = pSums[cell] / pTotals[cell];
+        }
+    }
+
+    // The nearest sensors found so far to one cell, nearest first.
+    struct Nearest_t
+    {
+        std::array<double, HEATMAP_NEIGHBOURS>   m_Distances2;
+        std::array<uint32_t, HEATMAP_NEIGHBOURS> m_Slots;
+        uint32_t                                 m_Count{0};
+
+        void Offer(const double& distance2, const uint32_t& slot)
+        {
+            if ((m_Count == HEATMAP_NEIGHBOURS) && (distance2 >= m_Distances2[m_Count - 1]))
+            {
+                return;
+            }
+
+            auto i = (m_Count < HEATMAP_NEIGHBOURS) ? m_Count++ : (m_Count - 1);
+            for (; (i > 0) && (m_Distances2[i - 1] > distance2); i--)
+            {
+                m_Distances2[i] = m_Distances2[i - 1];
+                m_Slots[i] = m_Slots[i - 1];
+            }
+            m_Distances2[i] = distance2;
+            m_Slots[i] = slot;
+        }
+    };
+}
+
+std::vector<SensorPosition_t> SiteHeatmap::LoadLayout(const std::string_view& path,
+                                                      const size_t& numberOfSensors)
+{
+    std::vector<SensorPosition_t> layout;
+
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        return layout;
+    }
+
+    std::vector<bool> isListed(numberOfSensors, false);
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        auto text = line.substr(0, line.find('#'));
+        if (text.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        std::istringstream iss(text);
+        SensorPosition_t position{};
+        std::string trailing;
+        if (!(iss >> position.m_SensorNodeNumber >> position.m_X >> position.m_Y) || (iss >> trailing)
+            || !std::isfinite(position.m_X) || !std::isfinite(position.m_Y))
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber
+                      << ": Expected \"<sensor> <x> <y>\"; skipped.\n";
+            continue;
+        }
+
+        if ((position.m_SensorNodeNumber >= numberOfSensors) || isListed[position.m_SensorNodeNumber])
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber << ": Unknown or repeated sensor "
+                      << position.m_SensorNodeNumber << "; skipped.\n";
+            continue;
+        }
+
+        isListed[position.m_SensorNodeNumber] = true;
+        layout.push_back(position);
+    }
+
+    std::cout << "[INFO] Loaded the positions of " << layout.size() << " sensors from " << path << "\n";
+    return layout;
+}
+
+SiteHeatmap::SiteHeatmap(asio::io_context& ioContext,
+                         const WorkStealingPool::executor_type& executor,
+                         const SensorTable& sensorTable, const size_t& numberOfSensors,
+                         const std::vector<SensorPosition_t>& layout,
+                         const uint32_t& width, const uint32_t& height)
+    : m_TheSensorTable(sensorTable)
+    , m_UpdateTimer(ioContext)
+    , m_Executor(executor)
+    , m_Width(width)
+    , m_Height(height)
+    , m_MinimumX(0.0)
+    , m_MinimumY(0.0)
+    , m_CellWidth(0.0)
+    , m_CellHeight(0.0)
+    , m_SlotOf()
+    , m_SensorOf()
+    , m_Weighted()
+    , m_Fresh()
+    , m_ExpiryTime()
+    , m_Spans()
+    , m_pIsSlotDirty()
+    , m_Neighbours()
+    , m_Weights()
+    , m_DirtyRows()
+    , m_Sums()
+    , m_Totals()
+    , m_GridMutex()
+    , m_Grid()
+    , m_Updates(Metrics::Counter("heatmap.updates"))
+    , m_Cells(Metrics::Counter("heatmap.cells"))
+{
+    static_assert(MAXIMUM_NUMBER_OF_SENSOR_NODES <= (size_t{1} << (8 * sizeof(Slot_t))),
+                  "Every sensor must be addressable by a layout slot.");
+
+    if (layout.empty() || (m_Width == 0) || (m_Height == 0))
+    {
+        return;
+    }
+
+    m_SlotOf.assign(numberOfSensors, -1);
+    for (const auto& position : layout)
+    {
+        m_SlotOf[position.m_SensorNodeNumber] = static_cast<int32_t>(m_SensorOf.size());
+        m_SensorOf.push_back(position.m_SensorNodeNumber);
+    }
+
+    // Nothing is fresh until the first update has read the sensor table.
+    m_Weighted.assign(layout.size(), 0.0f);
+    m_Fresh.assign(layout.size(), 0.0f);
+    m_ExpiryTime.assign(layout.size(), SteadyClock_t::time_point::max());
+    m_pIsSlotDirty = std::make_unique<std::atomic<bool>[]>(layout.size());
+    for (size_t slot = 0; slot < layout.size(); slot++)
+    {
+        m_pIsSlotDirty[slot].store(true, std::memory_order_relaxed);
+    }
+
+    m_DirtyRows.assign(m_Height, RowSpan_t{0, 0, 0});
+    m_Sums.resize(m_Width);
+    m_Totals.resize(m_Width);
+    m_Grid.assign(static_cast<size_t>(m_Width) * m_Height, std::numeric_limits<float>::quiet_NaN());
+
+    auto startTime = SteadyClock_t::now();
+    BuildNeighbours(layout);
+
+    std::cout << "[INFO] Site heatmap of " << m_Width << "x" << m_Height << " cells over "
+              << layout.size() << " sensors, indexed in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock_t::now() - startTime).count()
+              << " ms\n";
+}
+
+SiteHeatmap::~SiteHeatmap()
+{
+}
+
+void SiteHeatmap::BuildNeighbours(const std::vector<SensorPosition_t>& layout)
+{
+    auto minimumX = std::numeric_limits<double>::max();
+    auto minimumY = std::numeric_limits<double>::max();
+    auto maximumX = std::numeric_limits<double>::lowest();
+    auto maximumY = std::numeric_limits<double>::lowest();
+    for (const auto& position : layout)
+    {
+        minimumX = std::min(minimumX, position.m_X);
+        minimumY = std::min(minimumY, position.m_Y);
+        maximumX = std::max(maximumX, position.m_X);
+        maximumY = std::max(maximumY, position.m_Y);
+    }
+
+    // Sensors all in a line (or all at one point) still span some area.
+    if (maximumX - minimumX <= 0.0)
+    {
+        minimumX -= 0.5;
+        maximumX += 0.5;
+    }
+    if (maximumY - minimumY <= 0.0)
+    {
+        minimumY -= 0.5;
+        maximumY += 0.5;
+    }
+
+    m_MinimumX = minimumX;
+    m_MinimumY = minimumY;
+    m_CellWidth = (maximumX - minimumX) / m_Width;
+    m_CellHeight = (maximumY - minimumY) / m_Height;
+
+    // The spatial index: some two sensors per bucket, in a uniform grid
+    // of buckets over the same bounding box, stored compressed by bucket.
+    auto side = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(std::sqrt(layout.size() / 2.0))));
+    auto bucketWidth = (maximumX - minimumX) / side;
+    auto bucketHeight = (maximumY - minimumY) / side;
+    auto bucketOf = [&](const double& x, const double& y)
+    {
+        auto column = std::min(side - 1, static_cast<uint32_t>((x - minimumX) / bucketWidth));
+        auto row = std::min(side - 1, static_cast<uint32_t>((y - minimumY) / bucketHeight));
+        return std::pair{column, row};
+    };
+
+    std::vector<uint32_t> bucketBegin(static_cast<size_t>(side) * side + 1, 0);
+    for (const auto& position : layout)
+    {
+        auto [column, row] = bucketOf(position.m_X, position.m_Y);
+        ++bucketBegin[row * side + column + 1];
+    }
+    for (size_t bucket = 1; bucket < bucketBegin.size(); bucket++)
+    {
+        bucketBegin[bucket] += bucketBegin[bucket - 1];
+    }
+    std::vector<uint32_t> bucketSlots(layout.size());
+    std::vector<uint32_t> bucketFill(bucketBegin.begin(), bucketBegin.end() - 1);
+    for (uint32_t slot = 0; slot < layout.size(); slot++)
+    {
+        auto [column, row] = bucketOf(layout[slot].m_X, layout[slot].m_Y);
+        bucketSlots[bucketFill[row * side + column]++] = slot;
+    }
+
+    // A sensor at a cell's very centre all but decides that cell.
+    auto minimumDistance2 = 1e-6 * (m_CellWidth * m_CellWidth + m_CellHeight * m_CellHeight);
+    auto ringGap = std::min(bucketWidth, bucketHeight);
+    auto numberOfCells = static_cast<size_t>(m_Width) * m_Height;
+    for (size_t rank = 0; rank < HEATMAP_NEIGHBOURS; rank++)
+    {
+        m_Neighbours[rank].resize(numberOfCells);
+        m_Weights[rank].resize(numberOfCells);
+    }
+    m_Spans.resize(layout.size());
+
+    for (uint32_t row = 0; row < m_Height; row++)
+    {
+        auto y = m_MinimumY + (row + 0.5) * m_CellHeight;
+        for (uint32_t column = 0; column < m_Width; column++)
+        {
+            auto x = m_MinimumX + (column + 0.5) * m_CellWidth;
+            auto [bucketColumn, bucketRow] = bucketOf(x, y);
+
+            // Search rings of buckets outward until no unvisited bucket
+            // can hold a nearer sensor than the furthest of those found.
+            Nearest_t nearest;
+            for (uint32_t ring = 0; ring < side; ring++)
+            {
+                auto firstRow = (bucketRow >= ring) ? (bucketRow - ring) : 0;
+                auto lastRow = std::min(side - 1, bucketRow + ring);
+                auto firstColumn = (bucketColumn >= ring) ? (bucketColumn - ring) : 0;
+                auto lastColumn = std::min(side - 1, bucketColumn + ring);
+
+                for (auto r = firstRow; r <= lastRow; r++)
+                {
+                    bool isEdgeRow = (r + ring == bucketRow) || (r == bucketRow + ring);
+                    for (auto c = firstColumn; c <= lastColumn; c++)
+                    {
+                        if (!isEdgeRow && (c + ring != bucketColumn) && (c != bucketColumn + ring))
+                        {
+                            continue;
+                        }
+
+                        auto bucket = r * side + c;
+                        for (auto i = bucketBegin[bucket]; i < bucketBegin[bucket + 1]; i++)
+                        {
+                            const auto& position = layout[bucketSlots[i]];
+                            auto dx = position.m_X - x;
+                            auto dy = position.m_Y - y;
+                            nearest.Offer(dx * dx + dy * dy, bucketSlots[i]);
+                        }
+                    }
+                }
+
+                auto gap = ring * ringGap;
+                if (((nearest.m_Count == HEATMAP_NEIGHBOURS) || (nearest.m_Count == layout.size()))
+                    && (nearest.m_Distances2[nearest.m_Count - 1] <= gap * gap))
+                {
+                    break;
+                }
+            }
+
+            std::array<double, HEATMAP_NEIGHBOURS> weights{};
+            double sum = 0.0;
+            for (uint32_t rank = 0; rank < nearest.m_Count; rank++)
+            {
+                weights[rank] = 1.0 / std::pow(std::max(nearest.m_Distances2[rank], minimumDistance2),
+                                               HEATMAP_IDW_POWER / 2.0);
+                sum += weights[rank];
+            }
+
+            // Fewer sensors than neighbours: the remainder weigh nothing.
+            auto cell = static_cast<size_t>(row) * m_Width + column;
+            for (uint32_t rank = 0; rank < HEATMAP_NEIGHBOURS; rank++)
+            {
+                auto slot = (rank < nearest.m_Count) ? nearest.m_Slots[rank] : 0;
+                m_Neighbours[rank][cell] = static_cast<Slot_t>(slot);
+                m_Weights[rank][cell] = (rank < nearest.m_Count) ? static_cast<float>(weights[rank] / sum) : 0.0f;
+
+                // Columns are visited in order; a sensor's span of a row
+                // runs from the first cell it is a neighbour of to the last.
+                auto& spans = m_Spans[slot];
+                if (rank >= nearest.m_Count)
+                {
+                    continue;
+                }
+                if (spans.empty() || (spans.back().m_Row != row))
+                {
+                    spans.push_back(RowSpan_t{row, column, column + 1});
+                }
+                else
+                {
+                    spans.back().m_End = column + 1;
+                }
+            }
+        }
+    }
+}
+
+void SiteHeatmap::Start()
+{
+    if (IsEnabled())
+    {
+        ArmUpdateTimer();
+    }
+}
+
+void SiteHeatmap::Stop()
+{
+    m_UpdateTimer.cancel();
+}
+
+bool SiteHeatmap::IsEnabled() const
+{
+    return !m_Grid.empty();
+}
+
+void SiteHeatmap::Apply(const ReadingRecord_t* pRecords, const size_t& count)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto slot = m_SlotOf[pRecords[i].m_SensorNodeNumber];
+        if (slot < 0)
+        {
+            continue;
+        }
+
+        // Read first; the flag is then rarely written, nor its cache line
+        // bounced between threads.
+        auto& isDirty = m_pIsSlotDirty[slot];
+        if (!isDirty.load(std::memory_order_relaxed))
+        {
+            isDirty.store(true, std::memory_order_release);
+        }
+    }
+}
+
+HeatmapSummary_t SiteHeatmap::Summary() const
+{
+    HeatmapSummary_t summary{m_Width, m_Height, m_MinimumX, m_MinimumY,
+                             m_MinimumX + m_CellWidth * m_Width, m_MinimumY + m_CellHeight * m_Height,
+                             std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(),
+                             m_SensorOf.size(), 0};
+    if (!IsEnabled())
+    {
+        return summary;
+    }
+
+    auto coldest = std::numeric_limits<float>::max();
+    auto hottest = std::numeric_limits<float>::lowest();
+    size_t fresh = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_GridMutex);
+        for (const auto& value : m_Grid)
+        {
+            if (!std::isnan(value))
+            {
+                coldest = std::min(coldest, value);
+                hottest = std::max(hottest, value);
+                ++fresh;
+            }
+        }
+    }
+
+    if (fresh > 0)
+    {
+        summary.m_Coldest = coldest;
+        summary.m_Hottest = hottest;
+    }
+    summary.m_NumberOfFreshCells = fresh;
+    return summary;
+}
+
+double SiteHeatmap::Sample(const double& x, const double& y) const
+{
+    if (!IsEnabled())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    auto column = std::floor((x - m_MinimumX) / m_CellWidth);
+    auto row = std::floor((y - m_MinimumY) / m_CellHeight);
+    if ((column < 0.0) || (column >= m_Width) || (row < 0.0) || (row >= m_Height))
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    std::unique_lock<std::mutex> lock(m_GridMutex);
+    return m_Grid[static_cast<size_t>(row) * m_Width + static_cast<size_t>(column)];
+}
+
+bool SiteHeatmap::DumpGraymap(const std::string_view& path) const
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+
+    // Scale and write one copy of the grid, taken under one lock, such
+    // that no cell can fall outside the range it is scaled by, nor the
+    // file be written with the lock held.
+    std::vector<float> grid;
+    {
+        std::unique_lock<std::mutex> lock(m_GridMutex);
+        grid = m_Grid;
+    }
+
+    auto coldest = std::numeric_limits<float>::max();
+    auto hottest = std::numeric_limits<float>::lowest();
+    for (const auto& value : grid)
+    {
+        if (!std::isnan(value))
+        {
+            coldest = std::min(coldest, value);
+            hottest = std::max(hottest, value);
+        }
+    }
+    auto range = static_cast<double>(hottest) - coldest;
+    auto scale = (range > 0.0) ? (255.0 / range) : 0.0;
+
+    std::ofstream file{std::string(path), std::ios::binary | std::ios::trunc};
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "P5\n" << m_Width << " " << m_Height << "\n255\n";
+
+    // Row 0 is the least y; images run top down.
+    std::vector<char> pixels(m_Width);
+    for (auto row = m_Height; row-- > 0;)
+    {
+        const auto* pValues = grid.data() + static_cast<size_t>(row) * m_Width;
+        for (uint32_t column = 0; column < m_Width; column++)
+        {
+            auto value = pValues[column];
+            pixels[column] = static_cast<char>(!std::isnan(value)
+                           ? static_cast<uint8_t>(std::lround((value - coldest) * scale)) : 0);
+        }
+        file.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+void SiteHeatmap::ArmUpdateTimer()
+{
+    m_UpdateTimer.expires_after(
+        std::chrono::milliseconds(HEATMAP_UPDATE_INTERVAL_MILLISECONDS));
+    m_UpdateTimer.async_wait(asio::bind_executor(m_Executor,
+    [this](const std::error_code& error)
+    {
+        if (error == asio::error::operation_aborted)
+        {
+            return;
+        }
+
+        Update(Utility::CoarseClock::Refresh());
+        ArmUpdateTimer();
+    }));
+}
+
+size_t SiteHeatmap::Update(const SteadyClock_t::time_point& timeNow)
+{
+    if (!IsEnabled())
+    {
+        return 0;
+    }
+
+    // Taken only should some sensor need re-reading.
+    SnapshotPointer_t snapshot;
+    bool isAnyRowDirty = false;
+
+    for (size_t slot = 0; slot < m_SensorOf.size(); slot++)
+    {
+        auto isDirty = m_pIsSlotDirty[slot].exchange(false, std::memory_order_acq_rel)
+                    || (timeNow >= m_ExpiryTime[slot]);
+        if (!isDirty)
+        {
+            continue;
+        }
+
+        if (!snapshot)
+        {
+            snapshot = m_TheSensorTable.TakeSnapshot();
+        }
+
+        const auto& sample = snapshot->m_Sensors[m_SensorOf[slot]];
+        auto isFresh = Utility::IsFresh(sample, timeNow);
+        auto weighted = isFresh ? static_cast<float>(sample.m_Value) : 0.0f;
+        auto fresh = isFresh ? 1.0f : 0.0f;
+        m_ExpiryTime[slot] = isFresh ? (sample.m_ReadingTime + Minutes_t(STALE_READING_DURATION_MINUTES))
+                                     : SteadyClock_t::time_point::max();
+
+        if ((weighted == m_Weighted[slot]) && (fresh == m_Fresh[slot]))
+        {
+            continue;
+        }
+        m_Weighted[slot] = weighted;
+        m_Fresh[slot] = fresh;
+
+        for (const auto& span : m_Spans[slot])
+        {
+            auto& dirty = m_DirtyRows[span.m_Row];
+            if (dirty.m_Begin == dirty.m_End)
+            {
+                dirty = span;
+            }
+            else
+            {
+                dirty.m_Begin = std::min(dirty.m_Begin, span.m_Begin);
+                dirty.m_End = std::max(dirty.m_End, span.m_End);
+            }
+        }
+        isAnyRowDirty = isAnyRowDirty || !m_Spans[slot].empty();
+    }
+
+    size_t cells = 0;
+    if (isAnyRowDirty)
+    {
+        std::unique_lock<std::mutex> lock(m_GridMutex);
+        for (uint32_t row = 0; row < m_Height; row++)
+        {
+            auto& dirty = m_DirtyRows[row];
+            if (dirty.m_Begin != dirty.m_End)
+            {
+                Interpolate(row, dirty.m_Begin, dirty.m_End);
+                cells += dirty.m_End - dirty.m_Begin;
+                dirty = RowSpan_t{row, 0, 0};
+            }
+        }
+    }
+
+    m_Updates.fetch_add(1, std::memory_order_relaxed);
+    m_Cells.fetch_add(cells, std::memory_order_relaxed);
+    return cells;
+}
+
+void SiteHeatmap::Interpolate(const uint32_t& row, const uint32_t& begin, const uint32_t& end)
+{
+    auto first = static_cast<size_t>(row) * m_Width + begin;
+    auto count = end - begin;
+
+    std::fill_n(m_Sums.begin(), count, 0.0f);
+    std::fill_n(m_Totals.begin(), count, 0.0f);
+    for (size_t rank = 0; rank < HEATMAP_NEIGHBOURS; rank++)
+    {
+        AccumulateNeighbours(m_Neighbours[rank].data() + first, m_Weights[rank].data() + first,
+                             m_Weighted.data(), m_Fresh.data(), m_Sums.data(), m_Totals.data(), count);
+    }
+    DivideSums(m_Sums.data(), m_Totals.data(), m_Grid.data() + first, count);
+}
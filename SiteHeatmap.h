@@ -0,0 +1,190 @@
+/***********************************************************************
+* @file      SiteHeatmap.h
+*
+* A continuously updated heatmap of the site: a grid of temperatures
+* interpolated, by inverse-distance weighting, from the sensors about
+* each cell.
+*
+* @brief    Sensor coordinates (in any one unit, e.g. metres) are given one
+*           sensor per line in SENSOR_LAYOUT_PATH:
+*
+*           # <sensor> <x> <y>
+*           0   2.5   4.0
+*           1  12.0   4.0
+*
+*           Sensors not listed take no part in the heatmap. The grid, of
+*           HEATMAP_GRID_WIDTH x HEATMAP_GRID_HEIGHT cells, spans the
+*           listed sensors' bounding box.
+*
+*           Sensors never move, so each cell's HEATMAP_NEIGHBOURS nearest
+*           sensors, and their normalised weights, are found once at
+*           construction, with a uniform bucket grid over the layout as
+*           spatial index. They are held column-wise, one array per
+*           neighbour rank, such that recomputing a run of cells is one
+*           branchless pass per rank of gathers and multiply-adds over
+*           contiguous arrays, which the compiler vectorises. Each cell is
+*           then:
+*
+*               sum(w * value * fresh) / sum(w * fresh)
+*
+*           over its neighbours, i.e. a sensor without a fresh reading
+*           drops out and its neighbours' weights renormalise; a cell with
+*           no fresh neighbour has no value (NaN).
+*
+*           The inverse index, built alongside, holds for each sensor the
+*           span of columns, row by row, of the cells that it is a
+*           neighbour of. The ingest pipeline merely flags the sensors
+*           that its readings touch; an update then re-reads only flagged
+*           sensors (and those whose readings have since gone stale), and
+*           recomputes only the union of the spans of those whose value
+*           thereby changed.
+*
+* @note     Updates run on the analytics pool (see WorkStealingExecutor.h),
+*           one at a time, every HEATMAP_UPDATE_INTERVAL_MILLISECONDS; the
+*           timer is re-armed only once an update has completed. A full
+*           recompute takes milliseconds, which no dispatcher thread is
+*           thereby held for.
+*
+*           Metrics: heatmap.updates, heatmap.cells.
+*
+* @warning  Memory is some 28 bytes per cell with 4 neighbours (28 MB for
+*           the default grid of a million cells), held only should
+*           SENSOR_LAYOUT_PATH list at least one sensor.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 18, 2026
+***********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "SensorTable.h"
+#include "IngestPipeline.h"
+#include "WorkStealingExecutor.h"
+
+struct SensorPosition_t
+{
+    uint32_t                   m_SensorNodeNumber;
+    double                     m_X;
+    double                     m_Y;
+};
+
+struct HeatmapSummary_t
+{
+    uint32_t                   m_Width;
+    uint32_t                   m_Height;
+    double                     m_MinimumX;
+    double                     m_MinimumY;
+    double                     m_MaximumX;
+    double                     m_MaximumY;
+    double                     m_Coldest;   // NaN if no cell has a value.
+    double                     m_Hottest;
+    size_t                     m_NumberOfSensors;
+    size_t                     m_NumberOfFreshCells;
+};
+
+class SiteHeatmap
+{
+    // Sensors are numbered below MAXIMUM_NUMBER_OF_SENSOR_NODES, hence so
+    // are the layout's slots.
+    using Slot_t = uint16_t;
+
+    // Columns [m_Begin, m_End) of one row of the grid.
+    struct RowSpan_t
+    {
+        uint32_t                   m_Row;
+        uint32_t                   m_Begin;
+        uint32_t                   m_End;
+    };
+
+public:
+    // Malformed lines, and sensors beyond numberOfSensors, are reported
+    // and skipped. A missing file simply lists no sensors.
+    static std::vector<SensorPosition_t> LoadLayout(const std::string_view& path,
+                                                    const size_t& numberOfSensors);
+
+    SiteHeatmap(asio::io_context& ioContext, const WorkStealingPool::executor_type& executor,
+                const SensorTable& sensorTable, const size_t& numberOfSensors,
+                const std::vector<SensorPosition_t>& layout,
+                const uint32_t& width = HEATMAP_GRID_WIDTH, const uint32_t& height = HEATMAP_GRID_HEIGHT);
+    virtual ~SiteHeatmap();
+
+    SiteHeatmap(const SiteHeatmap&) = delete;
+    SiteHeatmap& operator=(const SiteHeatmap&) = delete;
+
+    void Start();
+    void Stop();
+
+    bool IsEnabled() const;
+
+    // Marks the batch's positioned sensors dirty, such that the next
+    // update recomputes only their cells. Lock-free.
+    void Apply(const ReadingRecord_t* pRecords, const size_t& count);
+
+    HeatmapSummary_t Summary() const;
+
+    // The cell holding site coordinates (x, y); NaN if outside the grid or
+    // without a value.
+    double Sample(const double& x, const double& y) const;
+
+    // As a binary portable graymap, coldest cell black, hottest white and
+    // cells without a value black. False if it could not be written.
+    bool DumpGraymap(const std::string_view& path) const;
+
+protected:
+    void ArmUpdateTimer();
+
+    // Returns the number of cells recomputed.
+    size_t Update(const SteadyClock_t::time_point& timeNow);
+
+private:
+    void BuildNeighbours(const std::vector<SensorPosition_t>& layout);
+
+    // Requires m_GridMutex.
+    void Interpolate(const uint32_t& row, const uint32_t& begin, const uint32_t& end);
+
+    const SensorTable&                         m_TheSensorTable;
+    asio::steady_timer                         m_UpdateTimer;
+    WorkStealingPool::executor_type            m_Executor;
+
+    uint32_t                                   m_Width;
+    uint32_t                                   m_Height;
+    double                                     m_MinimumX;
+    double                                     m_MinimumY;
+    double                                     m_CellWidth;
+    double                                     m_CellHeight;
+
+    // Indexed by physical sensor; -1 if not in the layout.
+    std::vector<int32_t>                       m_SlotOf;
+    std::vector<uint32_t>                      m_SensorOf;
+
+    // Indexed by slot. Written only by updates.
+    std::vector<float>                         m_Weighted; // Value if fresh, else 0.
+    std::vector<float>                         m_Fresh;    // 1 if fresh, else 0.
+    std::vector<SteadyClock_t::time_point>     m_ExpiryTime;
+    std::vector<std::vector<RowSpan_t>>        m_Spans;
+    std::unique_ptr<std::atomic<bool>[]>       m_pIsSlotDirty;
+
+    // Indexed by cell, row-major; one array per neighbour rank.
+    std::array<std::vector<Slot_t>, HEATMAP_NEIGHBOURS> m_Neighbours;
+    std::array<std::vector<float>, HEATMAP_NEIGHBOURS>  m_Weights;
+
+    // Indexed by row; empty unless to be recomputed.
+    std::vector<RowSpan_t>                     m_DirtyRows;
+
+    // Scratch for one row's weighted sums and total weights.
+    std::vector<float>                         m_Sums;
+    std::vector<float>                         m_Totals;
+
+    mutable std::mutex                         m_GridMutex;
+    std::vector<float>                         m_Grid;
+
+    Metrics::Counter_t&                        m_Updates;
+    Metrics::Counter_t&                        m_Cells;
+};
@@ -0,0 +1,114 @@
+/***********************************************************************
+* @file      SpscRing.h
+*
+* Bounded, lock-free, single-producer/single-consumer ring buffer.
+*
+* @brief    The producer owns the tail index and the consumer owns the
+*           head index; each only ever reads the other's index, with
+*           acquire/release ordering. Each side furthermore caches the
+*           last-seen value of the other side's index so that, in the
+*           steady state, neither touches the other's cache line.
+*
+* @note     Capacity must be a power of 2 so that wrapping is a mask.
+*
+* @warning  Exactly ONE producer thread and ONE consumer thread at any
+*           given time. Use one ring per producer otherwise.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace Utility
+{
+    template <typename T, size_t CAPACITY>
+    class SpscRing
+    {
+        static_assert((CAPACITY >= 2) && ((CAPACITY & (CAPACITY - 1)) == 0),
+                      "SpscRing capacity must be a power of 2.");
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "SpscRing elements are copied, not constructed in place.");
+
+        static constexpr size_t MASK = CAPACITY - 1;
+
+    public:
+        SpscRing() = default;
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        static constexpr size_t Capacity() { return CAPACITY; }
+
+        // Producer side. Returns false if the ring is full.
+        bool TryPush(const T& element)
+        {
+            const auto tail = m_Tail.load(std::memory_order_relaxed);
+
+            if ((tail - m_CachedHead) == CAPACITY)
+            {
+                m_CachedHead = m_Head.load(std::memory_order_acquire);
+                if ((tail - m_CachedHead) == CAPACITY)
+                {
+                    return false;
+                }
+            }
+
+            m_Elements[tail & MASK] = element;
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Pops up to maximum elements into pOut; returns
+        // the number popped. One acquire and one release per batch.
+        size_t PopBatch(T* pOut, const size_t& maximum)
+        {
+            const auto head = m_Head.load(std::memory_order_relaxed);
+
+            if (m_CachedTail == head)
+            {
+                m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            }
+
+            auto available = m_CachedTail - head;
+            auto count = (available < maximum) ? available : maximum;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                pOut[i] = m_Elements[(head + i) & MASK];
+            }
+
+            if (count > 0)
+            {
+                m_Head.store(head + count, std::memory_order_release);
+            }
+            return count;
+        }
+
+        bool TryPop(T& element)
+        {
+            return PopBatch(&element, 1) == 1;
+        }
+
+        // Approximate when observed from a third thread.
+        size_t Size() const
+        {
+            return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+        }
+
+    private:
+        // Producer-owned cache line.
+        alignas(64) std::atomic<size_t>  m_Tail{0};
+        size_t                           m_CachedHead{0};
+
+        // Consumer-owned cache line.
+        alignas(64) std::atomic<size_t>  m_Head{0};
+        size_t                           m_CachedTail{0};
+
+        alignas(64) std::array<T, CAPACITY>  m_Elements{};
+    };
+}
@@ -1,12 +1,50 @@
 #include <signal.h>
+#include <charconv>
+#include <future>
 #include "SessionManager.h"
+#include "QueryServer.h"
+#include "FlightRecorder.h"
+#include "SensorDiscovery.h"
 
 void terminator(int signalNumber);
+void AwaitTraceRequests(asio::signal_set& traceSignals);
+void AwaitCalibrationReloads(asio::signal_set& reloadSignals, SessionManager& sessionManager);
+bool DiscoverSensors(const std::vector<DiscoveryRange_t>& ranges, std::vector<tcp::endpoint>& endpoints);
 
 int main([[maybe_unused]]int argc, [[maybe_unused]]char* argv[])
 {
-    // Setup and run the one worker thread and one io_context that we 
-    // need to successfully serialize all operations expected from the 
+    // TemperatureReadoutApplication [number-of-sensor-nodes | --discover]
+    size_t numberOfSensors = NUMBER_OF_SENSOR_NODES;
+    std::vector<DiscoveryRange_t> discoveryRanges;
+    bool isDiscovering = (argc > 1) && (std::string_view(argv[1]) == "--discover");
+    if (isDiscovering)
+    {
+        discoveryRanges = SensorDiscovery::LoadRanges(DISCOVERY_RANGES_PATH);
+        if (discoveryRanges.empty())
+        {
+            std::cout << "[ERROR] --discover requires host and port ranges in "
+                      << DISCOVERY_RANGES_PATH << ".\n";
+            return 1;
+        }
+    }
+    else if (argc > 1)
+    {
+        std::string_view text(argv[1]);
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), numberOfSensors);
+        if ((ec != std::errc()) || (ptr != text.data() + text.size())
+            || (numberOfSensors == 0) || (numberOfSensors > MAXIMUM_NUMBER_OF_SENSOR_NODES))
+        {
+            std::cout << "[ERROR] The number of sensor nodes must be from 1 to "
+                      << MAXIMUM_NUMBER_OF_SENSOR_NODES << "; got \"" << text << "\".\n";
+            return 1;
+        }
+    }
+
+    // Should we ever crash, leave the recent history of events behind.
+    FlightRecorder::InstallFatalSignalHandlers(FLIGHT_RECORDER_TRACE_PATH);
+
+    // Setup and run the (elastic) worker threads and one io_context that
+    // we need to successfully serialize all operations expected from the 
     // potentially several asynchronous socket instances. See the C++
     // Networking Technical Specification standard for the details
     // undergirding io_context and its usage:
@@ -15,13 +53,34 @@ int main([[maybe_unused]]int argc, [[maybe_unused]]char* argv[])
     Common::SetupIOContext();
     Common::RunWorkerThreads();
 
-    // Setup so we catch application 'terminator' signals.
-    struct sigaction action;
-    memset(&action, 0, sizeof(struct sigaction));
-    action.sa_handler = terminator;
-    sigaction(SIGTERM, &action, NULL);
-    sigaction(SIGINT, &action, NULL);
-    sigaction(SIGQUIT, &action, NULL);
+    // Setup so we catch application 'terminator' signals. These are
+    // delivered through the dispatcher rather than in the asynchronous
+    // signal context, at control priority, so that shutdown jumps ahead
+    // of any backlog of readings.
+    asio::signal_set terminatorSignals(Common::g_DispatcherIOContext, SIGTERM, SIGINT, SIGQUIT);
+    terminatorSignals.async_wait(asio::bind_executor(
+        Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::CONTROL),
+        [](const std::error_code& error, int signalNumber)
+        {
+            if (!error)
+            {
+                terminator(signalNumber);
+            }
+        }));
+
+    // Ops may ask for a flight recorder dump at any time with SIGUSR1.
+    asio::signal_set traceSignals(Common::g_DispatcherIOContext, SIGUSR1);
+    AwaitTraceRequests(traceSignals);
+
+    // Commissioning: sensor nodes are found by probing, rather than named
+    // by their number.
+    std::vector<tcp::endpoint> discoveredEndpoints;
+    if (isDiscovering && !DiscoverSensors(discoveryRanges, discoveredEndpoints))
+    {
+        Common::DestroyWorkerThreads();
+        Common::JoinWorkerThreads();
+        return 1;
+    }
 
     // Be aware that if the program is forcibly halted whilst the SessionManager
     // is still constructing and connecting to the sockets, then by design,
@@ -36,18 +95,134 @@ int main([[maybe_unused]]int argc, [[maybe_unused]]char* argv[])
     // Value := "Code: 125
     //  Category: system
     //  Message: Operation canceled
-    auto theSessionManager = std::make_shared<SessionManager>();
+    auto theSessionManager = isDiscovering ? std::make_shared<SessionManager>(discoveredEndpoints)
+                                           : std::make_shared<SessionManager>(numberOfSensors);
+    std::cout << "[INFO] Session manager for " << theSessionManager->NumberOfSensors()
+              << " sensor nodes occupies " << theSessionManager->FootprintBytes() << " bytes\n";
     theSessionManager->Start();
 
+    // Serve the local ops query API on the very same dispatcher. Queries
+    // are answered from the sensor table snapshots only.
+    auto theQueryServer = std::make_shared<QueryServer>(Common::g_DispatcherIOContext,
+                                 QUERY_SOCKET_PATH,
+                                 theSessionManager->GetSensorTable(),
+                                 theSessionManager->GetVirtualSensors(),
+                                 theSessionManager->GetAnomalyDetector(),
+                                 theSessionManager->GetAlertRules(),
+                                 theSessionManager->GetChannelHistory(),
+                                 theSessionManager->GetSiteHeatmap(),
+                                 Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::QUERY),
+                                 Common::g_AnalyticsWorkPool->get_executor());
+    theQueryServer->Start();
+
+    // Ops may have the calibration reloaded, without pausing ingest, with
+    // SIGHUP.
+    asio::signal_set reloadSignals(Common::g_DispatcherIOContext, SIGHUP);
+    AwaitCalibrationReloads(reloadSignals, *theSessionManager);
+
     // Block and wait on the worker threads until they have completed
     // processing ALL 'work' (past, present and future) to be scheduled
     // from the potentially many asynchronuous socket instances, and are 
     // ready to exit.
     Common::JoinWorkerThreads();
+
+    // Handlers abandoned in the stopped io_context keep the session manager
+    // alive until static destruction; stop its aggregation thread now,
+    // before the metrics registry it writes to is itself destroyed.
+    theSessionManager->Stop();
     
     return 0;
 }
 
+bool DiscoverSensors(const std::vector<DiscoveryRange_t>& ranges, std::vector<tcp::endpoint>& endpoints)
+{
+    std::promise<std::vector<tcp::endpoint>> discovered;
+    auto result = discovered.get_future();
+
+    auto startTime = SteadyClock_t::now();
+    SensorDiscovery discovery(Common::g_DispatcherIOContext,
+                              Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::RECONNECT),
+                              ranges);
+    discovery.Start([&discovered](std::vector<tcp::endpoint> found)
+    {
+        discovered.set_value(std::move(found));
+    });
+
+    // Shutdown, signalled meanwhile, abandons the probes.
+    while (result.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+    {
+        if (Common::g_DispatcherIOContext.stopped())
+        {
+            return false;
+        }
+    }
+    endpoints = result.get();
+
+    std::cout << "[INFO] Discovery took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock_t::now() - startTime).count()
+              << " ms\n";
+
+    if (endpoints.empty())
+    {
+        std::cout << "[ERROR] No sensor nodes answered in the ranges of " << DISCOVERY_RANGES_PATH << ".\n";
+        return false;
+    }
+    if (endpoints.size() > MAXIMUM_NUMBER_OF_SENSOR_NODES)
+    {
+        std::cout << "[WARN] Keeping the first " << MAXIMUM_NUMBER_OF_SENSOR_NODES << " of "
+                  << endpoints.size() << " sensor nodes discovered.\n";
+        endpoints.resize(MAXIMUM_NUMBER_OF_SENSOR_NODES);
+    }
+
+    if (!SensorDiscovery::WriteEndpoints(DISCOVERED_SENSORS_PATH, endpoints))
+    {
+        std::cout << "[WARN] Unable to write the sensor nodes discovered to " << DISCOVERED_SENSORS_PATH << "\n";
+    }
+    return true;
+}
+
+void AwaitTraceRequests(asio::signal_set& traceSignals)
+{
+    traceSignals.async_wait(asio::bind_executor(
+        Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::CONTROL),
+        [&traceSignals](const std::error_code& error, int signalNumber)
+        {
+            if (error)
+            {
+                return;
+            }
+
+            if (FlightRecorder::DumpChromeTrace(FLIGHT_RECORDER_TRACE_PATH))
+            {
+                std::cout << "[INFO] Flight recorder dumped to " << FLIGHT_RECORDER_TRACE_PATH << "\n";
+            }
+            else
+            {
+                std::cout << "[ERROR] Unable to dump the flight recorder to " << FLIGHT_RECORDER_TRACE_PATH << "\n";
+            }
+
+            AwaitTraceRequests(traceSignals);
+        }));
+}
+
+void AwaitCalibrationReloads(asio::signal_set& reloadSignals, SessionManager& sessionManager)
+{
+    reloadSignals.async_wait(asio::bind_executor(
+        Common::g_DispatcherPriorities->get_executor(HandlerPriority_t::CONTROL),
+        [&reloadSignals, &sessionManager](const std::error_code& error, int signalNumber)
+        {
+            if (error)
+            {
+                return;
+            }
+
+            // Successes and failures alike are logged by the calibration.
+            sessionManager.ReloadCalibration();
+
+            AwaitCalibrationReloads(reloadSignals, sessionManager);
+        }));
+}
+
 void terminator(int signalNumber)
 {
     if ((SIGTERM == signalNumber) || (SIGINT == signalNumber) || (SIGQUIT == signalNumber))
@@ -55,7 +230,7 @@ void terminator(int signalNumber)
         std::cout << "[WARN] Signal Received: Closing application orderly, cleanly and gracefully." << "\n\n";
         
         // This call is designed to be thread-safe so go ahead and invoke
-        // it from the asynchronous signal context.
+        // it from whichever dispatcher thread delivered the signal.
         Common::DestroyWorkerThreads(); 
         
         // Customer Requirement:
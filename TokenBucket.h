@@ -0,0 +1,81 @@
+/***********************************************************************
+* @file      TokenBucket.h
+*
+* Token bucket rate limiter.
+*
+* @brief    The bucket holds at most m_Burst tokens and is refilled at
+*           m_TokensPerSecond. Each admitted event consumes one token. An
+*           empty bucket tells the caller how long until the next token,
+*           so that the caller may defer rather than spin.
+*
+* @note     Refill is computed lazily from the elapsed time upon each call;
+*           there are no timers involved.
+*
+* @warning  NOT thread-safe. Use one bucket per sequential chain of
+*           handlers, e.g. one per sensor node socket.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+
+namespace Utility
+{
+    class TokenBucket
+    {
+    public:
+        using Clock_t = std::chrono::steady_clock;
+
+        TokenBucket(const double& tokensPerSecond, const double& burst)
+            : m_TokensPerSecond(tokensPerSecond)
+            , m_Burst(burst)
+            , m_Tokens(burst)
+            , m_LastRefillTime(Clock_t::now())
+        {
+        }
+
+        bool TryConsume(const Clock_t::time_point& timeNow)
+        {
+            Refill(timeNow);
+
+            if (m_Tokens >= 1.0)
+            {
+                m_Tokens -= 1.0;
+                return true;
+            }
+            return false;
+        }
+
+        Clock_t::duration TimeUntilAvailable(const Clock_t::time_point& timeNow)
+        {
+            Refill(timeNow);
+
+            if (m_Tokens >= 1.0)
+            {
+                return Clock_t::duration::zero();
+            }
+            return std::chrono::duration_cast<Clock_t::duration>(
+                       std::chrono::duration<double>((1.0 - m_Tokens) / m_TokensPerSecond));
+        }
+
+    private:
+        void Refill(const Clock_t::time_point& timeNow)
+        {
+            auto elapsed = std::chrono::duration<double>(timeNow - m_LastRefillTime).count();
+            if (elapsed > 0.0)
+            {
+                m_Tokens = std::min(m_Burst, m_Tokens + (elapsed * m_TokensPerSecond));
+                m_LastRefillTime = timeNow;
+            }
+        }
+
+        double                 m_TokensPerSecond;
+        double                 m_Burst;
+        double                 m_Tokens;
+        Clock_t::time_point    m_LastRefillTime;
+    };
+}
@@ -0,0 +1,457 @@
+#include "VirtualSensors.h"
+#include "CoarseClock.h"
+
+#include <map>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+    std::string_view Trim(std::string_view text)
+    {
+        auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+        {
+            return {};
+        }
+        auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    bool ParseOperation(const std::string_view& text, VirtualOperation_t& operation)
+    {
+        static const std::map<std::string_view, VirtualOperation_t> OPERATIONS = {
+            {"AVERAGE",    VirtualOperation_t::AVERAGE},
+            {"MIN",        VirtualOperation_t::MINIMUM},
+            {"MAX",        VirtualOperation_t::MAXIMUM},
+            {"DIFFERENCE", VirtualOperation_t::DIFFERENCE},
+        };
+
+        auto it = OPERATIONS.find(text);
+        if (it == OPERATIONS.end())
+        {
+            return false;
+        }
+        operation = it->second;
+        return true;
+    }
+
+    std::string_view ToString(const VirtualOperation_t& operation)
+    {
+        switch (operation)
+        {
+            case VirtualOperation_t::AVERAGE:    return "AVERAGE";
+            case VirtualOperation_t::MINIMUM:    return "MIN";
+            case VirtualOperation_t::MAXIMUM:    return "MAX";
+            case VirtualOperation_t::DIFFERENCE: return "DIFFERENCE";
+        }
+        return "?";
+    }
+}
+
+std::vector<VirtualSensorDefinition_t> VirtualSensorGraph::LoadDefinitions(const std::string_view& path)
+{
+    std::vector<VirtualSensorDefinition_t> definitions;
+
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        return definitions;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::string_view text(line);
+        text = Trim(text.substr(0, text.find('#')));
+        if (text.empty())
+        {
+            continue;
+        }
+
+        auto equals = text.find('=');
+        auto open = text.find('(');
+        auto close = text.rfind(')');
+        if ((equals == std::string_view::npos) || (open == std::string_view::npos)
+            || (close == std::string_view::npos) || (open < equals) || (close < open)
+            || !Trim(text.substr(close + 1)).empty())
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber
+                      << ": Expected \"<name> = <OPERATION>(<input>, ...)\"; skipped.\n";
+            continue;
+        }
+
+        VirtualSensorDefinition_t definition;
+        definition.m_Name = std::string(Trim(text.substr(0, equals)));
+
+        auto operation = Trim(text.substr(equals + 1, open - equals - 1));
+        if (definition.m_Name.empty()
+            || (definition.m_Name.find_first_of(" \t:,()") != std::string::npos))
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber
+                      << ": Invalid virtual sensor name; skipped.\n";
+            continue;
+        }
+        if (!ParseOperation(operation, definition.m_Operation))
+        {
+            std::cout << "[ERROR] " << path << ":" << lineNumber << ": Unknown operation \""
+                      << operation << "\"; expected AVERAGE, MIN, MAX or DIFFERENCE; skipped.\n";
+            continue;
+        }
+
+        auto inputs = text.substr(open + 1, close - open - 1);
+        while (!inputs.empty())
+        {
+            auto comma = inputs.find(',');
+            auto input = Trim(inputs.substr(0, comma));
+            if (!input.empty())
+            {
+                definition.m_Inputs.emplace_back(input);
+            }
+            inputs = (comma == std::string_view::npos) ? std::string_view() : inputs.substr(comma + 1);
+        }
+
+        definitions.push_back(std::move(definition));
+    }
+
+    std::cout << "[INFO] Loaded " << definitions.size() << " virtual sensor definitions from "
+              << path << "\n";
+    return definitions;
+}
+
+VirtualSensorGraph::VirtualSensorGraph(const size_t& numberOfSensors,
+                                       const std::vector<VirtualSensorDefinition_t>& definitions)
+    : m_VirtualSensors(Resolve(numberOfSensors, definitions))
+    , m_SensorDependents()
+    , m_DirtySensors()
+    , m_GraphMutex()
+    , m_TheSensorTable(m_VirtualSensors.size())
+    , m_Evaluations(Metrics::Counter("virtual.evaluations"))
+{
+    if (m_VirtualSensors.empty())
+    {
+        return;
+    }
+
+    // Only now that no more virtual sensors may be dropped are the
+    // physical sensors' dependents final.
+    m_SensorDependents.resize(numberOfSensors);
+    for (size_t i = 0; i < m_VirtualSensors.size(); i++)
+    {
+        for (const auto& [sensorNodeNumber, slot] : m_VirtualSensors[i].m_SensorSlots)
+        {
+            m_SensorDependents[sensorNodeNumber].push_back(Edge_t{static_cast<uint32_t>(i), slot});
+        }
+    }
+
+    Metrics::Gauge("virtual.sensors").store(static_cast<int64_t>(m_VirtualSensors.size()),
+                                            std::memory_order_relaxed);
+}
+
+std::vector<VirtualSensorGraph::VirtualSensor_t> VirtualSensorGraph::Resolve(
+    const size_t& numberOfSensors, const std::vector<VirtualSensorDefinition_t>& definitions)
+{
+    std::vector<VirtualSensor_t> virtualSensors;
+    std::unordered_map<std::string, uint32_t> byName;
+
+    for (const auto& definition : definitions)
+    {
+        // Slots are assigned in the order the inputs are written, such
+        // that DIFFERENCE knows its minuend from its subtrahend. An input
+        // named twice (e.g. a sensor, and its zone) counts but once.
+        std::vector<std::pair<uint32_t, uint32_t>> sensorSlots;
+        std::vector<std::pair<uint32_t, uint32_t>> virtualSlots;
+        std::unordered_map<uint32_t, uint32_t> sensorSlotOf;
+        std::unordered_map<uint32_t, uint32_t> virtualSlotOf;
+        uint32_t numberOfSlots = 0;
+        bool hasZone = false;
+        std::string expression;
+        std::string error;
+
+        auto addSensor = [&](const size_t& sensorNodeNumber)
+        {
+            auto [it, isNew] = sensorSlotOf.try_emplace(static_cast<uint32_t>(sensorNodeNumber), numberOfSlots);
+            if (isNew)
+            {
+                sensorSlots.emplace_back(static_cast<uint32_t>(sensorNodeNumber), numberOfSlots++);
+            }
+        };
+
+        for (const auto& input : definition.m_Inputs)
+        {
+            size_t index = 0;
+            if (Utility::ParseIndex(input, "sensor:", index))
+            {
+                if (index >= numberOfSensors)
+                {
+                    error = "no such sensor \"" + input + "\"";
+                    break;
+                }
+                addSensor(index);
+            }
+            else if (Utility::ParseIndex(input, "zone:", index))
+            {
+                if (index >= NUMBER_OF_SENSOR_ZONES)
+                {
+                    error = "no such zone \"" + input + "\"";
+                    break;
+                }
+                for (size_t i = index; i < numberOfSensors; i += NUMBER_OF_SENSOR_ZONES)
+                {
+                    addSensor(i);
+                }
+                hasZone = true;
+            }
+            else
+            {
+                auto it = byName.find(input);
+                if (it == byName.end())
+                {
+                    error = "unknown input \"" + input + "\"";
+                    break;
+                }
+                auto [slot, isNew] = virtualSlotOf.try_emplace(it->second, numberOfSlots);
+                if (isNew)
+                {
+                    virtualSlots.emplace_back(it->second, numberOfSlots++);
+                }
+            }
+
+            expression += (expression.empty() ? "" : ",") + input;
+        }
+
+        if (error.empty() && (numberOfSlots == 0))
+        {
+            error = "no inputs";
+        }
+        if (error.empty() && (definition.m_Operation == VirtualOperation_t::DIFFERENCE)
+            && (hasZone || (numberOfSlots != 2)))
+        {
+            error = "DIFFERENCE takes exactly two distinct sensors or virtual sensors";
+        }
+        if (error.empty() && byName.count(definition.m_Name))
+        {
+            error = "already defined";
+        }
+        if (!error.empty())
+        {
+            std::cout << "[ERROR] Virtual sensor \"" << definition.m_Name << "\": " << error
+                      << "; dropped.\n";
+            continue;
+        }
+
+        auto virtualSensorNumber = static_cast<uint32_t>(virtualSensors.size());
+        byName.emplace(definition.m_Name, virtualSensorNumber);
+
+        VirtualSensor_t virtualSensor{
+            definition.m_Name,
+            std::string(ToString(definition.m_Operation)) + "(" + expression + ")",
+            definition.m_Operation,
+            (definition.m_Operation == VirtualOperation_t::DIFFERENCE)
+                ? Inputs_t(std::array<Reading_t, 2>{})
+                : (definition.m_Operation == VirtualOperation_t::AVERAGE)
+                ? Inputs_t(std::in_place_index<0>, numberOfSlots)
+                : Inputs_t(std::in_place_index<1>, numberOfSlots),
+            std::move(sensorSlots),
+            {},
+            {},
+            false};
+
+        for (const auto& [input, slot] : virtualSlots)
+        {
+            virtualSensors[input].m_Dependents.push_back(Edge_t{virtualSensorNumber, slot});
+        }
+
+        virtualSensors.push_back(std::move(virtualSensor));
+    }
+
+    return virtualSensors;
+}
+
+size_t VirtualSensorGraph::Size() const
+{
+    return m_VirtualSensors.size();
+}
+
+const std::string& VirtualSensorGraph::Name(const size_t& virtualSensorNumber) const
+{
+    return m_VirtualSensors[virtualSensorNumber].m_Name;
+}
+
+const std::string& VirtualSensorGraph::Expression(const size_t& virtualSensorNumber) const
+{
+    return m_VirtualSensors[virtualSensorNumber].m_Expression;
+}
+
+const SensorTable& VirtualSensorGraph::GetSensorTable() const
+{
+    return m_TheSensorTable;
+}
+
+void VirtualSensorGraph::Apply(const ReadingRecord_t* pRecords, const size_t& count)
+{
+    if (m_VirtualSensors.empty())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_GraphMutex);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& record = pRecords[i];
+        if (record.m_SensorNodeNumber >= m_SensorDependents.size())
+        {
+            continue;
+        }
+
+        Reading_t reading{true, record.m_Value, record.m_ReadingTime};
+        for (const auto& edge : m_SensorDependents[record.m_SensorNodeNumber])
+        {
+            Feed(edge, reading);
+        }
+    }
+
+    // Each dirty virtual sensor is evaluated once per batch, however many
+    // of its inputs the batch updated.
+    Propagate(Utility::CoarseClock::Now());
+}
+
+void VirtualSensorGraph::Expire(const SteadyClock_t::time_point& timeNow)
+{
+    if (m_VirtualSensors.empty())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_GraphMutex);
+
+    // A virtual reading's time is that of its oldest input; once that
+    // goes stale, re-evaluating drops it (or the reading altogether).
+    for (size_t i = 0; i < m_VirtualSensors.size(); i++)
+    {
+        const auto& reading = m_VirtualSensors[i].m_Reading;
+        if (reading.m_HasReading && !Utility::IsFresh(reading.m_ReadingTime, timeNow))
+        {
+            MarkDirty(static_cast<uint32_t>(i));
+        }
+    }
+
+    Propagate(timeNow);
+}
+
+void VirtualSensorGraph::Feed(const Edge_t& edge, const Reading_t& reading)
+{
+    auto& inputs = m_VirtualSensors[edge.m_VirtualSensorNumber].m_Inputs;
+
+    if (auto pOperands = std::get_if<std::array<Reading_t, 2>>(&inputs))
+    {
+        auto& operand = (*pOperands)[edge.m_Slot];
+        if (!reading.m_HasReading || !operand.m_HasReading
+            || (reading.m_ReadingTime >= operand.m_ReadingTime))
+        {
+            operand = reading;
+        }
+    }
+    else if (reading.m_HasReading)
+    {
+        // An input that lost its reading simply expires, as its reading
+        // time was by then already stale.
+        std::visit([&](auto& aggregator)
+        {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(aggregator)>, std::array<Reading_t, 2>>)
+            {
+                aggregator.Update(edge.m_Slot, reading.m_Value, reading.m_ReadingTime);
+            }
+        }, inputs);
+    }
+
+    MarkDirty(edge.m_VirtualSensorNumber);
+}
+
+void VirtualSensorGraph::MarkDirty(const uint32_t& virtualSensorNumber)
+{
+    auto& virtualSensor = m_VirtualSensors[virtualSensorNumber];
+    if (!virtualSensor.m_IsDirty)
+    {
+        virtualSensor.m_IsDirty = true;
+        m_DirtySensors.push(virtualSensorNumber);
+    }
+}
+
+void VirtualSensorGraph::Propagate(const SteadyClock_t::time_point& timeNow)
+{
+    // Dependents are always defined after their inputs, hence visiting the
+    // dirty virtual sensors lowest first evaluates each one only after all
+    // of its dirty inputs.
+    while (!m_DirtySensors.empty())
+    {
+        auto virtualSensorNumber = m_DirtySensors.top();
+        m_DirtySensors.pop();
+
+        auto& virtualSensor = m_VirtualSensors[virtualSensorNumber];
+        virtualSensor.m_IsDirty = false;
+
+        auto reading = Evaluate(virtualSensor, timeNow);
+        m_Evaluations.fetch_add(1, std::memory_order_relaxed);
+
+        if (reading == virtualSensor.m_Reading)
+        {
+            continue;
+        }
+        virtualSensor.m_Reading = reading;
+
+        // Without any reading, the last one published is left to age, as
+        // its reading time is already stale.
+        if (reading.m_HasReading)
+        {
+            m_TheSensorTable.Update(virtualSensorNumber, reading.m_Value, reading.m_ReadingTime);
+        }
+
+        for (const auto& edge : virtualSensor.m_Dependents)
+        {
+            Feed(edge, reading);
+        }
+    }
+}
+
+VirtualSensorGraph::Reading_t VirtualSensorGraph::Evaluate(VirtualSensor_t& virtualSensor,
+                                                           const SteadyClock_t::time_point& timeNow)
+{
+    Reading_t reading;
+
+    if (auto pOperands = std::get_if<std::array<Reading_t, 2>>(&virtualSensor.m_Inputs))
+    {
+        const auto& [minuend, subtrahend] = *pOperands;
+        if (minuend.m_HasReading && subtrahend.m_HasReading
+            && Utility::IsFresh(minuend.m_ReadingTime, timeNow)
+            && Utility::IsFresh(subtrahend.m_ReadingTime, timeNow))
+        {
+            reading.m_HasReading = true;
+            reading.m_Value = minuend.m_Value - subtrahend.m_Value;
+            reading.m_ReadingTime = std::min(minuend.m_ReadingTime, subtrahend.m_ReadingTime);
+        }
+        return reading;
+    }
+
+    std::visit([&](auto& aggregator)
+    {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(aggregator)>, std::array<Reading_t, 2>>)
+        {
+            aggregator.Expire(timeNow);
+            auto aggregate = aggregator.Result();
+            if (aggregate.m_Count > 0)
+            {
+                reading.m_HasReading = true;
+                reading.m_Value = (virtualSensor.m_Operation == VirtualOperation_t::MINIMUM) ? aggregate.m_Minimum
+                                : (virtualSensor.m_Operation == VirtualOperation_t::MAXIMUM) ? aggregate.m_Maximum
+                                : aggregate.m_Value;
+                reading.m_ReadingTime = aggregator.OldestReadingTime();
+            }
+        }
+    }, virtualSensor.m_Inputs);
+
+    return reading;
+}
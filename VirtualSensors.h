@@ -0,0 +1,161 @@
+/***********************************************************************
+* @file      VirtualSensors.h
+*
+* Virtual sensors are computed from other sensors, e.g. "building A
+* average minus outdoor average" or "max of the rooftop sensors", and
+* are published alongside the physical ones with the very same
+* staleness semantics.
+*
+* @brief    Each virtual sensor is defined on one line of ascii text in
+*           VIRTUAL_SENSORS_PATH:
+*
+*           # <name> = <AVERAGE|MIN|MAX|DIFFERENCE>(<input>, ...)
+*           building_a  = AVERAGE(zone:0)
+*           outdoor     = AVERAGE(sensor:2, sensor:3)
+*           a_vs_out    = DIFFERENCE(building_a, outdoor)
+*           rooftop_max = MAX(sensor:0, sensor:1)
+*
+*           An input is a physical sensor ("sensor:<n>"), all physical
+*           sensors of a zone ("zone:<z>"), or a virtual sensor defined
+*           on some earlier line. Definition order is thus a topological
+*           order of the dependency graph, and cycles cannot be expressed.
+*
+*           Readings applied by the ingest pipeline mark only the virtual
+*           sensors depending upon them as dirty. Dirty virtual sensors are
+*           re-evaluated once per batch of readings, in definition order,
+*           and only those whose value or reading time thereby changed
+*           dirty their own dependents in turn.
+*
+* @note     A virtual reading is only as fresh as the oldest reading it is
+*           derived from; its reading time is that of the oldest input it
+*           was computed from. AVERAGE, MIN and MAX are computed over their
+*           fresh inputs, and have a reading whilst any input is fresh.
+*           DIFFERENCE (of exactly two inputs) requires both to be fresh.
+*           Expire() re-evaluates virtual sensors whose oldest input has
+*           just gone stale, such that it drops out of the computation.
+*
+* @warning  Virtual sensors are published to their own SensorTable, hence
+*           never count towards the displayed temperature nor the zone
+*           averages. Their zone there is meaningless.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include <utility>
+#include <variant>
+#include <functional>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "AggregationPolicies.h"
+#include "SensorTable.h"
+#include "IngestPipeline.h"
+
+enum class VirtualOperation_t : uint8_t
+{
+    AVERAGE,
+    MINIMUM,
+    MAXIMUM,
+    DIFFERENCE
+};
+
+struct VirtualSensorDefinition_t
+{
+    std::string                m_Name;
+    VirtualOperation_t         m_Operation;
+    std::vector<std::string>   m_Inputs; // "sensor:<n>", "zone:<z>" or a virtual sensor's name.
+};
+
+class VirtualSensorGraph
+{
+    struct Reading_t
+    {
+        bool                       m_HasReading{false};
+        double                     m_Value{0.0};
+        SteadyClock_t::time_point  m_ReadingTime{};
+
+        bool operator==(const Reading_t&) const = default;
+    };
+
+    // Input m_Slot of virtual sensor m_VirtualSensorNumber.
+    struct Edge_t
+    {
+        uint32_t   m_VirtualSensorNumber;
+        uint32_t   m_Slot;
+    };
+
+    // AVERAGE, MIN and MAX maintain their fresh inputs incrementally, by
+    // slot, exactly as the displayed temperature does; DIFFERENCE merely
+    // holds its two operands.
+    using Inputs_t = std::variant<IncrementalAggregator<MeanAggregation_t>,
+                                  IncrementalAggregator<EnvelopeAggregation_t>,
+                                  std::array<Reading_t, 2>>;
+
+    struct VirtualSensor_t
+    {
+        std::string                m_Name;
+        std::string                m_Expression;
+        VirtualOperation_t         m_Operation;
+        Inputs_t                   m_Inputs;
+        std::vector<std::pair<uint32_t, uint32_t>> m_SensorSlots; // Physical input, slot.
+        std::vector<Edge_t>        m_Dependents;
+        Reading_t                  m_Reading;
+        bool                       m_IsDirty{false};
+    };
+
+public:
+    // Malformed lines are reported and skipped. A missing file simply
+    // defines no virtual sensors.
+    static std::vector<VirtualSensorDefinition_t> LoadDefinitions(const std::string_view& path);
+
+    // Definitions with unknown inputs are reported and dropped, as are
+    // then any definitions depending upon them.
+    VirtualSensorGraph(const size_t& numberOfSensors,
+                       const std::vector<VirtualSensorDefinition_t>& definitions);
+
+    VirtualSensorGraph(const VirtualSensorGraph&) = delete;
+    VirtualSensorGraph& operator=(const VirtualSensorGraph&) = delete;
+
+    size_t Size() const;
+    const std::string& Name(const size_t& virtualSensorNumber) const;
+    const std::string& Expression(const size_t& virtualSensorNumber) const;
+
+    // Virtual sensor n is published as sensor n of this table.
+    const SensorTable& GetSensorTable() const;
+
+    // Feeds the batch's readings to the virtual sensors that depend on
+    // them, and re-evaluates each of those once.
+    void Apply(const ReadingRecord_t* pRecords, const size_t& count);
+
+    void Expire(const SteadyClock_t::time_point& timeNow);
+
+private:
+    static std::vector<VirtualSensor_t> Resolve(const size_t& numberOfSensors,
+                                                const std::vector<VirtualSensorDefinition_t>& definitions);
+
+    // Require m_GraphMutex.
+    void Feed(const Edge_t& edge, const Reading_t& reading);
+    void MarkDirty(const uint32_t& virtualSensorNumber);
+    void Propagate(const SteadyClock_t::time_point& timeNow);
+    static Reading_t Evaluate(VirtualSensor_t& virtualSensor,
+                              const SteadyClock_t::time_point& timeNow);
+
+    std::vector<VirtualSensor_t>                   m_VirtualSensors;
+
+    // Indexed by physical sensor; empty if there are no virtual sensors.
+    std::vector<std::vector<Edge_t>>               m_SensorDependents;
+
+    // Dirty virtual sensors, lowest (i.e. earliest defined) first.
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> m_DirtySensors;
+
+    std::mutex                                     m_GraphMutex;
+    SensorTable                                    m_TheSensorTable;
+    Metrics::Counter_t&                            m_Evaluations;
+};
@@ -0,0 +1,234 @@
+#include "WorkStealingExecutor.h"
+
+namespace
+{
+    // Identifies the pool (and the deque therein) owned by this thread.
+    thread_local const WorkStealingPool*  ts_pCurrentPool = nullptr;
+    thread_local size_t                   ts_CurrentWorkerIndex = 0;
+}
+
+WorkStealingPool::WorkStealingPool(const size_t& numberOfThreads, const std::string& name)
+    : m_Name(name)
+    , m_Workers()
+    , m_NextVictim(0)
+    , m_NextSubmission(0)
+    , m_Pending(0)
+    , m_Sleepers(0)
+    , m_IsStopping(false)
+    , m_SleepMutex()
+    , m_Wakeup()
+    , m_TasksExecuted(Metrics::Counter("workstealing." + name + ".tasks_executed"))
+    , m_TasksStolen(Metrics::Counter("workstealing." + name + ".tasks_stolen"))
+    , m_TasksSubmittedExternally(Metrics::Counter("workstealing." + name + ".tasks_external"))
+{
+    auto count = (numberOfThreads > 0) ? numberOfThreads : 1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Workers.push_back(std::make_unique<Worker_t>());
+    }
+
+    // Only launch the threads once every deque exists, as any of them
+    // may immediately attempt to steal from any other.
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Workers[i]->m_Thread = std::thread(&WorkStealingPool::WorkerThread, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    Stop();
+    Join();
+
+    // Destroy services (and thereby any outstanding handlers they own)
+    // before our deques go away.
+    shutdown();
+    destroy();
+}
+
+WorkStealingPool::executor_type WorkStealingPool::get_executor() noexcept
+{
+    return executor_type(*this);
+}
+
+size_t WorkStealingPool::NumberOfThreads() const
+{
+    return m_Workers.size();
+}
+
+void WorkStealingPool::Stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_IsStopping.store(true, std::memory_order_release);
+    }
+    m_Wakeup.notify_all();
+}
+
+void WorkStealingPool::Join()
+{
+    for (auto& pWorker : m_Workers)
+    {
+        if (pWorker->m_Thread.joinable()
+            && (pWorker->m_Thread.get_id() != std::this_thread::get_id()))
+        {
+            pWorker->m_Thread.join();
+        }
+    }
+}
+
+void WorkStealingPool::Submit(Task_t task)
+{
+    size_t index = 0;
+
+    if (ts_pCurrentPool == this)
+    {
+        // Follow-on work stays on the submitting thread's own deque.
+        index = ts_CurrentWorkerIndex;
+    }
+    else
+    {
+        index = m_NextSubmission.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+        m_TasksSubmittedExternally.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Count it before it becomes visible so that m_Pending never underflows.
+    m_Pending.fetch_add(1, std::memory_order_seq_cst);
+
+    {
+        std::unique_lock<std::mutex> lock(m_Workers[index]->m_Mutex);
+        m_Workers[index]->m_Deque.push_back(std::move(task));
+    }
+
+    if (m_Sleepers.load(std::memory_order_seq_cst) > 0)
+    {
+        // Taking the mutex guarantees that the sleeper either sees our
+        // m_Pending increment or is already waiting for our notification.
+        {
+            std::unique_lock<std::mutex> lock(m_SleepMutex);
+        }
+        m_Wakeup.notify_one();
+    }
+}
+
+bool WorkStealingPool::TryAcquireTask(const size_t& index, Task_t& task)
+{
+    // Own deque first, newest first (LIFO).
+    {
+        auto& worker = *m_Workers[index];
+        std::unique_lock<std::mutex> lock(worker.m_Mutex);
+        if (!worker.m_Deque.empty())
+        {
+            task = std::move(worker.m_Deque.back());
+            worker.m_Deque.pop_back();
+            return true;
+        }
+    }
+
+    // Then steal, oldest first (FIFO), starting from a rotating victim so
+    // that thieves spread out instead of mobbing the same deque. Contended
+    // victims are skipped at first; should any have been, a second pass
+    // waits for their locks, lest work be missed merely for being busy.
+    auto start = m_NextVictim.fetch_add(1, std::memory_order_relaxed);
+    bool isContended = false;
+    for (auto isBlocking : {false, true})
+    {
+        if (isBlocking && !isContended)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < m_Workers.size(); i++)
+        {
+            auto victimIndex = (start + i) % m_Workers.size();
+            if (victimIndex == index)
+            {
+                continue;
+            }
+
+            auto& victim = *m_Workers[victimIndex];
+            std::unique_lock<std::mutex> lock(victim.m_Mutex, std::defer_lock);
+            if (isBlocking)
+            {
+                lock.lock();
+            }
+            else if (!lock.try_lock())
+            {
+                isContended = true;
+                continue;
+            }
+
+            if (!victim.m_Deque.empty())
+            {
+                task = std::move(victim.m_Deque.front());
+                victim.m_Deque.pop_front();
+                m_TasksStolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::WorkerThread(const size_t& index)
+{
+    // To aid debugging by means of strace, ps, valgrind, gdb, and
+    // variants, name our created threads.
+    auto uniqueName = m_Name + "_" + std::to_string(index);
+    Utility::SetThreadName(uniqueName.c_str());
+
+    ts_pCurrentPool = this;
+    ts_CurrentWorkerIndex = index;
+
+    while (true)
+    {
+        Task_t task;
+
+        if (TryAcquireTask(index, task))
+        {
+            m_Pending.fetch_sub(1, std::memory_order_relaxed);
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "[ERROR] : Caught an exception! " << e.what() << "\n";
+            }
+
+            m_TasksExecuted.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+
+        // Drain everything before honouring a stop request.
+        if (m_IsStopping.load(std::memory_order_acquire)
+            && (m_Pending.load(std::memory_order_seq_cst) == 0))
+        {
+            break;
+        }
+
+        // Counted by Submit() but not yet pushed onto its deque; the wait
+        // below would not block, so let the submitter finish instead.
+        if (m_Pending.load(std::memory_order_seq_cst) > 0)
+        {
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+
+        m_Sleepers.fetch_add(1, std::memory_order_seq_cst);
+        m_Wakeup.wait(lock, [this]()
+        {
+            return (m_Pending.load(std::memory_order_seq_cst) > 0)
+                || m_IsStopping.load(std::memory_order_acquire);
+        });
+        m_Sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    ts_pCurrentPool = nullptr;
+}
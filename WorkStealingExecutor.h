@@ -0,0 +1,143 @@
+/***********************************************************************
+* @file      WorkStealingExecutor.h
+*
+* Work-stealing thread pool, with an executor compatible with ASIO's
+* (standard) executor model, for CPU-heavy follow-on work such as
+* analytics, compression and export.
+*
+* @brief    Every pool thread owns a double-ended queue. Work submitted
+*           from within a pool thread is pushed onto (and popped from)
+*           the back of that thread's own deque, i.e. LIFO, which keeps
+*           follow-on work hot in that core's cache. Work submitted from
+*           outside of the pool (e.g. from the dispatcher threads) is
+*           distributed round-robin. An idle thread steals from the front
+*           of a victim's deque, i.e. the oldest and usually the largest
+*           chunk of work, before finally going to sleep.
+*
+*           Contrast this with io_context, where all threads contend on
+*           one shared FIFO queue and where a burst of follow-on work from
+*           one hot sensor is interleaved behind everyone else's.
+*
+*           Usage is as with any other ASIO executor:
+*
+*           @code
+*           asio::post(Common::g_AnalyticsWorkPool->get_executor(),
+*                      [](){ ... });
+*           @endcode
+*
+* @note     The deques are guarded by one mutex each, which the owner
+*           practically never contends on. A Chase-Lev lock-free deque
+*           would shave a few more nanoseconds per task but the task
+*           granularity here (analytics, compression) does not warrant it.
+*
+* @warning  Do NOT perform blocking socket I/O on this pool; that is what
+*           the dispatcher io_context is for.
+*
+* @author  Nuertey Odzeyem
+*
+* @date    October 17, 2026
+***********************************************************************/
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include "CommonDefinitions.h"
+#include "Metrics.h"
+#include "MoveOnlyTask.h"
+
+class WorkStealingPool : public asio::execution_context
+{
+    // ASIO handlers are move-only.
+    using Task_t = Utility::MoveOnlyTask_t;
+
+    struct alignas(64) Worker_t
+    {
+        std::mutex            m_Mutex;
+        std::deque<Task_t>    m_Deque;
+        std::thread           m_Thread;
+    };
+
+public:
+    class executor_type
+    {
+    public:
+        explicit executor_type(WorkStealingPool& pool) noexcept
+            : m_pPool(&pool)
+        {
+        }
+
+        WorkStealingPool& query(asio::execution::context_t) const noexcept
+        {
+            return *m_pPool;
+        }
+
+        static constexpr asio::execution::blocking_t query(asio::execution::blocking_t) noexcept
+        {
+            return asio::execution::blocking.never;
+        }
+
+        executor_type require(asio::execution::blocking_t::never_t) const noexcept
+        {
+            return *this;
+        }
+
+        template <typename Function>
+        void execute(Function&& function) const
+        {
+            m_pPool->Submit(Task_t(std::forward<Function>(function)));
+        }
+
+        bool operator==(const executor_type& other) const noexcept
+        {
+            return m_pPool == other.m_pPool;
+        }
+
+        bool operator!=(const executor_type& other) const noexcept
+        {
+            return m_pPool != other.m_pPool;
+        }
+
+    private:
+        WorkStealingPool*  m_pPool;
+    };
+
+    WorkStealingPool(const size_t& numberOfThreads, const std::string& name);
+    virtual ~WorkStealingPool();
+
+    executor_type get_executor() noexcept;
+
+    // Completes ALL submitted work before the pool threads exit, in
+    // keeping with how we shut the dispatcher io_context down.
+    void Stop();
+    void Join();
+
+    size_t NumberOfThreads() const;
+
+protected:
+    void Submit(Task_t task);
+    void WorkerThread(const size_t& index);
+    bool TryAcquireTask(const size_t& index, Task_t& task);
+
+private:
+    std::string                               m_Name;
+    std::vector<std::unique_ptr<Worker_t>>    m_Workers;
+    std::atomic<size_t>                       m_NextVictim;
+    std::atomic<size_t>                       m_NextSubmission;
+
+    // Sleeping protocol: m_Pending counts queued tasks; idle threads wait
+    // on m_Wakeup under m_SleepMutex until it is non-zero.
+    alignas(64) std::atomic<size_t>           m_Pending;
+    std::atomic<size_t>                       m_Sleepers;
+    std::atomic<bool>                         m_IsStopping;
+    std::mutex                                m_SleepMutex;
+    std::condition_variable                   m_Wakeup;
+
+    Metrics::Counter_t&                       m_TasksExecuted;
+    Metrics::Counter_t&                       m_TasksStolen;
+    Metrics::Counter_t&                       m_TasksSubmittedExternally;
+};